@@ -0,0 +1,198 @@
+// per kernel micro benchmarks, no file I/O, directory walking or JSON inside the timed loops
+//
+// geobin_kernel_benchmarks [--benchmark_filter=<regex>] [any other google benchmark flag]
+// set GEOBIN_BENCHMARK_FILE=<path to a .geobin next to its .geometa> to add benchmarks over real rows
+//
+// names are <kernel>/<encode|decode>/<input>/data_type_size:<n>/lod:<n>, throughput is reported as bytes_per_second
+
+#include <benchmark/benchmark.h>
+
+#include "../src/classes/common_stats.hpp"
+#include "../src/classes/codec_pipeline.hpp"
+#include "../src/classes/frequency_analyzer.hpp"
+#include "../src/functions/file_functions.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_SEED 0x67656f62696eull
+#define BENCHMARK_ROWS 16
+
+
+// lod n rows are 1 + 2^(6 + n) samples long, the same formula CommonStats uses
+static uint64_t Get_Samples_Per_Row(const int& lod_number) {
+    return 1 + (1ull << (6 + lod_number));
+}
+
+static void Store_Sample(std::vector<char>& row_vec, const size_t& sample_index, const uint64_t& value, const int& data_type_size) {
+    std::memcpy(&row_vec[sample_index * data_type_size], &value, data_type_size);
+}
+
+// random walk, the shape of height data
+static std::vector<char> Make_Terrain_Rows(const int& data_type_size, const uint64_t& samples_per_row) {
+    std::mt19937_64 generator(BENCHMARK_SEED);
+    std::uniform_int_distribution<int> step_distribution(-3, 3);
+    std::vector<char> rows_vec(BENCHMARK_ROWS * samples_per_row * data_type_size);
+    int64_t height = 1 << (4 * data_type_size - 1);
+    for(size_t sample = 0; sample < BENCHMARK_ROWS * samples_per_row; sample++) {
+        height += step_distribution(generator);
+        Store_Sample(rows_vec, sample, static_cast<uint64_t>(height), data_type_size);
+    }
+    return rows_vec;
+}
+
+// long constant runs, the shape of masks and categorical layers
+static std::vector<char> Make_Mask_Rows(const int& data_type_size, const uint64_t& samples_per_row) {
+    std::mt19937_64 generator(BENCHMARK_SEED);
+    std::geometric_distribution<int> run_distribution(1.0 / 40.0);
+    std::vector<char> rows_vec(BENCHMARK_ROWS * samples_per_row * data_type_size);
+    uint64_t value = 0;
+    int run_left = 0;
+    for(size_t sample = 0; sample < BENCHMARK_ROWS * samples_per_row; sample++) {
+        if(run_left-- <= 0) {
+            value = generator() % 8;
+            run_left = run_distribution(generator);
+        }
+        Store_Sample(rows_vec, sample, value, data_type_size);
+    }
+    return rows_vec;
+}
+
+// incompressible, the worst case for every kernel
+static std::vector<char> Make_Noise_Rows(const int& data_type_size, const uint64_t& samples_per_row) {
+    std::mt19937_64 generator(BENCHMARK_SEED);
+    std::vector<char> rows_vec(BENCHMARK_ROWS * samples_per_row * data_type_size);
+    for(auto& byte : rows_vec) {
+        byte = static_cast<char>(generator());
+    }
+    return rows_vec;
+}
+
+static std::vector<std::vector<char>> Split_Rows(const std::vector<char>& rows_vec, const uint64_t& bytes_per_row) {
+    std::vector<std::vector<char>> row_vecs;
+    for(size_t offset = 0; offset + bytes_per_row <= rows_vec.size(); offset += bytes_per_row) {
+        row_vecs.emplace_back(rows_vec.begin() + offset, rows_vec.begin() + offset + bytes_per_row);
+    }
+    return row_vecs;
+}
+
+// cycles through the rows so a single cached row does not flatter the numbers
+static void Run_Stage_Benchmark(benchmark::State& state, const std::string& stage_name, const bool& decode,
+                                const std::vector<std::vector<char>>& row_vecs, const StageContext& context) {
+    std::unique_ptr<CodecStage> stage = CodecRegistry::Get_Instance().Create_Stage(stage_name);
+
+    std::vector<std::vector<char>> encoded_vecs(row_vecs.size());
+    for(size_t row = 0; row < row_vecs.size(); row++) {
+        stage->Encode(row_vecs[row], encoded_vecs[row], context);
+    }
+    const std::vector<std::vector<char>>& input_vecs = decode ? encoded_vecs : row_vecs;
+
+    std::vector<char> output_vec;
+    size_t row = 0;
+    for(auto _ : state) {
+        if(decode) {
+            stage->Decode(input_vecs[row], output_vec, context);
+        } else {
+            stage->Encode(input_vecs[row], output_vec, context);
+        }
+        benchmark::DoNotOptimize(output_vec.data());
+        benchmark::ClobberMemory();
+        row = (row + 1 == input_vecs.size()) ? 0 : row + 1;
+    }
+    // throughput is always measured against the original row size
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(row_vecs[0].size()));
+}
+
+static void Register_Stage_Benchmarks(const std::string& input_name, const std::vector<std::vector<char>>& row_vecs, const StageContext& context, const int& lod_number) {
+    const CodecRegistry& registry = CodecRegistry::Get_Instance();
+    std::vector<std::string> stage_names_vec = registry.Get_Stage_Names(Stage_Kind::transform);
+    for(const auto& name : registry.Get_Stage_Names(Stage_Kind::backend)) {
+        stage_names_vec.push_back(name);
+    }
+
+    for(const auto& stage_name : stage_names_vec) {
+        for(const bool decode : {false, true}) {
+            const std::string benchmark_name = stage_name + (decode ? "/decode/" : "/encode/") + input_name +
+                                               "/data_type_size:" + std::to_string(context.data_type_size) + "/lod:" + std::to_string(lod_number);
+            benchmark::RegisterBenchmark(benchmark_name.c_str(), [stage_name, decode, row_vecs, context](benchmark::State& state) {
+                Run_Stage_Benchmark(state, stage_name, decode, row_vecs, context);
+            });
+        }
+    }
+}
+
+// counting one row and emitting its table, what the frequency analyzer does per row
+static void Run_Histogram_Benchmark(benchmark::State& state, const std::vector<std::vector<char>>& row_vecs, const int& data_type_size) {
+    SymbolHistogram histogram(static_cast<uint8_t>(data_type_size));
+    FrequencyTable table;
+    size_t row = 0;
+    for(auto _ : state) {
+        histogram.Count(row_vecs[row].data(), row_vecs[row].size());
+        histogram.Move_Into_Table(table);
+        benchmark::DoNotOptimize(table.symbol_count_vec.data());
+        row = (row + 1 == row_vecs.size()) ? 0 : row + 1;
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(row_vecs[0].size()));
+}
+
+static void Register_Histogram_Benchmarks(const std::string& input_name, const std::vector<std::vector<char>>& row_vecs, const int& data_type_size, const int& lod_number) {
+    const std::string benchmark_name = std::string{"histogram/count/"} + input_name + "/data_type_size:" + std::to_string(data_type_size) + "/lod:" + std::to_string(lod_number);
+    benchmark::RegisterBenchmark(benchmark_name.c_str(), [row_vecs, data_type_size](benchmark::State& state) {
+        Run_Histogram_Benchmark(state, row_vecs, data_type_size);
+    });
+}
+
+static void Register_Synthetic_Benchmarks() {
+    for(const int data_type_size : {1, 2, 4}) {
+        for(const int lod_number : {0, 2, 4}) {
+            StageContext context;
+            context.data_type_size = data_type_size;
+            context.samples_per_row = Get_Samples_Per_Row(lod_number);
+            const uint64_t bytes_per_row = context.samples_per_row * data_type_size;
+
+            Register_Stage_Benchmarks("terrain", Split_Rows(Make_Terrain_Rows(data_type_size, context.samples_per_row), bytes_per_row), context, lod_number);
+            Register_Stage_Benchmarks("mask", Split_Rows(Make_Mask_Rows(data_type_size, context.samples_per_row), bytes_per_row), context, lod_number);
+            Register_Stage_Benchmarks("noise", Split_Rows(Make_Noise_Rows(data_type_size, context.samples_per_row), bytes_per_row), context, lod_number);
+            Register_Histogram_Benchmarks("terrain", Split_Rows(Make_Terrain_Rows(data_type_size, context.samples_per_row), bytes_per_row), data_type_size, lod_number);
+            Register_Histogram_Benchmarks("noise", Split_Rows(Make_Noise_Rows(data_type_size, context.samples_per_row), bytes_per_row), data_type_size, lod_number);
+        }
+    }
+}
+
+// the geometa next to the file gives the sample width, the lod in the name gives the row length
+static void Register_File_Benchmarks(const std::filesystem::path& file_path) {
+    CommonStats stats;
+    stats.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(file_path.parent_path()));
+
+    StageContext context;
+    context.data_type_size = stats.Get_Data_Type_Size();
+    context.samples_per_row = Get_Side_Resolution(file_path.stem(), stats);
+    const uint64_t bytes_per_row = context.samples_per_row * context.data_type_size;
+
+    std::ifstream input_file(file_path, std::ios::binary);
+    std::vector<char> rows_vec(std::min<uint64_t>(Get_File_Size_Bytes(file_path), BENCHMARK_ROWS * bytes_per_row));
+    input_file.read(rows_vec.data(), rows_vec.size());
+
+    Register_Stage_Benchmarks(file_path.stem().string(), Split_Rows(rows_vec, bytes_per_row), context, Get_Lod_Number(file_path.stem()));
+    Register_Histogram_Benchmarks(file_path.stem().string(), Split_Rows(rows_vec, bytes_per_row), context.data_type_size, Get_Lod_Number(file_path.stem()));
+}
+
+int main(int argc, char** argv) {
+    Register_Synthetic_Benchmarks();
+    if(const char* file_path = std::getenv("GEOBIN_BENCHMARK_FILE")) {
+        Register_File_Benchmarks(std::filesystem::path{file_path});
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
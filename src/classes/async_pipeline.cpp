@@ -0,0 +1,206 @@
+#include "async_pipeline.hpp"
+#include "codec_selector.hpp"
+#include "spsc_queue.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define END_OF_ROWS std::numeric_limits<uint64_t>::max()
+
+struct RowTicket {
+    uint64_t row = 0;
+    uint32_t slot = 0;
+};
+
+
+//Constructors
+AsyncPipelineCodec::AsyncPipelineCodec(const std::string& spec, const int& number_of_workers, const int& ring_rows)
+    : spec(spec), number_of_workers(std::max(1, number_of_workers)) {
+    // every worker needs a few rows in flight or the reader stalls on the ring
+    row_slots_vec.resize(std::max(ring_rows, 4 * this->number_of_workers));
+    for(int worker = 0; worker < this->number_of_workers; worker++) {
+        worker_pipelines_vec.push_back(std::make_unique<CodecPipeline>(spec));
+    }
+}
+
+void AsyncPipelineCodec::Run_Stages(const std::function<bool(std::vector<char>&)>& read_row,
+                                    const std::function<void(CodecPipeline&, RowSlot&)>& code_row,
+                                    const std::function<void(const std::vector<char>&)>& write_row) {
+    const size_t ring_rows = row_slots_vec.size();
+
+    // rows are dealt round robin, so worker w only ever sees rows w, w + W, ... and the writer
+    // restores order by reading the workers' output queues round robin as well
+    SpscQueue<uint32_t> free_slot_queue(ring_rows);
+    std::vector<std::unique_ptr<SpscQueue<RowTicket>>> to_worker_queues_vec;
+    std::vector<std::unique_ptr<SpscQueue<RowTicket>>> to_writer_queues_vec;
+    for(int worker = 0; worker < number_of_workers; worker++) {
+        to_worker_queues_vec.push_back(std::make_unique<SpscQueue<RowTicket>>(ring_rows + 1));
+        to_writer_queues_vec.push_back(std::make_unique<SpscQueue<RowTicket>>(ring_rows + 1));
+    }
+    // the calling thread is the only producer of free slots, both before and during the run
+    for(uint32_t slot = 0; slot < ring_rows; slot++) {
+        free_slot_queue.Push(slot);
+    }
+
+    std::thread reader_thread([&]() {
+        uint64_t row = 0;
+        while(true) {
+            const uint32_t slot = free_slot_queue.Pop();
+            if(!read_row(row_slots_vec[slot].input_vec)) {
+                break;
+            }
+            to_worker_queues_vec[row % number_of_workers]->Push(RowTicket{row, slot});
+            row++;
+        }
+        for(auto& queue : to_worker_queues_vec) {
+            queue->Push(RowTicket{END_OF_ROWS, 0});
+        }
+    });
+
+    std::vector<std::thread> worker_threads_vec;
+    for(int worker = 0; worker < number_of_workers; worker++) {
+        worker_threads_vec.emplace_back([&, worker]() {
+            SpscQueue<RowTicket>& input_queue = *to_worker_queues_vec[worker];
+            SpscQueue<RowTicket>& output_queue = *to_writer_queues_vec[worker];
+            while(true) {
+                const RowTicket ticket = input_queue.Pop();
+                if(ticket.row != END_OF_ROWS) {
+                    code_row(*worker_pipelines_vec[worker], row_slots_vec[ticket.slot]);
+                }
+                output_queue.Push(ticket);
+                if(ticket.row == END_OF_ROWS) {
+                    break;
+                }
+            }
+        });
+    }
+
+    for(uint64_t row = 0; ; row++) {
+        const RowTicket ticket = to_writer_queues_vec[row % number_of_workers]->Pop();
+        if(ticket.row == END_OF_ROWS) {
+            break;
+        }
+        write_row(row_slots_vec[ticket.slot].output_vec);
+        free_slot_queue.Push(ticket.slot);
+    }
+
+    reader_thread.join();
+    for(auto& worker_thread : worker_threads_vec) {
+        worker_thread.join();
+    }
+}
+
+void AsyncPipelineCodec::Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row) {
+    const int data_type_size = std::max(1, this->Get_Data_Type_Size());
+    const uint64_t bytes_per_row = samples_per_row * data_type_size;
+    const uint64_t number_of_rows = (Get_File_Size_Bytes(input_path) + bytes_per_row - 1) / bytes_per_row;
+
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    AutoFileHeader header;
+    header.data_type_size = static_cast<uint8_t>(data_type_size);
+    header.samples_per_row = samples_per_row;
+    header.number_of_rows = number_of_rows;
+    header.rows_per_block = std::max<uint64_t>(number_of_rows, 1);
+    header.spec_vec.push_back(spec);
+    header.block_spec_index_vec.push_back(0);
+    Write_Auto_File_Header(output_file, header);
+
+    for(auto& pipeline : worker_pipelines_vec) {
+        pipeline->Set_Data_Type_Size(data_type_size);
+        pipeline->Set_Samples_Per_Row(samples_per_row);
+    }
+
+    Run_Stages(
+        [&input_file, bytes_per_row](std::vector<char>& row_vec) {
+            row_vec.resize(bytes_per_row);
+            input_file.read(row_vec.data(), bytes_per_row);
+            row_vec.resize(input_file.gcount());
+            return !row_vec.empty();
+        },
+        [this](CodecPipeline& pipeline, RowSlot& row_slot) {
+            pipeline.Set_Binary_Data_Vec(row_slot.input_vec);
+            // workers record straight into this object, each lands in its own stats shard
+            this->Compute_Time_Encoded([&pipeline](){
+                pipeline.Encode_Row();
+            });
+            const std::vector<char>& encoded_vec = pipeline.Get_Encoded_Data_Vec();
+            const uint32_t encoded_size = static_cast<uint32_t>(encoded_vec.size());
+            row_slot.output_vec.resize(sizeof(uint32_t) + encoded_size);
+            std::memcpy(row_slot.output_vec.data(), &encoded_size, sizeof(uint32_t));
+            std::memcpy(row_slot.output_vec.data() + sizeof(uint32_t), encoded_vec.data(), encoded_size);
+        },
+        [&output_file](const std::vector<char>& output_vec) {
+            output_file.write(output_vec.data(), output_vec.size());
+        });
+}
+
+void AsyncPipelineCodec::Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path) {
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    const AutoFileHeader header = Read_Auto_File_Header(input_file);
+    if(header.spec_vec.size() != 1 || header.spec_vec[0] != spec) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" was not encoded with "} + spec);
+    }
+    for(auto& pipeline : worker_pipelines_vec) {
+        pipeline->Set_Data_Type_Size(header.data_type_size);
+        pipeline->Set_Samples_Per_Row(header.samples_per_row);
+    }
+
+    uint64_t rows_read = 0;
+    Run_Stages(
+        [&input_file, &rows_read, &header](std::vector<char>& encoded_vec) {
+            if(rows_read == header.number_of_rows) {
+                return false;
+            }
+            uint32_t encoded_size = 0;
+            input_file.read(reinterpret_cast<char*>(&encoded_size), sizeof(uint32_t));
+            encoded_vec.resize(encoded_size);
+            input_file.read(encoded_vec.data(), encoded_size);
+            rows_read++;
+            return static_cast<bool>(input_file);
+        },
+        [this](CodecPipeline& pipeline, RowSlot& row_slot) {
+            pipeline.Set_Encoded_Data_Vec(row_slot.input_vec);
+            this->Compute_Time_Decoded([&pipeline](){
+                pipeline.Decode_Row();
+            });
+            row_slot.output_vec.assign(pipeline.Get_Decoded_Data_Vec().begin(), pipeline.Get_Decoded_Data_Vec().end());
+        },
+        [&output_file](const std::vector<char>& output_vec) {
+            output_file.write(output_vec.data(), output_vec.size());
+        });
+}
+
+//getters
+const char* AsyncPipelineCodec::Get_Compression_Type() const {return spec.c_str();}
+
+const int AsyncPipelineCodec::Get_Number_Of_Workers() const {return number_of_workers;}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include "codec_pipeline.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#define DEFAULT_ASYNC_RING_ROWS 256
+
+// three stage pipeline: a read-ahead thread fills a ring of row buffers, worker threads code rows,
+// and the calling thread writes them back in order. stages talk through bounded lock-free SPSC queues.
+// output uses the auto file layout (single spec, single block), so either driver can read it
+class AsyncPipelineCodec : public CommonStats {
+    public:
+        // Constructors
+        AsyncPipelineCodec(const std::string& spec, const int& number_of_workers, const int& ring_rows = DEFAULT_ASYNC_RING_ROWS);
+
+        void Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row);
+        void Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path);
+
+        //getters
+        const char* Get_Compression_Type() const;
+        const int Get_Number_Of_Workers() const;
+
+    private:
+        struct RowSlot {
+            std::vector<char> input_vec;
+            std::vector<char> output_vec;
+        };
+
+        // read_row runs on the reader thread and returns false at end of input,
+        // code_row runs on the workers, write_row on the calling thread in row order
+        void Run_Stages(const std::function<bool(std::vector<char>&)>& read_row,
+                        const std::function<void(CodecPipeline&, RowSlot&)>& code_row,
+                        const std::function<void(const std::vector<char>&)>& write_row);
+
+        std::string spec;
+        int number_of_workers = 1;
+        std::vector<RowSlot> row_slots_vec;
+        // one pipeline per worker, stages keep scratch state between rows
+        std::vector<std::unique_ptr<CodecPipeline>> worker_pipelines_vec;
+};
@@ -0,0 +1,203 @@
+#include "codec_pipeline.hpp"
+#include "codec_stages.hpp"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+
+// CodecRegistry
+
+CodecRegistry::CodecRegistry() {
+    Register_Default_Codec_Stages(*this);
+}
+
+CodecRegistry& CodecRegistry::Get_Instance() {
+    // function local static so every translation unit sees a fully registered table
+    static CodecRegistry registry;
+    return registry;
+}
+
+void CodecRegistry::Register_Stage(const std::string& name, const Stage_Kind& kind, Stage_Factory factory) {
+    if(stage_map.find(name) == stage_map.end()) {
+        stage_names_vec.push_back(name);
+    }
+    stage_map[name] = Registered_Stage{kind, std::move(factory)};
+}
+
+std::unique_ptr<CodecStage> CodecRegistry::Create_Stage(const std::string& name) const {
+    const auto it = stage_map.find(name);
+    if(it == stage_map.end()) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: Unknown codec stage '"} + name + std::string{"'."});
+    }
+    return it->second.factory();
+}
+
+const bool CodecRegistry::Has_Stage(const std::string& name) const {
+    return stage_map.find(name) != stage_map.end();
+}
+
+const Stage_Kind CodecRegistry::Get_Stage_Kind(const std::string& name) const {
+    const auto it = stage_map.find(name);
+    if(it == stage_map.end()) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: Unknown codec stage '"} + name + std::string{"'."});
+    }
+    return it->second.kind;
+}
+
+const std::vector<std::string> CodecRegistry::Get_Stage_Names(const Stage_Kind& kind) const {
+    std::vector<std::string> names_vec;
+    for(const auto& name : stage_names_vec) {
+        if(stage_map.at(name).kind == kind) {
+            names_vec.push_back(name);
+        }
+    }
+    return names_vec;
+}
+
+const std::vector<std::string> Split_Pipeline_Spec(const std::string& spec) {
+    std::vector<std::string> stage_names_vec;
+    std::stringstream spec_stream(spec);
+    std::string stage_name;
+    while(std::getline(spec_stream, stage_name, '|')) {
+        if(!stage_name.empty()) {
+            stage_names_vec.push_back(stage_name);
+        }
+    }
+    return stage_names_vec;
+}
+
+
+// CodecPipeline
+
+//Constructors
+CodecPipeline::CodecPipeline(const std::string& spec) : spec(spec) {
+    const CodecRegistry& registry = CodecRegistry::Get_Instance();
+    for(const auto& stage_name : Split_Pipeline_Spec(spec)) {
+        stages_vec.push_back(registry.Create_Stage(stage_name));
+    }
+    if(stages_vec.empty()) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: Pipeline spec '"} + spec + std::string{"' has no stages."});
+    }
+}
+
+// stages hold per-row scratch state, so a copy builds its own set from the spec
+CodecPipeline::CodecPipeline(const CodecPipeline& other) : CommonStats(other), spec(other.spec), context(other.context) {
+    const CodecRegistry& registry = CodecRegistry::Get_Instance();
+    for(const auto& stage_name : Split_Pipeline_Spec(spec)) {
+        stages_vec.push_back(registry.Create_Stage(stage_name));
+    }
+}
+
+void CodecPipeline::Read_File(const std::filesystem::path& file_path, const int& number_of_bytes_to_read, const int& row) {
+    std::ifstream input_file(file_path, std::ios::binary);
+#ifdef DEBUG
+    if(!input_file) {
+        ERROR_MSG_AND_EXIT("Error: Unable to open the file.");
+    }
+#endif
+
+    binary_data_vec.resize(number_of_bytes_to_read);
+    std::streampos start_position = static_cast<std::streampos>(number_of_bytes_to_read) * row;
+    input_file.seekg(start_position);
+    input_file.read(binary_data_vec.data(), number_of_bytes_to_read);
+#ifdef DEBUG
+    if (input_file.fail() && !input_file.eof()) {
+        ERROR_MSG_AND_EXIT("Error: Unable to read from the file.");
+    }
+#endif
+}
+
+void CodecPipeline::Update_Context() {
+    context.data_type_size = this->Get_Data_Type_Size() > 0 ? this->Get_Data_Type_Size() : 1;
+    if(context.samples_per_row == 0) {
+        context.samples_per_row = binary_data_vec.size() / context.data_type_size;
+    }
+}
+
+void CodecPipeline::Encode_Row() {
+    Update_Context();
+
+    const std::vector<char>* input_vec = &binary_data_vec;
+    for(size_t stage = 0; stage < stages_vec.size(); stage++) {
+        std::vector<char>& output_vec = (stage + 1 == stages_vec.size()) ? encoded_data_vec : scratch_vecs[stage % 2];
+        stages_vec[stage]->Encode(*input_vec, output_vec, context);
+        input_vec = &output_vec;
+    }
+}
+
+void CodecPipeline::Decode_Row() {
+    Update_Context();
+
+    const std::vector<char>* input_vec = &encoded_data_vec;
+    for(size_t stage = stages_vec.size(); stage-- > 0; ) {
+        std::vector<char>& output_vec = (stage == 0) ? decoded_data_vec : scratch_vecs[stage % 2];
+        stages_vec[stage]->Decode(*input_vec, output_vec, context);
+        input_vec = &output_vec;
+    }
+}
+
+void CodecPipeline::Write_Compressed_File(const std::filesystem::path& file_path) const {
+    try {
+        std::ofstream encoded_output_file(file_path, std::ios::binary | std::ios::app);
+        encoded_output_file.write(encoded_data_vec.data(), encoded_data_vec.size());
+    } catch (const std::exception& e) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to create the pipeline encoded file.\n"} + std::string{"ERROR CODE: "} + std::string{e.what()});
+    }
+}
+
+void CodecPipeline::Write_Decompressed_File(const std::filesystem::path& file_path) const {
+    try {
+        std::ofstream decoded_output_file(file_path, std::ios::binary | std::ios::app);
+        decoded_output_file.write(decoded_data_vec.data(), decoded_data_vec.size());
+    } catch (const std::exception& e) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to create the pipeline decoded file.\n"} + std::string{"ERROR CODE: "} + std::string{e.what()});
+    }
+}
+
+//getters
+const char* CodecPipeline::Get_Compression_Type() const {return spec.c_str();}
+
+const std::string& CodecPipeline::Get_Spec() const {return spec;}
+
+const std::vector<char>& CodecPipeline::Get_Encoded_Data_Vec() const {return encoded_data_vec;}
+
+const std::vector<char>& CodecPipeline::Get_Decoded_Data_Vec() const {return decoded_data_vec;}
+
+const std::vector<char>& CodecPipeline::Get_Binary_Data_Vec() const {return binary_data_vec;}
+
+//setters
+void CodecPipeline::Set_Samples_Per_Row(const uint64_t& samples_per_row) {
+    context.samples_per_row = samples_per_row;
+}
+
+void CodecPipeline::Set_Binary_Data_Vec(const std::vector<char>& binary_data_vec) {
+    this->binary_data_vec.assign(binary_data_vec.begin(), binary_data_vec.end());
+}
+
+void CodecPipeline::Set_Encoded_Data_Vec(const std::vector<char>& encoded_data_vec) {
+    this->encoded_data_vec.assign(encoded_data_vec.begin(), encoded_data_vec.end());
+}
+
+void CodecPipeline::Set_Binary_Data(const char* data_ptr, const size_t& number_of_bytes) {
+    binary_data_vec.assign(data_ptr, data_ptr + number_of_bytes);
+}
+
+void CodecPipeline::Set_Encoded_Data(const char* data_ptr, const size_t& number_of_bytes) {
+    encoded_data_vec.assign(data_ptr, data_ptr + number_of_bytes);
+}
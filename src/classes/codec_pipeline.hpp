@@ -0,0 +1,105 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include <array>
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <filesystem>
+
+// shape of the data a stage is working on, filled in by the pipeline before every row
+struct StageContext {
+    int data_type_size = 1;
+    uint64_t samples_per_row = 0;
+};
+
+enum class Stage_Kind {
+    transform,   // length preserving, reorders or remaps bytes (delta, xor, mtf, ...)
+    backend      // actually changes the size of the data (rlr, entropy, lz4, ...)
+};
+
+// a single encode/decode step of a pipeline
+// Encode/Decode must fully overwrite output_vec, they are handed reused buffers
+class CodecStage {
+    public:
+        virtual ~CodecStage() = default;
+
+        virtual void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) = 0;
+        virtual void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) = 0;
+};
+
+// runtime table of every stage that can show up in a pipeline spec string
+class CodecRegistry {
+    public:
+        using Stage_Factory = std::function<std::unique_ptr<CodecStage>()>;
+
+        static CodecRegistry& Get_Instance();
+
+        void Register_Stage(const std::string& name, const Stage_Kind& kind, Stage_Factory factory);
+        std::unique_ptr<CodecStage> Create_Stage(const std::string& name) const;
+
+        //getters
+        const bool Has_Stage(const std::string& name) const;
+        const Stage_Kind Get_Stage_Kind(const std::string& name) const;
+        const std::vector<std::string> Get_Stage_Names(const Stage_Kind& kind) const;
+
+    private:
+        CodecRegistry();
+
+        struct Registered_Stage {
+            Stage_Kind kind;
+            Stage_Factory factory;
+        };
+
+        std::unordered_map<std::string, Registered_Stage> stage_map;
+        // keeps registration order so listings are stable
+        std::vector<std::string> stage_names_vec;
+};
+
+// splits "delta|shuffle|rlr1|rans" into {"delta", "shuffle", "rlr1", "rans"}
+const std::vector<std::string> Split_Pipeline_Spec(const std::string& spec);
+
+// chain of stages built from a spec string, each stage streams into the next through reused buffers
+class CodecPipeline : public CommonStats {
+    public:
+        // Constructors
+        explicit CodecPipeline(const std::string& spec);
+        CodecPipeline(const CodecPipeline& other);
+
+        void Read_File(const std::filesystem::path& file_path, const int& number_of_bytes_to_read, const int& row);
+
+        void Encode_Row();
+        void Decode_Row();
+
+        void Write_Compressed_File(const std::filesystem::path& file_path) const;
+        void Write_Decompressed_File(const std::filesystem::path& file_path) const;
+
+        //getters
+        const char* Get_Compression_Type() const;
+        const std::string& Get_Spec() const;
+        const std::vector<char>& Get_Encoded_Data_Vec() const;
+        const std::vector<char>& Get_Decoded_Data_Vec() const;
+        const std::vector<char>& Get_Binary_Data_Vec() const;
+
+        //setters
+        void Set_Samples_Per_Row(const uint64_t& samples_per_row);
+        void Set_Binary_Data_Vec(const std::vector<char>& binary_data_vec);
+        void Set_Encoded_Data_Vec(const std::vector<char>& encoded_data_vec);
+        void Set_Binary_Data(const char* data_ptr, const size_t& number_of_bytes);
+        void Set_Encoded_Data(const char* data_ptr, const size_t& number_of_bytes);
+
+    private:
+        void Update_Context();
+
+        std::string spec;
+        std::vector<std::unique_ptr<CodecStage>> stages_vec;
+        StageContext context;
+
+        std::vector<char> binary_data_vec;
+        std::vector<char> encoded_data_vec;
+        std::vector<char> decoded_data_vec;
+        // ping-pong buffers between stages, kept around so rows don't reallocate
+        std::array<std::vector<char>, 2> scratch_vecs;
+};
@@ -0,0 +1,258 @@
+#include "codec_selector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define AUTO_FILE_MAGIC "GBAC"
+#define AUTO_FILE_VERSION 1
+
+
+template <typename T>
+static void Write_Value(std::ostream& output_stream, const T& value) {
+    output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T Read_Value(std::istream& input_stream) {
+    T value{};
+    input_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+void Write_Auto_File_Header(std::ostream& output_stream, const AutoFileHeader& header) {
+    output_stream.write(AUTO_FILE_MAGIC, 4);
+    Write_Value<uint8_t>(output_stream, AUTO_FILE_VERSION);
+    Write_Value<uint8_t>(output_stream, header.data_type_size);
+    Write_Value<uint64_t>(output_stream, header.samples_per_row);
+    Write_Value<uint64_t>(output_stream, header.number_of_rows);
+    Write_Value<uint64_t>(output_stream, header.rows_per_block);
+
+    Write_Value<uint16_t>(output_stream, static_cast<uint16_t>(header.spec_vec.size()));
+    for(const auto& spec : header.spec_vec) {
+        Write_Value<uint16_t>(output_stream, static_cast<uint16_t>(spec.size()));
+        output_stream.write(spec.data(), spec.size());
+    }
+
+    Write_Value<uint64_t>(output_stream, static_cast<uint64_t>(header.block_spec_index_vec.size()));
+    for(const auto& spec_index : header.block_spec_index_vec) {
+        Write_Value<uint16_t>(output_stream, spec_index);
+    }
+}
+
+const AutoFileHeader Read_Auto_File_Header(std::istream& input_stream) {
+    char magic[4] = {0};
+    input_stream.read(magic, 4);
+    if(std::memcmp(magic, AUTO_FILE_MAGIC, 4) != 0 || Read_Value<uint8_t>(input_stream) != AUTO_FILE_VERSION) {
+        ERROR_MSG_AND_EXIT("ERROR: Not an auto encoded geobin file.");
+    }
+
+    AutoFileHeader header;
+    header.data_type_size = Read_Value<uint8_t>(input_stream);
+    header.samples_per_row = Read_Value<uint64_t>(input_stream);
+    header.number_of_rows = Read_Value<uint64_t>(input_stream);
+    header.rows_per_block = Read_Value<uint64_t>(input_stream);
+
+    const uint16_t number_of_specs = Read_Value<uint16_t>(input_stream);
+    for(uint16_t i = 0; i < number_of_specs; i++) {
+        std::string spec(Read_Value<uint16_t>(input_stream), '\0');
+        input_stream.read(spec.data(), spec.size());
+        header.spec_vec.push_back(spec);
+    }
+
+    const uint64_t number_of_blocks = Read_Value<uint64_t>(input_stream);
+    for(uint64_t i = 0; i < number_of_blocks; i++) {
+        header.block_spec_index_vec.push_back(Read_Value<uint16_t>(input_stream));
+    }
+
+    if(!input_stream) {
+        ERROR_MSG_AND_EXIT("ERROR: Truncated auto encoded geobin header.");
+    }
+    return header;
+}
+
+
+//Constructors
+CodecSelector::CodecSelector(const std::vector<std::string>& candidate_spec_vec, const SelectionObjective& objective) : objective(objective) {
+    for(const auto& spec : candidate_spec_vec) {
+        pipelines_vec.push_back(std::make_unique<CodecPipeline>(spec));
+    }
+    if(pipelines_vec.empty()) {
+        ERROR_MSG_AND_EXIT("ERROR: CodecSelector needs at least one candidate pipeline.");
+    }
+}
+
+const std::vector<std::string> CodecSelector::Get_Default_Candidate_Specs() {
+    return {
+        "raw",
+        "rlr1",
+        "delta|rlr1",
+        "xor|rlr1",
+        "mtf|rlr1",
+        "rans",
+        "delta|shuffle|rans",
+        "delta|shuffle|huffman",
+        "xor|shuffle|rans",
+        "delta|shuffle|rlr1|rans",
+        "bwt|mtf|rans",
+        "float",
+    };
+}
+
+// rows are spread evenly over [first_row, first_row + number_of_rows) so the sample sees the whole block
+const std::vector<std::vector<char>> CodecSelector::Read_Sample_Rows(const std::filesystem::path& file_path, const uint64_t& bytes_per_row, const uint64_t& first_row, const uint64_t& number_of_rows) const {
+    std::vector<std::vector<char>> sample_rows_vec;
+    const uint64_t rows_to_sample = std::min<uint64_t>(number_of_sample_rows, number_of_rows);
+
+    std::ifstream input_file(file_path, std::ios::binary);
+    if(!input_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + file_path.string());
+    }
+
+    for(uint64_t i = 0; i < rows_to_sample; i++) {
+        const uint64_t row = first_row + (i * number_of_rows) / rows_to_sample;
+        std::vector<char> row_vec(bytes_per_row);
+        input_file.seekg(static_cast<std::streamoff>(row * bytes_per_row));
+        input_file.read(row_vec.data(), bytes_per_row);
+        sample_rows_vec.push_back(std::move(row_vec));
+    }
+    return sample_rows_vec;
+}
+
+const PipelineEstimate CodecSelector::Estimate_Pipeline(CodecPipeline& pipeline, const std::vector<std::vector<char>>& sample_rows_vec) {
+    PipelineEstimate estimate;
+    estimate.spec = pipeline.Get_Spec();
+    estimate.round_trip_ok = true;
+
+    uint64_t original_bytes = 0;
+    uint64_t encoded_bytes = 0;
+    std::chrono::steady_clock::duration encode_duration{0};
+    std::chrono::steady_clock::duration decode_duration{0};
+
+    // one untimed row first so buffer growth and cold stage tables stay out of the estimate
+    pipeline.Set_Binary_Data_Vec(sample_rows_vec.front());
+    pipeline.Encode_Row();
+    pipeline.Decode_Row();
+
+    for(const auto& row_vec : sample_rows_vec) {
+        pipeline.Set_Binary_Data_Vec(row_vec);
+
+        auto start = std::chrono::steady_clock::now();
+        pipeline.Encode_Row();
+        auto end = std::chrono::steady_clock::now();
+        encode_duration += end - start;
+
+        start = std::chrono::steady_clock::now();
+        pipeline.Decode_Row();
+        end = std::chrono::steady_clock::now();
+        decode_duration += end - start;
+
+        original_bytes += row_vec.size();
+        encoded_bytes += pipeline.Get_Encoded_Data_Vec().size();
+        estimate.round_trip_ok = estimate.round_trip_ok && (pipeline.Get_Decoded_Data_Vec() == row_vec);
+    }
+
+    const double encode_seconds = std::max(std::chrono::duration<double>(encode_duration).count(), 1e-9);
+    const double decode_seconds = std::max(std::chrono::duration<double>(decode_duration).count(), 1e-9);
+    estimate.compression_ratio = static_cast<double>(encoded_bytes) / static_cast<double>(std::max<uint64_t>(original_bytes, 1));
+    estimate.encode_megabytes_per_second = static_cast<double>(original_bytes) / encode_seconds / 1e6;
+    estimate.decode_megabytes_per_second = static_cast<double>(original_bytes) / decode_seconds / 1e6;
+    return estimate;
+}
+
+// the float stage is only a candidate for 4 byte samples or layers whose geometa says they are floats, it codes
+// narrower samples as plain integers where the other candidates already do as well
+static const bool Uses_Float_Stage(const std::string& spec) {
+    const std::vector<std::string> stage_names_vec = Split_Pipeline_Spec(spec);
+    return std::find(stage_names_vec.begin(), stage_names_vec.end(), std::string{"float"}) != stage_names_vec.end();
+}
+
+// smallest ratio among the candidates that meet the throughput floors, fastest decoder if none do
+const PipelineEstimate CodecSelector::Select_Pipeline(const std::vector<std::vector<char>>& sample_rows_vec, const uint64_t& samples_per_row) {
+    if(sample_rows_vec.empty()) {
+        ERROR_MSG_AND_EXIT("ERROR: No sample rows to select a pipeline from.");
+    }
+
+    estimates_vec.clear();
+    for(auto& pipeline : pipelines_vec) {
+        if(Uses_Float_Stage(pipeline->Get_Spec()) && !this->Get_Floating_Point_Samples() && this->Get_Data_Type_Size() != 4) {
+            continue;
+        }
+        pipeline->Set_Data_Type_Size(this->Get_Data_Type_Size());
+        pipeline->Set_Samples_Per_Row(samples_per_row);
+        estimates_vec.push_back(Estimate_Pipeline(*pipeline, sample_rows_vec));
+    }
+
+    const PipelineEstimate* best_estimate = nullptr;
+    const PipelineEstimate* fastest_estimate = nullptr;
+    for(const auto& estimate : estimates_vec) {
+        if(!estimate.round_trip_ok) {
+            continue;
+        }
+        if(fastest_estimate == nullptr || estimate.decode_megabytes_per_second > fastest_estimate->decode_megabytes_per_second) {
+            fastest_estimate = &estimate;
+        }
+        if(estimate.decode_megabytes_per_second < objective.minimum_decode_megabytes_per_second ||
+           estimate.encode_megabytes_per_second < objective.minimum_encode_megabytes_per_second) {
+            continue;
+        }
+        if(best_estimate == nullptr || estimate.compression_ratio < best_estimate->compression_ratio) {
+            best_estimate = &estimate;
+        }
+    }
+
+    if(fastest_estimate == nullptr) {
+        ERROR_MSG_AND_EXIT("ERROR: No candidate pipeline round-tripped the sample rows.");
+    }
+#ifdef DEBUG_MODE
+    for(const auto& estimate : estimates_vec) {
+        PRINT_DEBUG(std::string{"Candidate: "} + estimate.spec + " ratio: " + std::to_string(estimate.compression_ratio) +
+                    " encode MB/s: " + std::to_string(estimate.encode_megabytes_per_second) +
+                    " decode MB/s: " + std::to_string(estimate.decode_megabytes_per_second));
+    }
+#endif
+    return (best_estimate != nullptr) ? *best_estimate : *fastest_estimate;
+}
+
+//getters
+const char* CodecSelector::Get_Compression_Type() const {return compression_type;}
+
+CodecPipeline& CodecSelector::Get_Pipeline(const std::string& spec) {
+    for(auto& pipeline : pipelines_vec) {
+        if(pipeline->Get_Spec() == spec) {
+            return *pipeline;
+        }
+    }
+    pipelines_vec.push_back(std::make_unique<CodecPipeline>(spec));
+    return *pipelines_vec.back();
+}
+
+const std::vector<PipelineEstimate>& CodecSelector::Get_Estimates() const {return estimates_vec;}
+
+const uint64_t CodecSelector::Get_Rows_Per_Block() const {return rows_per_block;}
+
+//setters
+void CodecSelector::Set_Number_Of_Sample_Rows(const int& number_of_sample_rows) {
+    this->number_of_sample_rows = std::max(1, number_of_sample_rows);
+}
+
+void CodecSelector::Set_Rows_Per_Block(const uint64_t& rows_per_block) {
+    this->rows_per_block = rows_per_block;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include "codec_pipeline.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <istream>
+#include <ostream>
+#include <filesystem>
+
+// what "best" means when picking a pipeline, throughput floors are in MB/s (1e6 bytes)
+struct SelectionObjective {
+    double minimum_decode_megabytes_per_second = 0.0;
+    double minimum_encode_megabytes_per_second = 0.0;
+};
+
+struct PipelineEstimate {
+    std::string spec;
+    double compression_ratio = 0.0;   // compressed / original, same as CommonStats
+    double encode_megabytes_per_second = 0.0;
+    double decode_megabytes_per_second = 0.0;
+    bool round_trip_ok = false;
+};
+
+// header at the front of every auto encoded file, records which pipeline each block of rows used
+// layout: "GBAC" | version u8 | data type size u8 | samples per row u64 | number of rows u64 | rows per block u64 |
+//         spec count u16 | (spec length u16, spec bytes)... | number of blocks u64 | block spec index u16...
+// followed by one (encoded size u32, encoded bytes) record per row
+struct AutoFileHeader {
+    uint8_t data_type_size = 0;
+    uint64_t samples_per_row = 0;
+    uint64_t number_of_rows = 0;
+    uint64_t rows_per_block = 0;
+    std::vector<std::string> spec_vec;
+    std::vector<uint16_t> block_spec_index_vec;
+};
+
+void Write_Auto_File_Header(std::ostream& output_stream, const AutoFileHeader& header);
+const AutoFileHeader Read_Auto_File_Header(std::istream& input_stream);
+
+// compresses a handful of sample rows with every candidate pipeline and keeps the one that best fits the objective
+class CodecSelector : public CommonStats {
+    public:
+        // Constructors
+        CodecSelector(const std::vector<std::string>& candidate_spec_vec, const SelectionObjective& objective);
+
+        const std::vector<std::vector<char>> Read_Sample_Rows(const std::filesystem::path& file_path, const uint64_t& bytes_per_row, const uint64_t& first_row, const uint64_t& number_of_rows) const;
+        const PipelineEstimate Select_Pipeline(const std::vector<std::vector<char>>& sample_rows_vec, const uint64_t& samples_per_row);
+
+        static const std::vector<std::string> Get_Default_Candidate_Specs();
+
+        //getters
+        const char* Get_Compression_Type() const;
+        CodecPipeline& Get_Pipeline(const std::string& spec);
+        const std::vector<PipelineEstimate>& Get_Estimates() const;
+        const uint64_t Get_Rows_Per_Block() const;
+
+        //setters
+        void Set_Number_Of_Sample_Rows(const int& number_of_sample_rows);
+        void Set_Rows_Per_Block(const uint64_t& rows_per_block);
+
+    private:
+        const PipelineEstimate Estimate_Pipeline(CodecPipeline& pipeline, const std::vector<std::vector<char>>& sample_rows_vec);
+
+        std::vector<std::unique_ptr<CodecPipeline>> pipelines_vec;
+        std::vector<PipelineEstimate> estimates_vec;
+        SelectionObjective objective;
+        int number_of_sample_rows = 8;
+        // 0 means one choice for the whole file
+        uint64_t rows_per_block = 0;
+        const char* compression_type = "auto";
+};
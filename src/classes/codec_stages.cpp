@@ -0,0 +1,1046 @@
+#include "codec_stages.hpp"
+#include "frequency_analyzer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+#ifdef GEOBIN_HAVE_LZ4
+#include <lz4.h>
+#endif
+#ifdef GEOBIN_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define RANS_PROBABILITY_BITS 12
+#define RANS_PROBABILITY_SCALE (1u << RANS_PROBABILITY_BITS)
+#define RANS_LOWER_BOUND (1u << 23)
+#define HUFFMAN_MAX_CODE_BITS 11
+#define HUFFMAN_STREAMS 4
+#define HUFFMAN_INTERLEAVED_MINIMUM_BYTES 64
+// multi symbol entries are only built for rows at least this many times longer than the decode table
+#define HUFFMAN_MULTI_SYMBOL_MINIMUM_RATIO 2
+// code lengths as 128 bytes of nibbles, as (symbol, length) pairs, or the one symbol every byte is
+#define HUFFMAN_LAYOUT_DENSE 0
+#define HUFFMAN_LAYOUT_SPARSE 1
+#define HUFFMAN_LAYOUT_SINGLE_SYMBOL 2
+// set in the length of an entropy coded row whose table and stream came out no smaller than the row itself
+#define ENTROPY_RAW_ROW_FLAG 0x80000000u
+// residuals per bit packed block, one bit of every residual in a block fills a 32 bit plane
+#define FLOAT_BLOCK_SAMPLES 32
+
+
+void Register_Default_Codec_Stages(CodecRegistry& registry) {
+    registry.Register_Stage("delta", Stage_Kind::transform, [](){ return std::make_unique<DeltaStage>(); });
+    registry.Register_Stage("xor", Stage_Kind::transform, [](){ return std::make_unique<XorStage>(); });
+    registry.Register_Stage("mtf", Stage_Kind::transform, [](){ return std::make_unique<MoveToFrontStage>(); });
+    registry.Register_Stage("bwt", Stage_Kind::transform, [](){ return std::make_unique<BurrowsWheelerStage>(); });
+    registry.Register_Stage("shuffle", Stage_Kind::transform, [](){ return std::make_unique<ByteShuffleStage>(); });
+
+    registry.Register_Stage("raw", Stage_Kind::backend, [](){ return std::make_unique<RawStage>(); });
+    registry.Register_Stage("rlr1", Stage_Kind::backend, [](){ return std::make_unique<RunLengthStage>(1); });
+    registry.Register_Stage("rlr2", Stage_Kind::backend, [](){ return std::make_unique<RunLengthStage>(2); });
+    registry.Register_Stage("rlr3", Stage_Kind::backend, [](){ return std::make_unique<RunLengthStage>(3); });
+    registry.Register_Stage("rlr4", Stage_Kind::backend, [](){ return std::make_unique<RunLengthStage>(4); });
+    registry.Register_Stage("rans", Stage_Kind::backend, [](){ return std::make_unique<RansStage>(); });
+    registry.Register_Stage("huffman", Stage_Kind::backend, [](){ return std::make_unique<HuffmanStage>(); });
+    registry.Register_Stage("cm", Stage_Kind::backend, [](){ return std::make_unique<ContextModelStage>(false); });
+    registry.Register_Stage("cmx", Stage_Kind::backend, [](){ return std::make_unique<ContextModelStage>(true); });
+    registry.Register_Stage("float", Stage_Kind::backend, [](){ return std::make_unique<FloatStage>(); });
+#ifdef GEOBIN_HAVE_LZ4
+    registry.Register_Stage("lz4", Stage_Kind::backend, [](){ return std::make_unique<LZ4Stage>(); });
+#endif
+#ifdef GEOBIN_HAVE_ZSTD
+    registry.Register_Stage("zstd", Stage_Kind::backend, [](){ return std::make_unique<ZstdStage>(); });
+#endif
+}
+
+// samples are little endian, same assumption the rest of the codecs make
+static inline uint64_t Load_Sample(const char* sample_ptr, const int& sample_width) {
+    uint64_t sample = 0;
+    std::memcpy(&sample, sample_ptr, sample_width);
+    return sample;
+}
+
+static inline void Store_Sample(char* sample_ptr, const uint64_t& sample, const int& sample_width) {
+    std::memcpy(sample_ptr, &sample, sample_width);
+}
+
+static inline uint64_t Get_Sample_Mask(const int& sample_width) {
+    return (sample_width >= 8) ? ~uint64_t{0} : ((uint64_t{1} << (8 * sample_width)) - 1);
+}
+
+static inline void Copy_Tail_Bytes(const std::vector<char>& input_vec, std::vector<char>& output_vec, const size_t& tail_start) {
+    std::copy(input_vec.begin() + tail_start, input_vec.end(), output_vec.begin() + tail_start);
+}
+
+// short rows can't pay for their own table, they go out as the flagged length and the row as is
+static void Store_Raw_Row_If_Not_Smaller(const std::vector<char>& input_vec, std::vector<char>& output_vec) {
+    if(output_vec.size() < sizeof(uint32_t) + input_vec.size()) {
+        return;
+    }
+    output_vec.resize(sizeof(uint32_t) + input_vec.size());
+    Store_Sample(&output_vec[0], static_cast<uint32_t>(input_vec.size()) | ENTROPY_RAW_ROW_FLAG, sizeof(uint32_t));
+    std::copy(input_vec.begin(), input_vec.end(), output_vec.begin() + sizeof(uint32_t));
+}
+
+static bool Load_Raw_Row(const std::vector<char>& input_vec, std::vector<char>& output_vec) {
+    const uint32_t length = static_cast<uint32_t>(Load_Sample(&input_vec[0], sizeof(uint32_t)));
+    if((length & ENTROPY_RAW_ROW_FLAG) == 0) {
+        return false;
+    }
+    if(input_vec.size() != sizeof(uint32_t) + (length & ~ENTROPY_RAW_ROW_FLAG)) {
+        ERROR_MSG_AND_EXIT("ERROR: raw entropy coded row is corrupt.");
+    }
+    output_vec.assign(input_vec.begin() + sizeof(uint32_t), input_vec.end());
+    return true;
+}
+
+
+// RawStage
+
+void RawStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    output_vec.assign(input_vec.begin(), input_vec.end());
+}
+
+void RawStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    output_vec.assign(input_vec.begin(), input_vec.end());
+}
+
+
+// DeltaStage
+
+void DeltaStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    output_vec.resize(input_vec.size());
+
+    uint64_t previous_sample = 0;
+    for(size_t i = 0; i < number_of_samples; i++) {
+        const uint64_t current_sample = Load_Sample(&input_vec[i * sample_width], sample_width);
+        Store_Sample(&output_vec[i * sample_width], current_sample - previous_sample, sample_width);
+        previous_sample = current_sample;
+    }
+    Copy_Tail_Bytes(input_vec, output_vec, number_of_samples * sample_width);
+}
+
+void DeltaStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const uint64_t sample_mask = Get_Sample_Mask(sample_width);
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    output_vec.resize(input_vec.size());
+
+    uint64_t previous_sample = 0;
+    for(size_t i = 0; i < number_of_samples; i++) {
+        previous_sample = (Load_Sample(&input_vec[i * sample_width], sample_width) + previous_sample) & sample_mask;
+        Store_Sample(&output_vec[i * sample_width], previous_sample, sample_width);
+    }
+    Copy_Tail_Bytes(input_vec, output_vec, number_of_samples * sample_width);
+}
+
+
+// XorStage
+
+void XorStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    output_vec.resize(input_vec.size());
+
+    uint64_t previous_sample = 0;
+    for(size_t i = 0; i < number_of_samples; i++) {
+        const uint64_t current_sample = Load_Sample(&input_vec[i * sample_width], sample_width);
+        Store_Sample(&output_vec[i * sample_width], current_sample ^ previous_sample, sample_width);
+        previous_sample = current_sample;
+    }
+    Copy_Tail_Bytes(input_vec, output_vec, number_of_samples * sample_width);
+}
+
+void XorStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    output_vec.resize(input_vec.size());
+
+    uint64_t previous_sample = 0;
+    for(size_t i = 0; i < number_of_samples; i++) {
+        previous_sample ^= Load_Sample(&input_vec[i * sample_width], sample_width);
+        Store_Sample(&output_vec[i * sample_width], previous_sample, sample_width);
+    }
+    Copy_Tail_Bytes(input_vec, output_vec, number_of_samples * sample_width);
+}
+
+
+// MoveToFrontStage
+
+void MoveToFrontStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    std::array<uint8_t, 256> alphabet_arr;
+    std::iota(alphabet_arr.begin(), alphabet_arr.end(), 0);
+    output_vec.resize(input_vec.size());
+
+    for(size_t i = 0; i < input_vec.size(); i++) {
+        const uint8_t byte = static_cast<uint8_t>(input_vec[i]);
+        uint8_t index = 0;
+        while(alphabet_arr[index] != byte) {
+            index++;
+        }
+        output_vec[i] = static_cast<char>(index);
+        std::memmove(&alphabet_arr[1], &alphabet_arr[0], index);
+        alphabet_arr[0] = byte;
+    }
+}
+
+void MoveToFrontStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    std::array<uint8_t, 256> alphabet_arr;
+    std::iota(alphabet_arr.begin(), alphabet_arr.end(), 0);
+    output_vec.resize(input_vec.size());
+
+    for(size_t i = 0; i < input_vec.size(); i++) {
+        const uint8_t index = static_cast<uint8_t>(input_vec[i]);
+        const uint8_t byte = alphabet_arr[index];
+        output_vec[i] = static_cast<char>(byte);
+        std::memmove(&alphabet_arr[1], &alphabet_arr[0], index);
+        alphabet_arr[0] = byte;
+    }
+}
+
+
+// BurrowsWheelerStage
+
+void BurrowsWheelerStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const size_t length = input_vec.size();
+    output_vec.resize(sizeof(uint32_t) + length);
+    if(length == 0) {
+        Store_Sample(output_vec.data(), 0, sizeof(uint32_t));
+        return;
+    }
+
+    // sort the cyclic rotations by prefix doubling, rank_vec holds the rank of the first 2k bytes of each rotation
+    suffix_vec.resize(length);
+    rank_vec.resize(length);
+    temp_rank_vec.resize(length);
+    for(size_t i = 0; i < length; i++) {
+        suffix_vec[i] = static_cast<uint32_t>(i);
+        rank_vec[i] = static_cast<uint8_t>(input_vec[i]);
+    }
+
+    for(size_t k = 1; ; k <<= 1) {
+        auto rotation_less = [this, k, length](const uint32_t& a, const uint32_t& b) {
+            if(rank_vec[a] != rank_vec[b]) {
+                return rank_vec[a] < rank_vec[b];
+            }
+            return rank_vec[(a + k) % length] < rank_vec[(b + k) % length];
+        };
+        std::sort(suffix_vec.begin(), suffix_vec.end(), rotation_less);
+
+        temp_rank_vec[suffix_vec[0]] = 0;
+        for(size_t i = 1; i < length; i++) {
+            temp_rank_vec[suffix_vec[i]] = temp_rank_vec[suffix_vec[i - 1]] + (rotation_less(suffix_vec[i - 1], suffix_vec[i]) ? 1 : 0);
+        }
+        rank_vec.swap(temp_rank_vec);
+
+        // periodic rows never get unique ranks, stop once the compared prefix covers the whole rotation
+        if(rank_vec[suffix_vec[length - 1]] == length - 1 || k >= length) {
+            break;
+        }
+    }
+
+    uint32_t primary_index = 0;
+    for(size_t i = 0; i < length; i++) {
+        if(suffix_vec[i] == 0) {
+            primary_index = static_cast<uint32_t>(i);
+        }
+        output_vec[sizeof(uint32_t) + i] = input_vec[(suffix_vec[i] + length - 1) % length];
+    }
+    Store_Sample(output_vec.data(), primary_index, sizeof(uint32_t));
+}
+
+void BurrowsWheelerStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const size_t length = input_vec.size() - sizeof(uint32_t);
+    const uint32_t primary_index = static_cast<uint32_t>(Load_Sample(input_vec.data(), sizeof(uint32_t)));
+    const char* last_column_ptr = input_vec.data() + sizeof(uint32_t);
+    output_vec.resize(length);
+    if(length == 0) {
+        return;
+    }
+
+    std::array<uint32_t, 256> first_column_start_arr = {0};
+    for(size_t i = 0; i < length; i++) {
+        first_column_start_arr[static_cast<uint8_t>(last_column_ptr[i])]++;
+    }
+    uint32_t running_total = 0;
+    for(auto& start : first_column_start_arr) {
+        const uint32_t count = start;
+        start = running_total;
+        running_total += count;
+    }
+
+    // rank_vec doubles as the last-to-first mapping
+    rank_vec.resize(length);
+    for(size_t i = 0; i < length; i++) {
+        rank_vec[i] = first_column_start_arr[static_cast<uint8_t>(last_column_ptr[i])]++;
+    }
+
+    uint32_t row = primary_index;
+    for(size_t i = length; i-- > 0; ) {
+        output_vec[i] = last_column_ptr[row];
+        row = rank_vec[row];
+    }
+}
+
+
+// ByteShuffleStage
+
+void ByteShuffleStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    output_vec.resize(input_vec.size());
+
+    for(int byte = 0; byte < sample_width; byte++) {
+        char* plane_ptr = &output_vec[byte * number_of_samples];
+        for(size_t i = 0; i < number_of_samples; i++) {
+            plane_ptr[i] = input_vec[i * sample_width + byte];
+        }
+    }
+    Copy_Tail_Bytes(input_vec, output_vec, number_of_samples * sample_width);
+}
+
+void ByteShuffleStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    output_vec.resize(input_vec.size());
+
+    for(int byte = 0; byte < sample_width; byte++) {
+        const char* plane_ptr = &input_vec[byte * number_of_samples];
+        for(size_t i = 0; i < number_of_samples; i++) {
+            output_vec[i * sample_width + byte] = plane_ptr[i];
+        }
+    }
+    Copy_Tail_Bytes(input_vec, output_vec, number_of_samples * sample_width);
+}
+
+
+// RunLengthStage
+
+RunLengthStage::RunLengthStage(const int& run_length_bytes) : run_length_bytes(run_length_bytes) {}
+
+void RunLengthStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    // rows that are not a whole number of samples fall back to single bytes
+    const int sample_width = (input_vec.size() % context.data_type_size == 0) ? context.data_type_size : 1;
+    const uint64_t max_run_length = Get_Sample_Mask(run_length_bytes);
+    const size_t record_size = run_length_bytes + sample_width;
+
+    output_vec.clear();
+    output_vec.push_back(static_cast<char>(sample_width));
+    if(input_vec.empty()) {
+        return;
+    }
+
+    auto write_run = [&](const size_t& sample_index, const uint64_t& run_length) {
+        const size_t write_index = output_vec.size();
+        output_vec.resize(write_index + record_size);
+        Store_Sample(&output_vec[write_index], run_length, run_length_bytes);
+        std::memcpy(&output_vec[write_index + run_length_bytes], &input_vec[sample_index], sample_width);
+    };
+
+    size_t current_index = 0;
+    uint64_t run_length = 1;
+    for(size_t i = sample_width; i < input_vec.size(); i += sample_width) {
+        if(run_length < max_run_length && std::memcmp(&input_vec[i], &input_vec[current_index], sample_width) == 0) {
+            run_length++;
+        } else {
+            write_run(current_index, run_length);
+            current_index = i;
+            run_length = 1;
+        }
+    }
+    write_run(current_index, run_length);
+}
+
+void RunLengthStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    output_vec.clear();
+    if(input_vec.empty()) {
+        return;
+    }
+    const int sample_width = static_cast<uint8_t>(input_vec[0]);
+    const size_t record_size = run_length_bytes + sample_width;
+
+    for(size_t i = 1; i + record_size <= input_vec.size(); i += record_size) {
+        const uint64_t run_length = Load_Sample(&input_vec[i], run_length_bytes);
+        const char* sample_ptr = &input_vec[i + run_length_bytes];
+        size_t write_index = output_vec.size();
+        output_vec.resize(write_index + run_length * sample_width);
+        if(sample_width == 1) {
+            std::memset(&output_vec[write_index], *sample_ptr, run_length);
+        } else {
+            for(uint64_t run = 0; run < run_length; run++) {
+                std::memcpy(&output_vec[write_index], sample_ptr, sample_width);
+                write_index += sample_width;
+            }
+        }
+    }
+}
+
+
+// RansStage
+
+void RansStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const uint32_t length = static_cast<uint32_t>(input_vec.size());
+
+    std::array<uint32_t, 256> count_arr = {0};
+    for(const char& byte : input_vec) {
+        count_arr[static_cast<uint8_t>(byte)]++;
+    }
+
+    // scale the counts to RANS_PROBABILITY_SCALE keeping every present symbol at least 1
+    frequency_arr.fill(0);
+    uint32_t frequency_sum = 0;
+    uint16_t number_of_symbols = 0;
+    for(int symbol = 0; symbol < 256; symbol++) {
+        if(count_arr[symbol] != 0) {
+            frequency_arr[symbol] = std::max<uint32_t>(1, static_cast<uint32_t>((static_cast<uint64_t>(count_arr[symbol]) * RANS_PROBABILITY_SCALE) / length));
+            frequency_sum += frequency_arr[symbol];
+            number_of_symbols++;
+        }
+    }
+    while(length != 0 && frequency_sum != RANS_PROBABILITY_SCALE) {
+        const auto largest_it = std::max_element(frequency_arr.begin(), frequency_arr.end());
+        if(frequency_sum > RANS_PROBABILITY_SCALE) {
+            (*largest_it)--;
+            frequency_sum--;
+        } else {
+            (*largest_it)++;
+            frequency_sum++;
+        }
+    }
+
+    uint32_t running_total = 0;
+    for(int symbol = 0; symbol < 256; symbol++) {
+        cumulative_frequency_arr[symbol] = running_total;
+        running_total += frequency_arr[symbol];
+    }
+
+    output_vec.resize(sizeof(uint32_t) + sizeof(uint16_t) + number_of_symbols * 3);
+    Store_Sample(&output_vec[0], length, sizeof(uint32_t));
+    Store_Sample(&output_vec[4], number_of_symbols, sizeof(uint16_t));
+    size_t write_index = 6;
+    for(int symbol = 0; symbol < 256; symbol++) {
+        if(frequency_arr[symbol] != 0) {
+            output_vec[write_index] = static_cast<char>(symbol);
+            Store_Sample(&output_vec[write_index + 1], frequency_arr[symbol], sizeof(uint16_t));
+            write_index += 3;
+        }
+    }
+    if(length == 0) {
+        return;
+    }
+
+    // rANS encodes back to front, every symbol renormalizes out at most two bytes
+    const size_t header_size = output_vec.size();
+    const size_t stream_capacity = 2 * static_cast<size_t>(length) + sizeof(uint32_t);
+    output_vec.resize(header_size + stream_capacity);
+    uint8_t* const stream_end_ptr = reinterpret_cast<uint8_t*>(output_vec.data()) + output_vec.size();
+    uint8_t* stream_ptr = stream_end_ptr;
+
+    uint32_t state = RANS_LOWER_BOUND;
+    for(size_t i = length; i-- > 0; ) {
+        const uint8_t symbol = static_cast<uint8_t>(input_vec[i]);
+        const uint32_t frequency = frequency_arr[symbol];
+        const uint32_t state_max = ((RANS_LOWER_BOUND >> RANS_PROBABILITY_BITS) << 8) * frequency;
+        while(state >= state_max) {
+            *--stream_ptr = static_cast<uint8_t>(state & 0xff);
+            state >>= 8;
+        }
+        state = ((state / frequency) << RANS_PROBABILITY_BITS) + (state % frequency) + cumulative_frequency_arr[symbol];
+    }
+    stream_ptr -= sizeof(uint32_t);
+    Store_Sample(reinterpret_cast<char*>(stream_ptr), state, sizeof(uint32_t));
+
+    const size_t stream_size = stream_end_ptr - stream_ptr;
+    std::memmove(&output_vec[header_size], stream_ptr, stream_size);
+    output_vec.resize(header_size + stream_size);
+    Store_Raw_Row_If_Not_Smaller(input_vec, output_vec);
+}
+
+void RansStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    if(Load_Raw_Row(input_vec, output_vec)) {
+        return;
+    }
+    const uint32_t length = static_cast<uint32_t>(Load_Sample(&input_vec[0], sizeof(uint32_t)));
+    const uint16_t number_of_symbols = static_cast<uint16_t>(Load_Sample(&input_vec[4], sizeof(uint16_t)));
+    output_vec.resize(length);
+    if(length == 0) {
+        return;
+    }
+
+    frequency_arr.fill(0);
+    size_t read_index = 6;
+    for(uint16_t i = 0; i < number_of_symbols; i++) {
+        frequency_arr[static_cast<uint8_t>(input_vec[read_index])] = static_cast<uint32_t>(Load_Sample(&input_vec[read_index + 1], sizeof(uint16_t)));
+        read_index += 3;
+    }
+
+    slot_to_symbol_vec.resize(RANS_PROBABILITY_SCALE);
+    uint32_t running_total = 0;
+    for(int symbol = 0; symbol < 256; symbol++) {
+        cumulative_frequency_arr[symbol] = running_total;
+        std::fill_n(slot_to_symbol_vec.begin() + running_total, frequency_arr[symbol], static_cast<uint8_t>(symbol));
+        running_total += frequency_arr[symbol];
+    }
+
+    const uint8_t* stream_ptr = reinterpret_cast<const uint8_t*>(input_vec.data()) + read_index;
+    uint32_t state = static_cast<uint32_t>(Load_Sample(reinterpret_cast<const char*>(stream_ptr), sizeof(uint32_t)));
+    stream_ptr += sizeof(uint32_t);
+
+    for(uint32_t i = 0; i < length; i++) {
+        const uint32_t slot = state & (RANS_PROBABILITY_SCALE - 1);
+        const uint8_t symbol = slot_to_symbol_vec[slot];
+        output_vec[i] = static_cast<char>(symbol);
+        state = frequency_arr[symbol] * (state >> RANS_PROBABILITY_BITS) + slot - cumulative_frequency_arr[symbol];
+        while(state < RANS_LOWER_BOUND) {
+            state = (state << 8) | *stream_ptr++;
+        }
+    }
+}
+
+
+// HuffmanStage
+
+// two queue huffman over the present symbols. a tree deeper than HUFFMAN_MAX_CODE_BITS is rebuilt from flattened
+// counts until it fits, rare for rows and cheaper than package merge
+static void Build_Huffman_Code_Lengths(const std::array<uint32_t, 256>& count_arr, std::array<uint8_t, 256>& length_arr) {
+    std::array<uint32_t, 256> weight_arr = count_arr;
+    std::array<std::pair<uint32_t, uint16_t>, 256> leaf_arr;
+    std::array<uint64_t, 511> node_weight_arr;
+    std::array<uint16_t, 511> parent_arr;
+    std::array<uint8_t, 511> depth_arr;
+    while(true) {
+        int number_of_leaves = 0;
+        for(int symbol = 0; symbol < 256; symbol++) {
+            if(weight_arr[symbol] != 0) {
+                leaf_arr[number_of_leaves++] = {weight_arr[symbol], static_cast<uint16_t>(symbol)};
+            }
+        }
+        length_arr.fill(0);
+        if(number_of_leaves < 2) {
+            if(number_of_leaves == 1) {
+                length_arr[leaf_arr[0].second] = 1;
+            }
+            return;
+        }
+        std::sort(leaf_arr.begin(), leaf_arr.begin() + number_of_leaves);
+        for(int leaf = 0; leaf < number_of_leaves; leaf++) {
+            node_weight_arr[leaf] = leaf_arr[leaf].first;
+        }
+
+        // internal nodes come out in nondecreasing weight order, so the smallest node is at the front of one of the two queues
+        int leaf_index = 0;
+        int internal_index = number_of_leaves;
+        int next_internal = number_of_leaves;
+        auto take_smallest = [&]() {
+            if(leaf_index < number_of_leaves && (internal_index == next_internal || node_weight_arr[leaf_index] <= node_weight_arr[internal_index])) {
+                return leaf_index++;
+            }
+            return internal_index++;
+        };
+        for(int merge = 0; merge < number_of_leaves - 1; merge++) {
+            const int first = take_smallest();
+            const int second = take_smallest();
+            node_weight_arr[next_internal] = node_weight_arr[first] + node_weight_arr[second];
+            parent_arr[first] = static_cast<uint16_t>(next_internal);
+            parent_arr[second] = static_cast<uint16_t>(next_internal);
+            next_internal++;
+        }
+
+        // parents always come after their children, so one backwards pass gives every depth
+        const int root = next_internal - 1;
+        depth_arr[root] = 0;
+        uint8_t max_length = 0;
+        for(int node = root - 1; node >= 0; node--) {
+            depth_arr[node] = depth_arr[parent_arr[node]] + 1;
+        }
+        for(int leaf = 0; leaf < number_of_leaves; leaf++) {
+            length_arr[leaf_arr[leaf].second] = depth_arr[leaf];
+            max_length = std::max(max_length, depth_arr[leaf]);
+        }
+        if(max_length <= HUFFMAN_MAX_CODE_BITS) {
+            return;
+        }
+        for(auto& weight : weight_arr) {
+            if(weight != 0) {
+                weight = (weight >> 1) | 1;
+            }
+        }
+    }
+}
+
+static inline uint64_t Load_Big_Endian_Word(const uint8_t* data) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return __builtin_bswap64(word);
+}
+
+void HuffmanStage::Assign_Canonical_Codes() {
+    std::array<uint32_t, HUFFMAN_MAX_CODE_BITS + 1> length_count_arr = {0};
+    for(const uint8_t& length : length_arr) {
+        length_count_arr[length]++;
+    }
+    length_count_arr[0] = 0;
+    std::array<uint32_t, HUFFMAN_MAX_CODE_BITS + 1> next_code_arr = {0};
+    uint32_t code = 0;
+    for(int length = 1; length <= HUFFMAN_MAX_CODE_BITS; length++) {
+        code = (code + length_count_arr[length - 1]) << 1;
+        next_code_arr[length] = code;
+    }
+    for(int symbol = 0; symbol < 256; symbol++) {
+        if(length_arr[symbol] != 0) {
+            code_arr[symbol] = next_code_arr[length_arr[symbol]]++;
+        }
+    }
+}
+
+void HuffmanStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const uint32_t length = static_cast<uint32_t>(input_vec.size());
+    output_vec.resize(sizeof(uint32_t));
+    Store_Sample(&output_vec[0], length, sizeof(uint32_t));
+    if(length == 0) {
+        return;
+    }
+
+    count_arr.fill(0);
+    Count_Byte_Histogram(reinterpret_cast<const uint8_t*>(input_vec.data()), length, count_arr);
+    const int number_of_symbols = static_cast<int>(std::count_if(count_arr.begin(), count_arr.end(), [](const uint32_t& count){return count != 0;}));
+    if(number_of_symbols == 1) {
+        output_vec.push_back(static_cast<char>(HUFFMAN_LAYOUT_SINGLE_SYMBOL));
+        output_vec.push_back(input_vec[0]);
+        Store_Raw_Row_If_Not_Smaller(input_vec, output_vec);
+        return;
+    }
+
+    Build_Huffman_Code_Lengths(count_arr, length_arr);
+    Assign_Canonical_Codes();
+
+    // whichever length table is smaller, pairs win for the narrow alphabets of masks and high byte planes
+    if(1 + 2 * number_of_symbols < 128) {
+        output_vec.push_back(static_cast<char>(HUFFMAN_LAYOUT_SPARSE));
+        output_vec.push_back(static_cast<char>(number_of_symbols - 1));
+        for(int symbol = 0; symbol < 256; symbol++) {
+            if(length_arr[symbol] != 0) {
+                output_vec.push_back(static_cast<char>(symbol));
+                output_vec.push_back(static_cast<char>(length_arr[symbol]));
+            }
+        }
+    } else {
+        output_vec.push_back(static_cast<char>(HUFFMAN_LAYOUT_DENSE));
+        for(int symbol = 0; symbol < 256; symbol += 2) {
+            output_vec.push_back(static_cast<char>((length_arr[symbol] << 4) | length_arr[symbol + 1]));
+        }
+    }
+
+    const int number_of_streams = (length >= HUFFMAN_INTERLEAVED_MINIMUM_BYTES) ? HUFFMAN_STREAMS : 1;
+    const uint32_t stream_symbols = (length + number_of_streams - 1) / number_of_streams;
+    const size_t stream_size_index = output_vec.size();
+    output_vec.resize(stream_size_index + (number_of_streams - 1) * sizeof(uint32_t));
+
+    const uint8_t* input_data = reinterpret_cast<const uint8_t*>(input_vec.data());
+    for(int stream = 0; stream < number_of_streams; stream++) {
+        const size_t stream_start = output_vec.size();
+        const uint32_t first_symbol = std::min(length, stream * stream_symbols);
+        const uint32_t last_symbol = std::min(length, first_symbol + stream_symbols);
+        // msb first, whole 32 bit words leave the accumulator as soon as they are complete
+        uint64_t bit_buffer = 0;
+        int bit_count = 0;
+        for(uint32_t i = first_symbol; i < last_symbol; i++) {
+            const uint8_t symbol = input_data[i];
+            bit_buffer = (bit_buffer << length_arr[symbol]) | code_arr[symbol];
+            bit_count += length_arr[symbol];
+            if(bit_count >= 32) {
+                bit_count -= 32;
+                const uint32_t word = static_cast<uint32_t>(bit_buffer >> bit_count);
+                output_vec.push_back(static_cast<char>(word >> 24));
+                output_vec.push_back(static_cast<char>(word >> 16));
+                output_vec.push_back(static_cast<char>(word >> 8));
+                output_vec.push_back(static_cast<char>(word));
+            }
+        }
+        while(bit_count >= 8) {
+            bit_count -= 8;
+            output_vec.push_back(static_cast<char>(bit_buffer >> bit_count));
+        }
+        if(bit_count > 0) {
+            output_vec.push_back(static_cast<char>(bit_buffer << (8 - bit_count)));
+        }
+        if(stream + 1 < number_of_streams) {
+            Store_Sample(&output_vec[stream_size_index + stream * sizeof(uint32_t)], output_vec.size() - stream_start, sizeof(uint32_t));
+        }
+    }
+    Store_Raw_Row_If_Not_Smaller(input_vec, output_vec);
+}
+
+void HuffmanStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    if(Load_Raw_Row(input_vec, output_vec)) {
+        return;
+    }
+    const uint32_t length = static_cast<uint32_t>(Load_Sample(&input_vec[0], sizeof(uint32_t)));
+    output_vec.resize(length);
+    if(length == 0) {
+        return;
+    }
+
+    const uint8_t layout = static_cast<uint8_t>(input_vec[4]);
+    size_t read_index = 5;
+    if(layout == HUFFMAN_LAYOUT_SINGLE_SYMBOL) {
+        std::fill(output_vec.begin(), output_vec.end(), input_vec[read_index]);
+        return;
+    }
+    length_arr.fill(0);
+    if(layout == HUFFMAN_LAYOUT_SPARSE) {
+        const int number_of_symbols = static_cast<uint8_t>(input_vec[read_index++]) + 1;
+        for(int i = 0; i < number_of_symbols; i++, read_index += 2) {
+            length_arr[static_cast<uint8_t>(input_vec[read_index])] = static_cast<uint8_t>(input_vec[read_index + 1]);
+        }
+    } else {
+        for(int symbol = 0; symbol < 256; symbol += 2, read_index++) {
+            length_arr[symbol] = static_cast<uint8_t>(input_vec[read_index]) >> 4;
+            length_arr[symbol + 1] = static_cast<uint8_t>(input_vec[read_index]) & 0x0F;
+        }
+    }
+    if(*std::max_element(length_arr.begin(), length_arr.end()) > HUFFMAN_MAX_CODE_BITS) {
+        ERROR_MSG_AND_EXIT("ERROR: Huffman code length table is corrupt.");
+    }
+    Assign_Canonical_Codes();
+
+    // single symbol entries first, the prefix of every table index
+    const int table_bits = *std::max_element(length_arr.begin(), length_arr.end());
+    const uint32_t table_mask = (1u << table_bits) - 1;
+    decode_table_vec.resize(size_t{1} << table_bits);
+    for(int symbol = 0; symbol < 256; symbol++) {
+        if(length_arr[symbol] == 0) {
+            continue;
+        }
+        const uint32_t first_index = code_arr[symbol] << (table_bits - length_arr[symbol]);
+        const uint32_t number_of_indices = 1u << (table_bits - length_arr[symbol]);
+        std::fill_n(decode_table_vec.begin() + first_index, number_of_indices,
+                    DecodeEntry{{static_cast<uint8_t>(symbol), 0, 0}, 1, length_arr[symbol], length_arr[symbol]});
+    }
+    // then append the symbols whose whole code still fits in the index bits after the first one, only worth the pass
+    // when the row is long next to the table. only symbols[1..] and the totals change, so the single symbol part of
+    // every entry can still be read while this runs
+    const uint32_t multi_symbol_entries = (length >= HUFFMAN_MULTI_SYMBOL_MINIMUM_RATIO * decode_table_vec.size()) ? table_mask + 1 : 0;
+    for(uint32_t index = 0; index < multi_symbol_entries; index++) {
+        DecodeEntry& entry = decode_table_vec[index];
+        while(entry.number_of_symbols < 3 && entry.number_of_bits < table_bits) {
+            const DecodeEntry& next_entry = decode_table_vec[(index << entry.number_of_bits) & table_mask];
+            if(next_entry.first_symbol_bits > table_bits - entry.number_of_bits) {
+                break;
+            }
+            entry.symbols[entry.number_of_symbols++] = next_entry.symbols[0];
+            entry.number_of_bits += next_entry.first_symbol_bits;
+        }
+    }
+
+    const int number_of_streams = (length >= HUFFMAN_INTERLEAVED_MINIMUM_BYTES) ? HUFFMAN_STREAMS : 1;
+    const uint32_t stream_symbols = (length + number_of_streams - 1) / number_of_streams;
+    std::array<uint64_t, HUFFMAN_STREAMS> bit_position_arr = {0};
+    std::array<uint32_t, HUFFMAN_STREAMS> output_position_arr = {0};
+    std::array<uint32_t, HUFFMAN_STREAMS> output_end_arr = {0};
+    const size_t streams_start = read_index + (number_of_streams - 1) * sizeof(uint32_t);
+    uint64_t stream_offset = 0;
+    for(int stream = 0; stream < number_of_streams; stream++) {
+        bit_position_arr[stream] = stream_offset * 8;
+        output_position_arr[stream] = std::min(length, stream * stream_symbols);
+        output_end_arr[stream] = std::min(length, output_position_arr[stream] + stream_symbols);
+        if(stream + 1 < number_of_streams) {
+            stream_offset += Load_Sample(&input_vec[read_index + stream * sizeof(uint32_t)], sizeof(uint32_t));
+        }
+    }
+    padded_stream_vec.assign(input_vec.begin() + streams_start, input_vec.end());
+    padded_stream_vec.resize(padded_stream_vec.size() + sizeof(uint64_t), 0);
+
+    const uint8_t* stream_data = padded_stream_vec.data();
+    uint8_t* output_data = reinterpret_cast<uint8_t*>(output_vec.data());
+    const DecodeEntry* decode_table = decode_table_vec.data();
+    const int index_shift = 64 - table_bits;
+    // while every stream still has 3 symbols to go an entry can be copied whole, the streams advance in lock step
+    while(true) {
+        bool room_in_every_stream = true;
+        for(int stream = 0; stream < number_of_streams; stream++) {
+            room_in_every_stream = room_in_every_stream && (output_end_arr[stream] - output_position_arr[stream] >= 3);
+        }
+        if(!room_in_every_stream) {
+            break;
+        }
+        for(int stream = 0; stream < number_of_streams; stream++) {
+            const uint64_t word = Load_Big_Endian_Word(stream_data + (bit_position_arr[stream] >> 3)) << (bit_position_arr[stream] & 7);
+            const DecodeEntry& entry = decode_table[word >> index_shift];
+            std::memcpy(output_data + output_position_arr[stream], entry.symbols, 3);
+            output_position_arr[stream] += entry.number_of_symbols;
+            bit_position_arr[stream] += entry.number_of_bits;
+        }
+    }
+    for(int stream = 0; stream < number_of_streams; stream++) {
+        while(output_position_arr[stream] < output_end_arr[stream]) {
+            const uint64_t word = Load_Big_Endian_Word(stream_data + (bit_position_arr[stream] >> 3)) << (bit_position_arr[stream] & 7);
+            const DecodeEntry& entry = decode_table[word >> index_shift];
+            output_data[output_position_arr[stream]++] = entry.symbols[0];
+            bit_position_arr[stream] += entry.first_symbol_bits;
+        }
+    }
+}
+
+
+// ContextModelStage
+ContextModelStage::ContextModelStage(const bool& mixing) : model(mixing) {}
+
+void ContextModelStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    const uint32_t length = static_cast<uint32_t>(input_vec.size());
+    output_vec.resize(sizeof(uint32_t));
+    Store_Sample(&output_vec[0], length, sizeof(uint32_t));
+    output_vec.insert(output_vec.end(), input_vec.begin() + number_of_samples * sample_width, input_vec.end());
+
+    model.Reset(static_cast<uint8_t>(sample_width), std::min<uint64_t>(context.samples_per_row, number_of_samples));
+    model.Encode_Samples(input_vec.data(), number_of_samples, output_vec);
+}
+
+void ContextModelStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = context.data_type_size;
+    const uint32_t length = static_cast<uint32_t>(Load_Sample(&input_vec[0], sizeof(uint32_t)));
+    const size_t number_of_samples = length / sample_width;
+    const size_t tail_bytes = length - number_of_samples * sample_width;
+    output_vec.resize(length);
+    std::copy_n(input_vec.begin() + sizeof(uint32_t), tail_bytes, output_vec.begin() + number_of_samples * sample_width);
+
+    const size_t stream_start = sizeof(uint32_t) + tail_bytes;
+    model.Reset(static_cast<uint8_t>(sample_width), std::min<uint64_t>(context.samples_per_row, number_of_samples));
+    model.Decode_Samples(input_vec.data() + stream_start, input_vec.size() - stream_start, number_of_samples, output_vec.data());
+}
+
+
+// FloatStage
+
+// flips the sign bit of positive floats and every bit of negative ones, the integers then sort like the floats
+static inline uint32_t Float_Bits_To_Ordered(const uint32_t& bits) {
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static inline uint32_t Ordered_To_Float_Bits(const uint32_t& ordered) {
+    return (ordered & 0x80000000u) ? (ordered & 0x7FFFFFFFu) : ~ordered;
+}
+
+// bit i of a plane belongs to sample i of the block. testing against a constant per lane mask instead of
+// shifting by the lane index keeps the plane loops to compares and ands, which vectorise without variable shifts
+static constexpr std::array<uint32_t, FLOAT_BLOCK_SAMPLES> Get_Float_Lane_Bits() {
+    std::array<uint32_t, FLOAT_BLOCK_SAMPLES> lane_bits_arr{};
+    for(int i = 0; i < FLOAT_BLOCK_SAMPLES; i++) {
+        lane_bits_arr[i] = uint32_t{1} << i;
+    }
+    return lane_bits_arr;
+}
+static constexpr std::array<uint32_t, FLOAT_BLOCK_SAMPLES> float_lane_bits_arr = Get_Float_Lane_Bits();
+
+// d = sample - upper sample is delta coded along the row, which is the Lorenzo predictor left + upper - upper left
+void FloatStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    // any other sample size is coded byte by byte
+    const int sample_width = (context.data_type_size == 2 || context.data_type_size == 4) ? context.data_type_size : 1;
+    const size_t number_of_samples = input_vec.size() / sample_width;
+    const size_t tail_bytes = input_vec.size() - number_of_samples * sample_width;
+    const size_t samples_per_row = (context.samples_per_row == 0) ? number_of_samples : std::min<size_t>(context.samples_per_row, number_of_samples);
+    const uint32_t sample_mask = static_cast<uint32_t>(Get_Sample_Mask(sample_width));
+    const int sign_shift = 8 * sample_width - 1;
+
+    sample_vec.resize(number_of_samples);
+    for(size_t i = 0; i < number_of_samples; i++) {
+        const uint32_t sample = static_cast<uint32_t>(Load_Sample(&input_vec[i * sample_width], sample_width));
+        sample_vec[i] = (sample_width == 4) ? Float_Bits_To_Ordered(sample) : sample;
+    }
+    residual_vec.assign((number_of_samples + FLOAT_BLOCK_SAMPLES - 1) / FLOAT_BLOCK_SAMPLES * FLOAT_BLOCK_SAMPLES, 0);
+    for(size_t row_start = 0; row_start < number_of_samples; row_start += samples_per_row) {
+        const size_t row_end = std::min(row_start + samples_per_row, number_of_samples);
+        uint32_t previous_difference = 0;
+        for(size_t i = row_start; i < row_end; i++) {
+            const uint32_t difference = sample_vec[i] - ((i >= samples_per_row) ? sample_vec[i - samples_per_row] : 0);
+            const uint32_t residual = (difference - previous_difference) & sample_mask;
+            residual_vec[i] = ((residual << 1) ^ (0u - ((residual >> sign_shift) & 1))) & sample_mask;
+            previous_difference = difference;
+        }
+    }
+
+    output_vec.resize(sizeof(uint32_t) + tail_bytes + residual_vec.size() / FLOAT_BLOCK_SAMPLES * (1 + 32 * sizeof(uint32_t)));
+    Store_Sample(output_vec.data(), input_vec.size(), sizeof(uint32_t));
+    std::copy_n(input_vec.begin() + number_of_samples * sample_width, tail_bytes, output_vec.begin() + sizeof(uint32_t));
+    size_t position = sizeof(uint32_t) + tail_bytes;
+    for(size_t block_start = 0; block_start < residual_vec.size(); block_start += FLOAT_BLOCK_SAMPLES) {
+        const uint32_t* block = &residual_vec[block_start];
+        uint32_t block_bits = 0;
+        for(int i = 0; i < FLOAT_BLOCK_SAMPLES; i++) {
+            block_bits |= block[i];
+        }
+        const int bit_width = (block_bits == 0) ? 0 : 32 - __builtin_clz(block_bits);
+        output_vec[position++] = static_cast<char>(bit_width);
+        const size_t block_samples = std::min<size_t>(FLOAT_BLOCK_SAMPLES, number_of_samples - block_start);
+        if(block_samples < FLOAT_BLOCK_SAMPLES) {
+            // a short last block would pay for 32 lanes per plane, its residuals are packed bit_width bits apiece instead
+            uint64_t bit_buffer = 0;
+            int buffered_bits = 0;
+            for(size_t i = 0; i < block_samples; i++) {
+                bit_buffer |= uint64_t{block[i]} << buffered_bits;
+                buffered_bits += bit_width;
+                for(; buffered_bits >= 8; buffered_bits -= 8, bit_buffer >>= 8) {
+                    output_vec[position++] = static_cast<char>(bit_buffer);
+                }
+            }
+            if(buffered_bits > 0) {
+                output_vec[position++] = static_cast<char>(bit_buffer);
+            }
+            continue;
+        }
+        for(int bit = 0; bit < bit_width; bit++) {
+            const uint32_t bit_value = uint32_t{1} << bit;
+            uint32_t plane = 0;
+            for(int i = 0; i < FLOAT_BLOCK_SAMPLES; i++) {
+                plane |= float_lane_bits_arr[i] & (0u - static_cast<uint32_t>((block[i] & bit_value) != 0));
+            }
+            Store_Sample(&output_vec[position], plane, sizeof(uint32_t));
+            position += sizeof(uint32_t);
+        }
+    }
+    output_vec.resize(position);
+}
+
+void FloatStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int sample_width = (context.data_type_size == 2 || context.data_type_size == 4) ? context.data_type_size : 1;
+    const uint32_t length = static_cast<uint32_t>(Load_Sample(&input_vec[0], sizeof(uint32_t)));
+    const size_t number_of_samples = length / sample_width;
+    const size_t tail_bytes = length - number_of_samples * sample_width;
+    const size_t samples_per_row = (context.samples_per_row == 0) ? number_of_samples : std::min<size_t>(context.samples_per_row, number_of_samples);
+    const uint32_t sample_mask = static_cast<uint32_t>(Get_Sample_Mask(sample_width));
+    output_vec.resize(length);
+    std::copy_n(input_vec.begin() + sizeof(uint32_t), tail_bytes, output_vec.begin() + number_of_samples * sample_width);
+
+    // bit planes back into residuals, then residuals back into the zigzag free differences
+    residual_vec.assign((number_of_samples + FLOAT_BLOCK_SAMPLES - 1) / FLOAT_BLOCK_SAMPLES * FLOAT_BLOCK_SAMPLES, 0);
+    size_t position = sizeof(uint32_t) + tail_bytes;
+    for(size_t block_start = 0; block_start < residual_vec.size(); block_start += FLOAT_BLOCK_SAMPLES) {
+        if(position >= input_vec.size()) {
+            ERROR_MSG_AND_EXIT("ERROR: float stream is truncated.");
+        }
+        const int bit_width = static_cast<uint8_t>(input_vec[position++]);
+        const size_t block_samples = std::min<size_t>(FLOAT_BLOCK_SAMPLES, number_of_samples - block_start);
+        const size_t block_bytes = (block_samples < FLOAT_BLOCK_SAMPLES) ? (block_samples * bit_width + 7) / 8 : bit_width * sizeof(uint32_t);
+        if(bit_width > 32 || position + block_bytes > input_vec.size()) {
+            ERROR_MSG_AND_EXIT("ERROR: float stream is corrupt.");
+        }
+        uint32_t* block = &residual_vec[block_start];
+        if(block_samples < FLOAT_BLOCK_SAMPLES) {
+            const uint64_t value_mask = (uint64_t{1} << bit_width) - 1;
+            uint64_t bit_buffer = 0;
+            int buffered_bits = 0;
+            for(size_t i = 0; i < block_samples; i++) {
+                for(; buffered_bits < bit_width; buffered_bits += 8) {
+                    bit_buffer |= uint64_t{static_cast<uint8_t>(input_vec[position++])} << buffered_bits;
+                }
+                block[i] = static_cast<uint32_t>(bit_buffer & value_mask);
+                bit_buffer >>= bit_width;
+                buffered_bits -= bit_width;
+            }
+        } else {
+            for(int bit = 0; bit < bit_width; bit++) {
+                const uint32_t plane = static_cast<uint32_t>(Load_Sample(&input_vec[position], sizeof(uint32_t)));
+                const uint32_t bit_value = uint32_t{1} << bit;
+                position += sizeof(uint32_t);
+                for(int i = 0; i < FLOAT_BLOCK_SAMPLES; i++) {
+                    block[i] |= bit_value & (0u - static_cast<uint32_t>((plane & float_lane_bits_arr[i]) != 0));
+                }
+            }
+        }
+        for(int i = 0; i < FLOAT_BLOCK_SAMPLES; i++) {
+            block[i] = (block[i] >> 1) ^ (0u - (block[i] & 1u));
+        }
+    }
+
+    // the running sum along the row is the only serial step, adding the upper row and remapping are again per sample
+    sample_vec.resize(number_of_samples);
+    for(size_t row_start = 0; row_start < number_of_samples; row_start += samples_per_row) {
+        const size_t row_end = std::min(row_start + samples_per_row, number_of_samples);
+        uint32_t difference = 0;
+        for(size_t i = row_start; i < row_end; i++) {
+            difference += residual_vec[i];
+            sample_vec[i] = difference;
+        }
+        if(row_start >= samples_per_row) {
+            for(size_t i = row_start; i < row_end; i++) {
+                sample_vec[i] += sample_vec[i - samples_per_row];
+            }
+        }
+    }
+    for(size_t i = 0; i < number_of_samples; i++) {
+        const uint32_t sample = sample_vec[i] & sample_mask;
+        Store_Sample(&output_vec[i * sample_width], (sample_width == 4) ? Ordered_To_Float_Bits(sample) : sample, sample_width);
+    }
+}
+
+
+#ifdef GEOBIN_HAVE_LZ4
+// LZ4Stage
+
+void LZ4Stage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const int bound = LZ4_compressBound(static_cast<int>(input_vec.size()));
+    output_vec.resize(sizeof(uint32_t) + bound);
+    Store_Sample(output_vec.data(), input_vec.size(), sizeof(uint32_t));
+    const int compressed_size = LZ4_compress_default(input_vec.data(), output_vec.data() + sizeof(uint32_t), static_cast<int>(input_vec.size()), bound);
+    if(compressed_size <= 0 && !input_vec.empty()) {
+        ERROR_MSG_AND_EXIT("ERROR: LZ4_compress_default failed.");
+    }
+    output_vec.resize(sizeof(uint32_t) + compressed_size);
+}
+
+void LZ4Stage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const uint32_t length = static_cast<uint32_t>(Load_Sample(input_vec.data(), sizeof(uint32_t)));
+    output_vec.resize(length);
+    if(LZ4_decompress_safe(input_vec.data() + sizeof(uint32_t), output_vec.data(), static_cast<int>(input_vec.size() - sizeof(uint32_t)), static_cast<int>(length)) < 0) {
+        ERROR_MSG_AND_EXIT("ERROR: LZ4_decompress_safe failed.");
+    }
+}
+#endif
+
+
+#ifdef GEOBIN_HAVE_ZSTD
+// ZstdStage
+
+void ZstdStage::Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    output_vec.resize(ZSTD_compressBound(input_vec.size()));
+    const size_t compressed_size = ZSTD_compress(output_vec.data(), output_vec.size(), input_vec.data(), input_vec.size(), 3);
+    if(ZSTD_isError(compressed_size)) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: ZSTD_compress failed: "} + std::string{ZSTD_getErrorName(compressed_size)});
+    }
+    output_vec.resize(compressed_size);
+}
+
+void ZstdStage::Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) {
+    const unsigned long long length = ZSTD_getFrameContentSize(input_vec.data(), input_vec.size());
+    if(length == ZSTD_CONTENTSIZE_ERROR || length == ZSTD_CONTENTSIZE_UNKNOWN) {
+        ERROR_MSG_AND_EXIT("ERROR: zstd frame has no decoded size.");
+    }
+    output_vec.resize(length);
+    const size_t decompressed_size = ZSTD_decompress(output_vec.data(), output_vec.size(), input_vec.data(), input_vec.size());
+    if(ZSTD_isError(decompressed_size)) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: ZSTD_decompress failed: "} + std::string{ZSTD_getErrorName(decompressed_size)});
+    }
+}
+#endif
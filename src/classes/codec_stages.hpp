@@ -0,0 +1,162 @@
+#pragma once
+
+#include "codec_pipeline.hpp"
+#include "context_model_codec.hpp"
+#include <vector>
+#include <array>
+
+// registers every stage below under its spec name, called once by CodecRegistry
+void Register_Default_Codec_Stages(CodecRegistry& registry);
+
+// stores the row as is, the fallback when nothing else beats the original size
+class RawStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+
+// sample[i] - sample[i-1], wrapping at the width of data_type_size
+class DeltaStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+
+// sample[i] ^ sample[i-1]
+class XorStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+
+// byte level move to front
+class MoveToFrontStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+
+// byte level burrows wheeler, output is [4 byte primary index][last column]
+class BurrowsWheelerStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+
+    private:
+        std::vector<uint32_t> suffix_vec;
+        std::vector<uint32_t> rank_vec;
+        std::vector<uint32_t> temp_rank_vec;
+};
+
+// splits samples into byte planes (all first bytes, then all second bytes, ...)
+class ByteShuffleStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+
+// run length over samples with a run counter of run_length_bytes bytes
+// output is [1 byte sample width] then repeated [run length][sample]
+class RunLengthStage : public CodecStage {
+    public:
+        explicit RunLengthStage(const int& run_length_bytes);
+
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+
+    private:
+        int run_length_bytes = 1;
+};
+
+// static order-0 rANS over bytes, 12 bit probabilities
+// output is [4 byte length][2 byte symbol count][symbol, 2 byte frequency]...[rANS stream], or the row as is
+// behind its length with the top bit set when that is no smaller
+class RansStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+
+    private:
+        std::array<uint32_t, 256> frequency_arr = {0};
+        std::array<uint32_t, 256> cumulative_frequency_arr = {0};
+        std::vector<uint8_t> slot_to_symbol_vec;
+};
+
+// canonical huffman over bytes, codes limited to HUFFMAN_MAX_CODE_BITS. rows of HUFFMAN_INTERLEAVED_MINIMUM_BYTES or more
+// are split into 4 quarters coded as separate bit streams, decoded side by side so the lookups overlap. every decode
+// table entry resolves up to 3 symbols, read msb first from an unaligned 64 bit load.
+// output is [4 byte length][1 byte layout][code lengths][3 x 4 byte stream sizes if interleaved][streams], or the
+// row as is behind its length with the top bit set when that is no smaller
+class HuffmanStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+
+    private:
+        struct DecodeEntry {
+            uint8_t symbols[3];
+            uint8_t number_of_symbols;
+            uint8_t number_of_bits;
+            uint8_t first_symbol_bits;
+        };
+
+        // fills code_arr from length_arr, codes of one length are consecutive in symbol order
+        void Assign_Canonical_Codes();
+
+        std::array<uint32_t, 256> count_arr = {0};
+        std::array<uint8_t, 256> length_arr = {0};
+        std::array<uint32_t, 256> code_arr = {0};
+        std::vector<DecodeEntry> decode_table_vec;
+        // the streams plus 8 zero bytes, so the last 64 bit loads never leave the buffer
+        std::vector<uint8_t> padded_stream_vec;
+};
+
+// adaptive binary arithmetic coding of the samples with order-1/order-2 neighbour contexts (see ContextModel),
+// the upper neighbour is only there when the stage is handed more than one row. mixing blends orders 0-2.
+// output is [4 byte length][trailing partial sample][arithmetic coded stream]
+class ContextModelStage : public CodecStage {
+    public:
+        explicit ContextModelStage(const bool& mixing);
+
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+
+    private:
+        ContextModel model;
+};
+
+// lossless float samples. 4 byte samples are IEEE floats remapped to integers that sort like the floats (fpzip),
+// other sizes are taken as integers. every sample is predicted from its left, upper and upper left neighbours
+// (Lorenzo), the upper row is only there when the stage is handed more than one row. the zigzagged residuals are
+// packed FLOAT_BLOCK_SAMPLES at a time as one 32 bit word per significant bit, so decoding a block is branch free
+// masking over the whole block that vectorises. a last block shorter than FLOAT_BLOCK_SAMPLES packs its residuals
+// bit width bits apiece (lsb first) instead, so rows of 2^k + 1 samples do not pay a full block for one sample.
+// output is [4 byte length][trailing partial sample][per block: 1 byte bit width, bit width x 4 byte bit planes
+//           (last short block: samples x bit width bits, rounded up to a byte)]
+class FloatStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+
+    private:
+        std::vector<uint32_t> sample_vec;
+        std::vector<uint32_t> residual_vec;
+};
+
+#ifdef GEOBIN_HAVE_LZ4
+// output is [4 byte length][lz4 block]
+class LZ4Stage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+#endif
+
+#ifdef GEOBIN_HAVE_ZSTD
+// a single zstd frame, the frame header carries the decoded length
+class ZstdStage : public CodecStage {
+    public:
+        void Encode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+        void Decode(const std::vector<char>& input_vec, std::vector<char>& output_vec, const StageContext& context) override;
+};
+#endif
@@ -1,4 +1,7 @@
 #include "common_stats.hpp"
+#include "results_database.hpp"
+#include "repetition_harness.hpp"
+#include "geobin_catalog.hpp"
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <chrono>
@@ -6,6 +9,9 @@
 #include <filesystem>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
 #include "../functions/file_functions.hpp"
 
 #define ERROR_MSG(msg) \
@@ -26,6 +32,38 @@
 
 using json = nlohmann::json;
 
+// sub-microsecond rows are noisy one at a time, so with rows_per_sample > 1 the histogram gets the batch mean.
+// the batch is claimed and emptied with one compare exchange, a batch whose nanoseconds would no longer fit its word
+// is recorded early
+static void Record_Latency_Sample(std::atomic<uint64_t>& pending_batch, std::atomic<LatencyHistogram*>& histogram_ptr,
+                                  const uint64_t& nanoseconds, const uint32_t& rows_per_sample) {
+    if(rows_per_sample <= 1) {
+        Get_Or_Create_Latency_Histogram(histogram_ptr).Record(nanoseconds);
+        return;
+    }
+    const uint64_t row_nanoseconds = std::min(nanoseconds, PENDING_BATCH_NANOSECONDS_MASK);
+    uint64_t batch = pending_batch.load(std::memory_order_relaxed);
+    uint64_t batch_rows = 0;
+    uint64_t batch_nanoseconds = 0;
+    bool batch_complete = false;
+    do {
+        batch_rows = (batch >> PENDING_BATCH_ROWS_SHIFT) + 1;
+        batch_nanoseconds = (batch & PENDING_BATCH_NANOSECONDS_MASK) + row_nanoseconds;
+        batch_complete = (batch_rows >= rows_per_sample || batch_nanoseconds > PENDING_BATCH_NANOSECONDS_MASK);
+    } while(!pending_batch.compare_exchange_weak(batch, batch_complete ? 0 : ((batch_rows << PENDING_BATCH_ROWS_SHIFT) | batch_nanoseconds), std::memory_order_relaxed));
+    if(batch_complete) {
+        Get_Or_Create_Latency_Histogram(histogram_ptr).Record(batch_nanoseconds / batch_rows);
+    }
+}
+
+static void Flush_Pending_Latency_Sample(std::atomic<uint64_t>& pending_batch, std::atomic<LatencyHistogram*>& histogram_ptr) {
+    const uint64_t batch = pending_batch.exchange(0, std::memory_order_relaxed);
+    const uint64_t rows = batch >> PENDING_BATCH_ROWS_SHIFT;
+    if(rows != 0) {
+        Get_Or_Create_Latency_Histogram(histogram_ptr).Record((batch & PENDING_BATCH_NANOSECONDS_MASK) / rows);
+    }
+}
+
 
 CommonStats::CommonStats() {
     average_compressed_file_size = 0.0;
@@ -36,34 +74,29 @@ CommonStats::CommonStats() {
     average_decoded_throughput = 0.0;
     data_type_byte_size = 0;
     number_of_iterations = 0;
+    perf_counters_enabled = (std::getenv("GEOBIN_PERF_COUNTERS") != nullptr);
+    flush_caches_between_iterations = (std::getenv("GEOBIN_FLUSH_CACHES") != nullptr);
 }
 
 CommonStats::CommonStats(const CommonStats& other) {
-    average_compressed_file_size = other.average_compressed_file_size;
-    average_time_encoded_in_microseconds  = other.average_time_encoded_in_microseconds ;
-    average_time_decoded_in_microseconds  = other.average_time_decoded_in_microseconds ;
-    average_compression_ratio = other.average_compression_ratio;
-    average_encoded_throughput = other.average_encoded_throughput;
-    average_decoded_throughput = other.average_decoded_throughput;
-    data_type_byte_size = other.data_type_byte_size;
-    number_of_iterations = other.number_of_iterations;
+    *this = other;
 }
 
 CommonStats& CommonStats::operator=(const CommonStats& other) {
-    average_compressed_file_size = other.average_compressed_file_size;
-    average_time_encoded_in_microseconds  = other.average_time_encoded_in_microseconds ;
-    average_time_decoded_in_microseconds  = other.average_time_decoded_in_microseconds ;
-    average_compression_ratio = other.average_compression_ratio;
-    average_encoded_throughput = other.average_encoded_throughput;
-    average_decoded_throughput = other.average_decoded_throughput;
-    data_type_byte_size = other.data_type_byte_size;
-    number_of_iterations = other.number_of_iterations;
+    Copy_Folded_Stats(other);
+    Copy_Stats_Shards(other);
 
     return *this;
 }
 
 //move constructor
-CommonStats::CommonStats(CommonStats&& other) {
+CommonStats::CommonStats(CommonStats&& other) : stats_shards_arr(std::move(other.stats_shards_arr)) {
+    Copy_Folded_Stats(other);
+}
+
+void CommonStats::Copy_Folded_Stats(const CommonStats& other) {
+    average_original_file_size = other.average_original_file_size;
+    total_original_bytes = other.total_original_bytes;
     average_compressed_file_size = other.average_compressed_file_size;
     average_time_encoded_in_microseconds  = other.average_time_encoded_in_microseconds ;
     average_time_decoded_in_microseconds  = other.average_time_decoded_in_microseconds ;
@@ -71,18 +104,261 @@ CommonStats::CommonStats(CommonStats&& other) {
     average_encoded_throughput = other.average_encoded_throughput;
     average_decoded_throughput = other.average_decoded_throughput;
     data_type_byte_size = other.data_type_byte_size;
+    floating_point_samples = other.floating_point_samples;
     number_of_iterations = other.number_of_iterations;
+    warmup_iterations = other.warmup_iterations;
+    flush_caches_between_iterations = other.flush_caches_between_iterations;
+    iteration_samples_vec = other.iteration_samples_vec;
+    iteration_mark_encoded_microseconds = other.iteration_mark_encoded_microseconds;
+    iteration_mark_decoded_microseconds = other.iteration_mark_decoded_microseconds;
+    rows_per_timing_sample = other.rows_per_timing_sample;
+    perf_counters_enabled = other.perf_counters_enabled;
+    encode_perf_counts_arr = other.encode_perf_counts_arr;
+    decode_perf_counts_arr = other.decode_perf_counts_arr;
+    encode_calls = other.encode_calls;
+    encode_allocations = other.encode_allocations;
+    encode_allocated_bytes = other.encode_allocated_bytes;
+    decode_calls = other.decode_calls;
+    decode_allocations = other.decode_allocations;
+    decode_allocated_bytes = other.decode_allocated_bytes;
+    peak_resident_set_bytes = other.peak_resident_set_bytes;
+    little_endian_flag = other.little_endian_flag;
+    side_resolutions = other.side_resolutions;
+    encode_latency_histogram.Reset();
+    encode_latency_histogram.Merge(other.encode_latency_histogram);
+    decode_latency_histogram.Reset();
+    decode_latency_histogram.Merge(other.decode_latency_histogram);
+}
+
+void CommonStats::Fold_Stats_Shards() {
+    peak_resident_set_bytes = std::max(peak_resident_set_bytes, ::Get_Peak_Resident_Set_Bytes());
+    if(!stats_shards_arr) {
+        return;
+    }
+    for(auto& shard : *stats_shards_arr) {
+        average_time_encoded_in_microseconds  += static_cast<double>(shard.time_encoded_in_nanoseconds.exchange(0, std::memory_order_relaxed)) / 1000.0;
+        average_time_decoded_in_microseconds  += static_cast<double>(shard.time_decoded_in_nanoseconds.exchange(0, std::memory_order_relaxed)) / 1000.0;
+        // a partial batch still counts as one sample
+        Flush_Pending_Latency_Sample(shard.pending_encode_batch, shard.encode_latency_histogram);
+        Flush_Pending_Latency_Sample(shard.pending_decode_batch, shard.decode_latency_histogram);
+        for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+            encode_perf_counts_arr[counter] += shard.encode_perf_counts_arr[counter].exchange(0, std::memory_order_relaxed);
+            decode_perf_counts_arr[counter] += shard.decode_perf_counts_arr[counter].exchange(0, std::memory_order_relaxed);
+        }
+        encode_calls += shard.encode_calls.exchange(0, std::memory_order_relaxed);
+        encode_allocations += shard.encode_allocations.exchange(0, std::memory_order_relaxed);
+        encode_allocated_bytes += shard.encode_allocated_bytes.exchange(0, std::memory_order_relaxed);
+        decode_calls += shard.decode_calls.exchange(0, std::memory_order_relaxed);
+        decode_allocations += shard.decode_allocations.exchange(0, std::memory_order_relaxed);
+        decode_allocated_bytes += shard.decode_allocated_bytes.exchange(0, std::memory_order_relaxed);
+        const uint64_t shard_original_bytes = shard.original_file_size.exchange(0, std::memory_order_relaxed);
+        average_original_file_size += static_cast<double>(shard_original_bytes);
+        total_original_bytes += shard_original_bytes;
+        average_compressed_file_size += static_cast<double>(shard.compressed_file_size.exchange(0, std::memory_order_relaxed));
+        average_compression_ratio += shard.compression_ratio.exchange(0.0, std::memory_order_relaxed);
+        // no thread is recording any more (see the class comment), so the shard histogram is kept for the next run
+        if(LatencyHistogram* histogram = shard.encode_latency_histogram.load(std::memory_order_acquire)) {
+            encode_latency_histogram.Merge(*histogram);
+            histogram->Reset();
+        }
+        if(LatencyHistogram* histogram = shard.decode_latency_histogram.load(std::memory_order_acquire)) {
+            decode_latency_histogram.Merge(*histogram);
+            histogram->Reset();
+        }
+    }
+}
+
+void CommonStats::Clear_Stats_Shards() {
+    if(!stats_shards_arr) {
+        return;
+    }
+    for(auto& shard : *stats_shards_arr) {
+        shard.time_encoded_in_nanoseconds.store(0, std::memory_order_relaxed);
+        shard.time_decoded_in_nanoseconds.store(0, std::memory_order_relaxed);
+        shard.original_file_size.store(0, std::memory_order_relaxed);
+        shard.compressed_file_size.store(0, std::memory_order_relaxed);
+        shard.compression_ratio.store(0.0, std::memory_order_relaxed);
+        shard.pending_encode_batch.store(0, std::memory_order_relaxed);
+        shard.pending_decode_batch.store(0, std::memory_order_relaxed);
+        shard.encode_calls.store(0, std::memory_order_relaxed);
+        shard.encode_allocations.store(0, std::memory_order_relaxed);
+        shard.encode_allocated_bytes.store(0, std::memory_order_relaxed);
+        shard.decode_calls.store(0, std::memory_order_relaxed);
+        shard.decode_allocations.store(0, std::memory_order_relaxed);
+        shard.decode_allocated_bytes.store(0, std::memory_order_relaxed);
+        for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+            shard.encode_perf_counts_arr[counter].store(0, std::memory_order_relaxed);
+            shard.decode_perf_counts_arr[counter].store(0, std::memory_order_relaxed);
+        }
+        if(LatencyHistogram* histogram = shard.encode_latency_histogram.load(std::memory_order_acquire)) {
+            histogram->Reset();
+        }
+        if(LatencyHistogram* histogram = shard.decode_latency_histogram.load(std::memory_order_acquire)) {
+            histogram->Reset();
+        }
+    }
+}
+
+void CommonStats::Copy_Stats_Shards(const CommonStats& other) {
+    // a moved-from other has no shards left, which reads as empty ones
+    if(!stats_shards_arr || !other.stats_shards_arr) {
+        stats_shards_arr = std::make_unique<std::array<StatsShard, NUMBER_OF_STATS_SHARDS>>();
+    }
+    if(!other.stats_shards_arr) {
+        return;
+    }
+    for(size_t shard = 0; shard < NUMBER_OF_STATS_SHARDS; shard++) {
+        const StatsShard& other_shard = (*other.stats_shards_arr)[shard];
+        StatsShard& this_shard = (*stats_shards_arr)[shard];
+        this_shard.time_encoded_in_nanoseconds.store(other_shard.time_encoded_in_nanoseconds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.time_decoded_in_nanoseconds.store(other_shard.time_decoded_in_nanoseconds.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.pending_encode_batch.store(other_shard.pending_encode_batch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.pending_decode_batch.store(other_shard.pending_decode_batch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+            this_shard.encode_perf_counts_arr[counter].store(other_shard.encode_perf_counts_arr[counter].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            this_shard.decode_perf_counts_arr[counter].store(other_shard.decode_perf_counts_arr[counter].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        this_shard.encode_calls.store(other_shard.encode_calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.encode_allocations.store(other_shard.encode_allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.encode_allocated_bytes.store(other_shard.encode_allocated_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.decode_calls.store(other_shard.decode_calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.decode_allocations.store(other_shard.decode_allocations.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.decode_allocated_bytes.store(other_shard.decode_allocated_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.original_file_size.store(other_shard.original_file_size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.compressed_file_size.store(other_shard.compressed_file_size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        this_shard.compression_ratio.store(other_shard.compression_ratio.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        if(const LatencyHistogram* histogram = other_shard.encode_latency_histogram.load(std::memory_order_acquire)) {
+            LatencyHistogram& copy_histogram = Get_Or_Create_Latency_Histogram(this_shard.encode_latency_histogram);
+            copy_histogram.Reset();
+            copy_histogram.Merge(*histogram);
+        }
+        if(const LatencyHistogram* histogram = other_shard.decode_latency_histogram.load(std::memory_order_acquire)) {
+            LatencyHistogram& copy_histogram = Get_Or_Create_Latency_Histogram(this_shard.decode_latency_histogram);
+            copy_histogram.Reset();
+            copy_histogram.Merge(*histogram);
+        }
+    }
+}
+
+void CommonStats::Record_Time_Encoded(const uint64_t& elapsed_ticks, const AllocationCounts& allocations) {
+    StatsShard& shard = Get_Thread_Stats_Shard();
+    const uint64_t nanoseconds = Timer_Ticks_To_Nanoseconds(elapsed_ticks);
+    shard.time_encoded_in_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    shard.encode_calls.fetch_add(1, std::memory_order_relaxed);
+    shard.encode_allocations.fetch_add(allocations.allocations, std::memory_order_relaxed);
+    shard.encode_allocated_bytes.fetch_add(allocations.bytes, std::memory_order_relaxed);
+    Record_Latency_Sample(shard.pending_encode_batch, shard.encode_latency_histogram, nanoseconds, rows_per_timing_sample);
+}
+
+// a call the multiplexed group never ran for is left out rather than counted as zero
+void CommonStats::Record_Perf_Counts(const PerfReading& start_reading, std::array<std::atomic<uint64_t>, NUMBER_OF_PERF_COUNTERS>& shard_counts_arr) {
+    PerfReading end_reading;
+    PerfCounts deltas_arr;
+    if(!Get_Thread_Perf_Counter_Group().Read(end_reading) || !Get_Perf_Count_Deltas(start_reading, end_reading, deltas_arr)) {
+        return;
+    }
+    for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+        shard_counts_arr[counter].fetch_add(deltas_arr[counter], std::memory_order_relaxed);
+    }
+}
+
+void CommonStats::Record_Time_Decoded(const uint64_t& elapsed_ticks, const AllocationCounts& allocations) {
+    StatsShard& shard = Get_Thread_Stats_Shard();
+    const uint64_t nanoseconds = Timer_Ticks_To_Nanoseconds(elapsed_ticks);
+    shard.time_decoded_in_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    shard.decode_calls.fetch_add(1, std::memory_order_relaxed);
+    shard.decode_allocations.fetch_add(allocations.allocations, std::memory_order_relaxed);
+    shard.decode_allocated_bytes.fetch_add(allocations.bytes, std::memory_order_relaxed);
+    Record_Latency_Sample(shard.pending_decode_batch, shard.decode_latency_histogram, nanoseconds, rows_per_timing_sample);
 }
 
 void CommonStats::Reset_Stats() {
+    Fold_Stats_Shards();
     average_compressed_file_size = 0.0;
     average_original_file_size = 0.0;
+    total_original_bytes = 0;
     average_time_encoded_in_microseconds  = 0.0;
     average_time_decoded_in_microseconds  = 0.0;
     average_compression_ratio = 0.0;
     average_encoded_throughput = 0.0;
     average_decoded_throughput = 0.0;
     data_type_byte_size = 0;
+    floating_point_samples = false;
+    encode_latency_histogram.Reset();
+    decode_latency_histogram.Reset();
+    encode_perf_counts_arr.fill(0);
+    decode_perf_counts_arr.fill(0);
+    encode_calls = 0;
+    encode_allocations = 0;
+    encode_allocated_bytes = 0;
+    decode_calls = 0;
+    decode_allocations = 0;
+    decode_allocated_bytes = 0;
+    // the next directory gets its own high-water mark where the kernel allows it
+    Reset_Peak_Resident_Set();
+    peak_resident_set_bytes = 0;
+    iteration_samples_vec.clear();
+    iteration_mark_encoded_microseconds = 0.0;
+    iteration_mark_decoded_microseconds = 0.0;
+}
+
+// other may still be recording, its shards are only read so the merge never blocks either side
+void CommonStats::Merge_Stats(const CommonStats& other) {
+    average_compressed_file_size += other.average_compressed_file_size;
+    average_original_file_size += other.average_original_file_size;
+    total_original_bytes += other.total_original_bytes;
+    average_time_encoded_in_microseconds  += other.average_time_encoded_in_microseconds;
+    average_time_decoded_in_microseconds  += other.average_time_decoded_in_microseconds;
+    average_compression_ratio += other.average_compression_ratio;
+    encode_latency_histogram.Merge(other.encode_latency_histogram);
+    decode_latency_histogram.Merge(other.decode_latency_histogram);
+    for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+        encode_perf_counts_arr[counter] += other.encode_perf_counts_arr[counter];
+        decode_perf_counts_arr[counter] += other.decode_perf_counts_arr[counter];
+    }
+    encode_calls += other.encode_calls;
+    encode_allocations += other.encode_allocations;
+    encode_allocated_bytes += other.encode_allocated_bytes;
+    decode_calls += other.decode_calls;
+    decode_allocations += other.decode_allocations;
+    decode_allocated_bytes += other.decode_allocated_bytes;
+    peak_resident_set_bytes = std::max(peak_resident_set_bytes, other.peak_resident_set_bytes);
+    if(iteration_samples_vec.size() < other.iteration_samples_vec.size()) {
+        iteration_samples_vec.resize(other.iteration_samples_vec.size());
+    }
+    for(size_t iteration = 0; iteration < other.iteration_samples_vec.size(); iteration++) {
+        iteration_samples_vec[iteration].encoded_microseconds += other.iteration_samples_vec[iteration].encoded_microseconds;
+        iteration_samples_vec[iteration].decoded_microseconds += other.iteration_samples_vec[iteration].decoded_microseconds;
+        iteration_samples_vec[iteration].original_bytes += other.iteration_samples_vec[iteration].original_bytes;
+        iteration_samples_vec[iteration].compressed_bytes += other.iteration_samples_vec[iteration].compressed_bytes;
+    }
+    if(!other.stats_shards_arr) {
+        return;
+    }
+    for(const auto& shard : *other.stats_shards_arr) {
+        average_time_encoded_in_microseconds  += static_cast<double>(shard.time_encoded_in_nanoseconds.load(std::memory_order_relaxed)) / 1000.0;
+        average_time_decoded_in_microseconds  += static_cast<double>(shard.time_decoded_in_nanoseconds.load(std::memory_order_relaxed)) / 1000.0;
+        average_original_file_size += static_cast<double>(shard.original_file_size.load(std::memory_order_relaxed));
+        total_original_bytes += shard.original_file_size.load(std::memory_order_relaxed);
+        average_compressed_file_size += static_cast<double>(shard.compressed_file_size.load(std::memory_order_relaxed));
+        average_compression_ratio += shard.compression_ratio.load(std::memory_order_relaxed);
+        if(const LatencyHistogram* histogram = shard.encode_latency_histogram.load(std::memory_order_acquire)) {
+            encode_latency_histogram.Merge(*histogram);
+        }
+        if(const LatencyHistogram* histogram = shard.decode_latency_histogram.load(std::memory_order_acquire)) {
+            decode_latency_histogram.Merge(*histogram);
+        }
+        for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+            encode_perf_counts_arr[counter] += shard.encode_perf_counts_arr[counter].load(std::memory_order_relaxed);
+            decode_perf_counts_arr[counter] += shard.decode_perf_counts_arr[counter].load(std::memory_order_relaxed);
+        }
+        encode_calls += shard.encode_calls.load(std::memory_order_relaxed);
+        encode_allocations += shard.encode_allocations.load(std::memory_order_relaxed);
+        encode_allocated_bytes += shard.encode_allocated_bytes.load(std::memory_order_relaxed);
+        decode_calls += shard.decode_calls.load(std::memory_order_relaxed);
+        decode_allocations += shard.decode_allocations.load(std::memory_order_relaxed);
+        decode_allocated_bytes += shard.decode_allocated_bytes.load(std::memory_order_relaxed);
+    }
 }
 
 void CommonStats::Write_Stats_To_File(const std::filesystem::path& file_path, const char* compression_type, const std::string& directory_compressed) const {
@@ -103,13 +379,126 @@ void CommonStats::Write_Stats_To_File(const std::filesystem::path& file_path, co
     stats_json["average_uncompressed_file_size_bytes"] = average_original_file_size;
     stats_json["average_compressed_file_size_bytes"] = average_compressed_file_size;
     stats_json["number_of_iterations"] = number_of_iterations;
+    stats_json["warmup_iterations"] = warmup_iterations;
+    stats_json["pinned_cpu"] = Get_Pinned_Cpu();
+    stats_json["cache_flush_between_iterations"] = flush_caches_between_iterations;
+    if(!iteration_samples_vec.empty()) {
+        // one entry per measured pass, with the same metric names as above so compare can pool them
+        json iterations_json = json::array();
+        std::vector<double> encoded_throughput_vec;
+        std::vector<double> decoded_throughput_vec;
+        for(const auto& sample : iteration_samples_vec) {
+            encoded_throughput_vec.push_back(static_cast<double>(sample.original_bytes) / std::max(sample.encoded_microseconds, 1e-9));
+            decoded_throughput_vec.push_back(static_cast<double>(sample.original_bytes) / std::max(sample.decoded_microseconds, 1e-9));
+            iterations_json.push_back({
+                {"encoded_time_microseconds", sample.encoded_microseconds},
+                {"decoded_time_microseconds", sample.decoded_microseconds},
+                {"average_encoded_throughput_bytes_per_microseconds", encoded_throughput_vec.back()},
+                {"average_decoded_throughput_bytes_per_microseconds", decoded_throughput_vec.back()},
+                {"average_compression_ratio", static_cast<double>(sample.compressed_bytes) / static_cast<double>(std::max<uint64_t>(sample.original_bytes, 1))},
+            });
+        }
+        stats_json["iterations"] = iterations_json;
+
+        auto variance_json = [](const std::vector<double>& value_vec) -> json {
+            double mean = 0.0;
+            for(const double value : value_vec) {
+                mean += value;
+            }
+            mean /= static_cast<double>(value_vec.size());
+            double variance = 0.0;
+            for(const double value : value_vec) {
+                variance += (value - mean) * (value - mean);
+            }
+            variance = (value_vec.size() > 1) ? variance / static_cast<double>(value_vec.size() - 1) : 0.0;
+            return json{{"mean", mean}, {"stddev", std::sqrt(variance)}, {"coefficient_of_variation_percent", (mean > 0.0) ? 100.0 * std::sqrt(variance) / mean : 0.0},
+                        {"min", *std::min_element(value_vec.begin(), value_vec.end())}, {"max", *std::max_element(value_vec.begin(), value_vec.end())}};
+        };
+        stats_json["encoded_throughput_across_iterations"] = variance_json(encoded_throughput_vec);
+        stats_json["decoded_throughput_across_iterations"] = variance_json(decoded_throughput_vec);
+    }
+
+    // per row latency tails, the averages above hide a handful of slow rows
+    auto latency_json = [](const LatencyHistogram& histogram) -> json {
+        json percentiles_json;
+        percentiles_json["count"] = histogram.Get_Count();
+        percentiles_json["p50"] = static_cast<double>(histogram.Get_Value_At_Percentile(50.0)) / 1000.0;
+        percentiles_json["p90"] = static_cast<double>(histogram.Get_Value_At_Percentile(90.0)) / 1000.0;
+        percentiles_json["p99"] = static_cast<double>(histogram.Get_Value_At_Percentile(99.0)) / 1000.0;
+        percentiles_json["p99_9"] = static_cast<double>(histogram.Get_Value_At_Percentile(99.9)) / 1000.0;
+        percentiles_json["max"] = static_cast<double>(histogram.Get_Max()) / 1000.0;
+        return percentiles_json;
+    };
+    stats_json["encoded_latency_microseconds"] = latency_json(encode_latency_histogram);
+    stats_json["decoded_latency_microseconds"] = latency_json(decode_latency_histogram);
+    stats_json["timer"] = Get_Timer_Name();
+    stats_json["timer_overhead_nanoseconds"] = static_cast<double>(Get_Timer_Overhead_Ticks()) * Get_Timer_Nanoseconds_Per_Tick();
+    stats_json["rows_per_timing_sample"] = rows_per_timing_sample;
+    stats_json["peak_resident_set_bytes"] = peak_resident_set_bytes;
+    stats_json["encode_calls"] = encode_calls;
+    stats_json["decode_calls"] = decode_calls;
+    stats_json["allocation_counting"] = Is_Allocation_Counting_Enabled();
+    if(Is_Allocation_Counting_Enabled()) {
+        stats_json["allocations_per_encode_call"] = static_cast<double>(encode_allocations) / static_cast<double>(std::max<uint64_t>(1, encode_calls));
+        stats_json["allocated_bytes_per_encode_call"] = static_cast<double>(encode_allocated_bytes) / static_cast<double>(std::max<uint64_t>(1, encode_calls));
+        stats_json["allocations_per_decode_call"] = static_cast<double>(decode_allocations) / static_cast<double>(std::max<uint64_t>(1, decode_calls));
+        stats_json["allocated_bytes_per_decode_call"] = static_cast<double>(decode_allocated_bytes) / static_cast<double>(std::max<uint64_t>(1, decode_calls));
+    }
+
+    if(perf_counters_enabled) {
+        const PerfCounterGroup& perf_counter_group = Get_Thread_Perf_Counter_Group();
+        // the counters are never divided, so neither is the byte count they are taken per
+        auto perf_json = [&perf_counter_group, this](const PerfCounts& counts_arr) -> json {
+            json counters_json;
+            const double bytes = std::max(1.0, static_cast<double>(total_original_bytes));
+            for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+                const PerfCounter perf_counter = static_cast<PerfCounter>(counter);
+                if(perf_counter_group.Is_Counter_Available(perf_counter)) {
+                    counters_json[Get_Perf_Counter_Name(perf_counter)] = counts_arr[counter];
+                }
+            }
+            if(perf_counter_group.Is_Counter_Available(PerfCounter::cycles) && perf_counter_group.Is_Counter_Available(PerfCounter::instructions)) {
+                counters_json["instructions_per_cycle"] = static_cast<double>(counts_arr[static_cast<size_t>(PerfCounter::instructions)]) /
+                                                          std::max(1.0, static_cast<double>(counts_arr[static_cast<size_t>(PerfCounter::cycles)]));
+                counters_json["cycles_per_byte"] = static_cast<double>(counts_arr[static_cast<size_t>(PerfCounter::cycles)]) / bytes;
+            }
+            for(const PerfCounter perf_counter : {PerfCounter::branch_misses, PerfCounter::l1d_read_misses, PerfCounter::llc_misses}) {
+                if(perf_counter_group.Is_Counter_Available(perf_counter)) {
+                    counters_json[std::string{Get_Perf_Counter_Name(perf_counter)} + std::string{"_per_byte"}] =
+                        static_cast<double>(counts_arr[static_cast<size_t>(perf_counter)]) / bytes;
+                }
+            }
+            return counters_json;
+        };
+        json perf_counters_json;
+        perf_counters_json["available"] = perf_counter_group.Is_Available();
+        if(!perf_counter_group.Get_Unavailable_Reason().empty()) {
+            perf_counters_json["unavailable_reason"] = perf_counter_group.Get_Unavailable_Reason();
+        }
+        if(perf_counter_group.Is_Available()) {
+            perf_counters_json["encoded"] = perf_json(encode_perf_counts_arr);
+            perf_counters_json["decoded"] = perf_json(decode_perf_counts_arr);
+        }
+        stats_json["perf_counters"] = perf_counters_json;
+    }
 
     // write the json object to a file
     std::ofstream stats_file(file_path);
     stats_file << std::setw(4) << stats_json << std::endl;
+
+    // the file above is overwritten by the next run, the results database keeps every run for compare once
+    // GEOBIN_RESULTS_DB names it
+    const std::filesystem::path results_database_path = ResultsDatabase::Get_Recording_Database_Path();
+    if(!results_database_path.empty()) {
+        ResultsDatabase(results_database_path).Append_Record(stats_json.dump());
+    }
 }
 
+// sizes and times are both summed once per file per measured iteration, so both get the same divisor and the
+// throughputs below are per file, not the directory total over one file's time
 void CommonStats::Calculate_Cumulative_Average_Stats_For_Directory(const int& number_of_files) {
+    Fold_Stats_Shards();
+    average_original_file_size /= static_cast<double>((number_of_iterations*number_of_files));
     average_compressed_file_size /= (number_of_iterations*number_of_files);
     average_time_encoded_in_microseconds  /= static_cast<double>((number_of_iterations*number_of_files));
     average_time_decoded_in_microseconds  /= static_cast<double>((number_of_iterations*number_of_files));
@@ -128,19 +517,47 @@ void CommonStats::Is_Little_Endian(){
 }
 
 void CommonStats::Compute_Compression_Ratio(const std::filesystem::path& original_file_path, const std::filesystem::path& compressed_file_path) {
-    average_original_file_size += static_cast<double>(Get_File_Size_Bytes(original_file_path));
-    average_compression_ratio += static_cast<double>(Get_File_Size_Bytes(compressed_file_path)) / static_cast<double>(Get_File_Size_Bytes(original_file_path));
+    StatsShard& shard = Get_Thread_Stats_Shard();
+    shard.original_file_size.fetch_add(Get_File_Size_Bytes(original_file_path), std::memory_order_relaxed);
+    shard.compression_ratio.fetch_add(static_cast<double>(Get_File_Size_Bytes(compressed_file_path)) / static_cast<double>(Get_File_Size_Bytes(original_file_path)), std::memory_order_relaxed);
+}
+
+void CommonStats::Compute_Compression_Ratio(const uint64_t& original_bytes, const uint64_t& compressed_bytes) {
+    StatsShard& shard = Get_Thread_Stats_Shard();
+    shard.original_file_size.fetch_add(original_bytes, std::memory_order_relaxed);
+    shard.compression_ratio.fetch_add(static_cast<double>(compressed_bytes) / static_cast<double>(original_bytes), std::memory_order_relaxed);
 }
 
 void CommonStats::Compute_Compressed_File_Size(const std::filesystem::path& file_path) {
-    average_compressed_file_size += static_cast<double>(Get_File_Size_Bytes(file_path));
+    Get_Thread_Stats_Shard().compressed_file_size.fetch_add(Get_File_Size_Bytes(file_path), std::memory_order_relaxed);
+}
+
+void CommonStats::Compute_Compressed_File_Size(const uint64_t& compressed_bytes) {
+    Get_Thread_Stats_Shard().compressed_file_size.fetch_add(compressed_bytes, std::memory_order_relaxed);
+}
+
+// the time sums only grow until Calculate_Cumulative_Average_Stats_For_Directory, so the difference to the last mark is this iteration
+void CommonStats::End_Measured_Iteration(const int& iteration, const uint64_t& original_bytes, const uint64_t& compressed_bytes) {
+    Fold_Stats_Shards();
+    if(iteration_samples_vec.size() <= static_cast<size_t>(iteration)) {
+        iteration_samples_vec.resize(iteration + 1);
+    }
+    IterationSample& sample = iteration_samples_vec[iteration];
+    sample.encoded_microseconds += average_time_encoded_in_microseconds - iteration_mark_encoded_microseconds;
+    sample.decoded_microseconds += average_time_decoded_in_microseconds - iteration_mark_decoded_microseconds;
+    sample.original_bytes += original_bytes;
+    sample.compressed_bytes += compressed_bytes;
+    iteration_mark_encoded_microseconds = average_time_encoded_in_microseconds;
+    iteration_mark_decoded_microseconds = average_time_decoded_in_microseconds;
 }
 
 void CommonStats::Compute_Encoded_Throughput() {
+    Fold_Stats_Shards();
     average_encoded_throughput = average_original_file_size / average_time_encoded_in_microseconds ;
 }
 
 void CommonStats::Compute_Decoded_Throughput() {
+    Fold_Stats_Shards();
     average_decoded_throughput = average_original_file_size / average_time_decoded_in_microseconds ;
 }
 
@@ -155,6 +572,8 @@ const void CommonStats::Print_Stats(const char* compressionType) const {
     std::cout << "Average Decoded Time: " << average_time_decoded_in_microseconds  << " microseconds" << '\n';
     std::cout << "Average Encoded Throughput: " << average_encoded_throughput << " bytes/microseconds" << '\n';
     std::cout << "Average Throughput Decoded: " << average_decoded_throughput << " bytes/microseconds" << '\n';
+    std::cout << "Encoded Latency p99: " << static_cast<double>(encode_latency_histogram.Get_Value_At_Percentile(99.0)) / 1000.0 << " microseconds" << '\n';
+    std::cout << "Decoded Latency p99: " << static_cast<double>(decode_latency_histogram.Get_Value_At_Percentile(99.0)) / 1000.0 << " microseconds" << '\n';
     // std::cout << "Data size: " << data_type_byte_size << '\n';
     std::cout << "Compression Type: " << compressionType << '\n';
 }
@@ -162,6 +581,16 @@ const void CommonStats::Print_Stats(const char* compressionType) const {
 
 // see if I can avoid using string to reduce the overhead
 void CommonStats::Set_Data_Type_Size_And_Side_Resolutions(const std::filesystem::path& geometa_path) {
+    // cataloged geometa files were parsed when the catalog was built
+    if(const GeobinCatalog* catalog = Get_Active_Geobin_Catalog()) {
+        if(const CatalogDirectory* directory = catalog->Find_Directory_By_Geometa(geometa_path)) {
+            data_type_byte_size = directory->data_type_size;
+            floating_point_samples = (directory->floating_point_samples != 0);
+            side_resolutions = directory->side_resolutions;
+            return;
+        }
+    }
+
     auto parse_json = [](const std::filesystem::path& path) -> const json {
         try {
             std::ifstream file(path);
@@ -188,6 +617,8 @@ void CommonStats::Set_Data_Type_Size_And_Side_Resolutions(const std::filesystem:
     } catch (const json::exception& e) {
         ERROR_MSG_AND_EXIT(std::string{"'storage_bytes_size' key not found or invalid in JSON file."});
     }
+    floating_point_samples = geometa_json.contains("storage_type") && geometa_json["storage_type"].is_string() &&
+                             (geometa_json["storage_type"].get<std::string>().rfind("float", 0) == 0);
 #ifdef DEBUG_MODE
     if (data_type_byte_size <= 0) {
         ERROR_MSG_AND_EXIT(std::string{"Invalid 'storage_bytes_size' in " + geometa_path.string()});
@@ -236,12 +667,71 @@ const int64_t CommonStats::Get_Side_Resolution(const uint8_t& lod_number) const
 const int CommonStats::Get_Data_Type_Size() const {
     return data_type_byte_size;
 }
+const bool CommonStats::Get_Floating_Point_Samples() const {
+    return floating_point_samples;
+}
+
+const std::array<std::array<uint16_t,4>, static_cast<size_t>(Side::NUMBER_SIDES)>& CommonStats::Get_Side_Resolutions() const {
+    return side_resolutions;
+}
 
 const int CommonStats::Get_Number_Of_Iterations() const {
     return number_of_iterations;
 }
 
+const LatencyHistogram& CommonStats::Get_Encode_Latency_Histogram() const {
+    return encode_latency_histogram;
+}
+
+const LatencyHistogram& CommonStats::Get_Decode_Latency_Histogram() const {
+    return decode_latency_histogram;
+}
+
+const uint32_t CommonStats::Get_Rows_Per_Timing_Sample() const {
+    return rows_per_timing_sample;
+}
+
+const bool CommonStats::Get_Perf_Counters_Enabled() const {
+    return perf_counters_enabled;
+}
+
+const uint64_t CommonStats::Get_Peak_Memory_Bytes() const {
+    return peak_resident_set_bytes;
+}
+
+const int CommonStats::Get_Warmup_Iterations() const {
+    return warmup_iterations;
+}
+
+const bool CommonStats::Get_Flush_Caches_Between_Iterations() const {
+    return flush_caches_between_iterations;
+}
+
+const std::vector<IterationSample>& CommonStats::Get_Iteration_Samples() const {
+    return iteration_samples_vec;
+}
+
 // setters
 void CommonStats::Set_Number_Of_Iterations(const int& number_of_iterations) {
     this->number_of_iterations = number_of_iterations;
 }
+
+void CommonStats::Set_Warmup_Iterations(const int& warmup_iterations) {
+    this->warmup_iterations = warmup_iterations;
+}
+
+void CommonStats::Set_Flush_Caches_Between_Iterations(const bool& flush_caches_between_iterations) {
+    this->flush_caches_between_iterations = flush_caches_between_iterations;
+}
+
+void CommonStats::Set_Data_Type_Size(const int& data_type_byte_size) {
+    this->data_type_byte_size = static_cast<int8_t>(data_type_byte_size);
+}
+
+void CommonStats::Set_Rows_Per_Timing_Sample(const uint32_t& rows_per_timing_sample) {
+    this->rows_per_timing_sample = std::clamp<uint32_t>(rows_per_timing_sample, 1, MAX_ROWS_PER_TIMING_SAMPLE);
+}
+
+void CommonStats::Set_Perf_Counters_Enabled(const bool& perf_counters_enabled) {
+    this->perf_counters_enabled = perf_counters_enabled;
+}
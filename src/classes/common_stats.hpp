@@ -1,11 +1,27 @@
 #pragma once
+#include "latency_histogram.hpp"
+#include "timing_clock.hpp"
+#include "perf_counters.hpp"
+#include "memory_tracking.hpp"
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include <unordered_map>
 #include <array>
+#include <atomic>
+#include <memory>
 #include <filesystem>
 
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+#define NUMBER_OF_STATS_SHARDS 64
+// a pending latency batch is one word, rows above PENDING_BATCH_ROWS_SHIFT and nanoseconds below
+#define PENDING_BATCH_ROWS_SHIFT 40
+#define PENDING_BATCH_NANOSECONDS_MASK ((uint64_t{1} << PENDING_BATCH_ROWS_SHIFT) - 1)
+#define MAX_ROWS_PER_TIMING_SAMPLE ((uint32_t{1} << (64 - PENDING_BATCH_ROWS_SHIFT)) - 1)
+
 enum class Side {
     s0,
     s1,
@@ -16,6 +32,56 @@ enum class Side {
     NUMBER_SIDES
 };
 
+// running totals for one thread, padded to its own cache line so concurrent timers never share a line
+struct alignas(CACHE_LINE_SIZE) StatsShard {
+    std::atomic<uint64_t> time_encoded_in_nanoseconds{0};
+    std::atomic<uint64_t> time_decoded_in_nanoseconds{0};
+    std::atomic<uint64_t> original_file_size{0};
+    std::atomic<uint64_t> compressed_file_size{0};
+    std::atomic<double> compression_ratio{0.0};
+    // rows timed since the last histogram sample, see Set_Rows_Per_Timing_Sample. rows and their nanoseconds
+    // share a word, so threads that end up on the same shard never split a batch between them
+    std::atomic<uint64_t> pending_encode_batch{0};
+    std::atomic<uint64_t> pending_decode_batch{0};
+    // timed calls and the heap traffic inside them (allocations stay 0 without GEOBIN_COUNT_ALLOCATIONS)
+    std::atomic<uint64_t> encode_calls{0};
+    std::atomic<uint64_t> encode_allocations{0};
+    std::atomic<uint64_t> encode_allocated_bytes{0};
+    std::atomic<uint64_t> decode_calls{0};
+    std::atomic<uint64_t> decode_allocations{0};
+    std::atomic<uint64_t> decode_allocated_bytes{0};
+    // hardware counter deltas around the timed calls, only touched when perf counters are enabled
+    std::array<std::atomic<uint64_t>, NUMBER_OF_PERF_COUNTERS> encode_perf_counts_arr{};
+    std::array<std::atomic<uint64_t>, NUMBER_OF_PERF_COUNTERS> decode_perf_counts_arr{};
+    // per row latencies in nanoseconds, allocated on first use
+    std::atomic<LatencyHistogram*> encode_latency_histogram{nullptr};
+    std::atomic<LatencyHistogram*> decode_latency_histogram{nullptr};
+
+    ~StatsShard() {
+        delete encode_latency_histogram.load();
+        delete decode_latency_histogram.load();
+    }
+};
+
+// one measured pass, the files of a directory are summed into the same iteration
+struct IterationSample {
+    double encoded_microseconds = 0.0;
+    double decoded_microseconds = 0.0;
+    uint64_t original_bytes = 0;
+    uint64_t compressed_bytes = 0;
+};
+
+// threads are handed a shard round robin the first time they record a stat
+inline size_t Get_Thread_Stats_Shard_Index() {
+    static std::atomic<size_t> next_shard_index{0};
+    thread_local const size_t shard_index = next_shard_index.fetch_add(1, std::memory_order_relaxed) % NUMBER_OF_STATS_SHARDS;
+    return shard_index;
+}
+
+// the Compute_* recorders may be called from any number of threads on the same object,
+// the shards are folded into the averages by Calculate_Cumulative_Average_Stats_For_Directory.
+// folding (that, Reset_Stats, End_Measured_Iteration and the Compute_*_Throughput calls) reads the shards
+// without stopping the recorders, so it must only run once every thread recording into this object has joined
 class CommonStats {
         public:
         //default constructor
@@ -24,35 +90,66 @@ class CommonStats {
         CommonStats(const CommonStats& other);
         //copy assignment operator
         CommonStats& operator=(const CommonStats& other);
-        //move constructor
+        //move constructor, takes other's shards, so other can only be assigned to or destroyed afterwards
         CommonStats(CommonStats&& other);
 
         void Reset_Stats();
+        // adds other's running totals into this one, used to fold per-thread stats together
+        void Merge_Stats(const CommonStats& other);
         void Write_Stats_To_File(const std::filesystem::path& file_path, const char* compression_type, const std::string& directory_compressed) const;
         void Is_Little_Endian();
 
         void Calculate_Cumulative_Average_Stats_For_Directory(const int& number_of_files);
 
+        // counters are read outside the timed region so the read syscall does not show up in the latency
         template <typename EncodeFunction>
         void Compute_Time_Encoded(EncodeFunction encode) {
-            auto start = std::chrono::high_resolution_clock::now(); // Start timing before calling the function
+            PerfReading start_reading;
+            const bool counting = perf_counters_enabled && Get_Thread_Perf_Counter_Group().Read(start_reading);
+            const AllocationCounts start_allocations = Get_Thread_Allocation_Counts();
+            const uint64_t start_ticks = Read_Timer_Ticks(); // Start timing before calling the function
             encode();
-            auto end = std::chrono::high_resolution_clock::now();
-            std::chrono::microseconds duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            average_time_encoded_in_microseconds += static_cast<double>(duration.count());
+            const uint64_t end_ticks = Read_Timer_Ticks();
+            Record_Time_Encoded(end_ticks - start_ticks, Get_Thread_Allocations_Since(start_allocations));
+            if(counting) {
+                Record_Perf_Counts(start_reading, Get_Thread_Stats_Shard().encode_perf_counts_arr);
+            }
         }
 
         template <typename DecodeFunction>
         void Compute_Time_Decoded(DecodeFunction decode) {
-            auto start = std::chrono::high_resolution_clock::now();
+            PerfReading start_reading;
+            const bool counting = perf_counters_enabled && Get_Thread_Perf_Counter_Group().Read(start_reading);
+            const AllocationCounts start_allocations = Get_Thread_Allocation_Counts();
+            const uint64_t start_ticks = Read_Timer_Ticks();
             decode();
-            auto end = std::chrono::high_resolution_clock::now();
-            std::chrono::microseconds duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-            average_time_decoded_in_microseconds += static_cast<double>(duration.count());
+            const uint64_t end_ticks = Read_Timer_Ticks();
+            Record_Time_Decoded(end_ticks - start_ticks, Get_Thread_Allocations_Since(start_allocations));
+            if(counting) {
+                Record_Perf_Counts(start_reading, Get_Thread_Stats_Shard().decode_perf_counts_arr);
+            }
+        }
+
+        // warm-up for drivers whose codecs time themselves: runs warm_up Get_Warmup_Iterations() times and drops whatever
+        // it recorded, what was recorded before is kept. same contract as folding, see the class comment
+        template <typename WarmupFunction>
+        void Run_Warmup_Iterations(WarmupFunction warm_up) {
+            if(warmup_iterations <= 0) {
+                return;
+            }
+            Fold_Stats_Shards();
+            for(int iteration = 0; iteration < warmup_iterations; iteration++) {
+                warm_up();
+            }
+            Clear_Stats_Shards();
         }
 
         void Compute_Compression_Ratio(const std::filesystem::path& original_file_path, const std::filesystem::path& compressed_file_path);
+        void Compute_Compression_Ratio(const uint64_t& original_bytes, const uint64_t& compressed_bytes);
         void Compute_Compressed_File_Size(const std::filesystem::path& file_path);
+        void Compute_Compressed_File_Size(const uint64_t& compressed_bytes);
+        // everything timed since the previous call is credited to measured iteration number iteration
+        void End_Measured_Iteration(const int& iteration, const uint64_t& original_bytes, const uint64_t& compressed_bytes);
         void Compute_Encoded_Throughput();
         void Compute_Decoded_Throughput();
         void Set_Data_Type_Size_And_Side_Resolutions(const std::filesystem::path& geometa_path);
@@ -62,12 +159,45 @@ class CommonStats {
         //getters
         const int64_t Get_Side_Resolution(const uint8_t& lod_number) const;
         const int Get_Data_Type_Size() const;
+        // the geometa storage_type names a float type ("float32"). only generated corpora write storage_type, so false
+        // means unknown rather than integer, a 4 byte layer without it may still hold floats
+        const bool Get_Floating_Point_Samples() const;
+        const std::array<std::array<uint16_t,4>, static_cast<size_t>(Side::NUMBER_SIDES)>& Get_Side_Resolutions() const;
         const int Get_Number_Of_Iterations() const;
+        const LatencyHistogram& Get_Encode_Latency_Histogram() const;
+        const LatencyHistogram& Get_Decode_Latency_Histogram() const;
+        const uint32_t Get_Rows_Per_Timing_Sample() const;
+        const bool Get_Perf_Counters_Enabled() const;
+        const uint64_t Get_Peak_Memory_Bytes() const;
+        const int Get_Warmup_Iterations() const;
+        const bool Get_Flush_Caches_Between_Iterations() const;
+        const std::vector<IterationSample>& Get_Iteration_Samples() const;
 
         //setters
+        // measured iterations, warm-up iterations run first and are never timed
         void Set_Number_Of_Iterations(const int& number_of_iterations);
+        void Set_Warmup_Iterations(const int& warmup_iterations);
+        // off unless GEOBIN_FLUSH_CACHES is set in the environment
+        void Set_Flush_Caches_Between_Iterations(const bool& flush_caches_between_iterations);
+        void Set_Data_Type_Size(const int& data_type_byte_size);
+        // sums are always per call, the latency histogram gets one sample (the mean) per rows_per_timing_sample calls
+        void Set_Rows_Per_Timing_Sample(const uint32_t& rows_per_timing_sample);
+        // off unless GEOBIN_PERF_COUNTERS is set in the environment, costs a read syscall per timed call
+        void Set_Perf_Counters_Enabled(const bool& perf_counters_enabled);
 
     private:
+        StatsShard& Get_Thread_Stats_Shard() {return (*stats_shards_arr)[Get_Thread_Stats_Shard_Index()];}
+        // moves every shard's totals into the averages below and zeroes the shards, see the class comment
+        void Fold_Stats_Shards();
+        void Copy_Stats_Shards(const CommonStats& other);
+        // zeroes the shards without folding them
+        void Clear_Stats_Shards();
+        // everything but the shards
+        void Copy_Folded_Stats(const CommonStats& other);
+        void Record_Time_Encoded(const uint64_t& elapsed_ticks, const AllocationCounts& allocations);
+        void Record_Time_Decoded(const uint64_t& elapsed_ticks, const AllocationCounts& allocations);
+        void Record_Perf_Counts(const PerfReading& start_reading, std::array<std::atomic<uint64_t>, NUMBER_OF_PERF_COUNTERS>& shard_counts_arr);
+
         //member variables
         double average_original_file_size = 0.0;
         double average_compressed_file_size = 0.0;
@@ -77,10 +207,36 @@ class CommonStats {
         double average_encoded_throughput = 0.0;
         double average_decoded_throughput = 0.0;
         int8_t data_type_byte_size = 0;
+        bool floating_point_samples = false;
         int number_of_iterations = 0;
+        int warmup_iterations = 0;
+        bool flush_caches_between_iterations = false;
+        uint32_t rows_per_timing_sample = 1;
+        bool perf_counters_enabled = false;
         bool little_endian_flag = false;
 
-        std::array<std::array<uint16_t,4>, static_cast<size_t>(Side::NUMBER_SIDES)> side_resolutions;
+        std::array<std::array<uint16_t,4>, static_cast<size_t>(Side::NUMBER_SIDES)> side_resolutions{};
+        // on the heap so moves only hand the pointer over and the object itself stays small
+        std::unique_ptr<std::array<StatsShard, NUMBER_OF_STATS_SHARDS>> stats_shards_arr = std::make_unique<std::array<StatsShard, NUMBER_OF_STATS_SHARDS>>();
+        // folded from the shards like the averages, but never divided, so tails survive
+        LatencyHistogram encode_latency_histogram;
+        LatencyHistogram decode_latency_histogram;
+        PerfCounts encode_perf_counts_arr{};
+        PerfCounts decode_perf_counts_arr{};
+        // original bytes of every measured iteration, what the perf counts are taken per
+        uint64_t total_original_bytes = 0;
+        uint64_t encode_calls = 0;
+        uint64_t encode_allocations = 0;
+        uint64_t encode_allocated_bytes = 0;
+        uint64_t decode_calls = 0;
+        uint64_t decode_allocations = 0;
+        uint64_t decode_allocated_bytes = 0;
+        // process wide high-water mark seen at the last fold, Reset_Stats restarts it
+        uint64_t peak_resident_set_bytes = 0;
+        std::vector<IterationSample> iteration_samples_vec;
+        // folded time totals at the last End_Measured_Iteration
+        double iteration_mark_encoded_microseconds = 0.0;
+        double iteration_mark_decoded_microseconds = 0.0;
 
 
         //create a look up table full of data_type and their corresponding size
@@ -0,0 +1,522 @@
+#include "context_model_codec.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define CONTEXT_MODEL_FILE_MAGIC "GBCM"
+#define CONTEXT_MODEL_FILE_VERSION 1
+#define CONTEXT_MODEL_FLAG_MIXING 0x01
+// weight step is stretch * error >> this
+#define CONTEXT_MODEL_MIXER_SHIFT 10
+
+
+template <typename T>
+static void Write_Value(std::ostream& output_stream, const T& value) {
+    output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T Read_Value(std::istream& input_stream) {
+    T value{};
+    input_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+// logistic function over the stretch domain -2047..2047 (8 units per 256), 12 bit probability out
+static const int Squash(const int& stretched) {
+    static const int squash_arr[33] = {1, 2, 3, 6, 10, 16, 27, 45, 73, 120, 194, 310, 488, 747, 1101, 1546, 2047,
+                                       2549, 2994, 3348, 3607, 3785, 3901, 3975, 4022, 4050, 4068, 4079, 4085, 4089, 4092, 4093, 4094};
+    if(stretched > 2047) {
+        return 4095;
+    }
+    if(stretched < -2047) {
+        return 1;
+    }
+    const int weight = stretched & 127;
+    const int index = (stretched >> 7) + 16;
+    return (squash_arr[index] * (128 - weight) + squash_arr[index + 1] * weight + 64) >> 7;
+}
+
+// inverse of Squash
+static const int Stretch(const int& probability) {
+    static const std::array<int16_t, 4096> stretch_arr = [](){
+        std::array<int16_t, 4096> table{};
+        int previous = 0;
+        for(int stretched = -2047; stretched <= 2047; stretched++) {
+            const int value = Squash(stretched);
+            for(int i = previous; i <= value; i++) {
+                table[i] = static_cast<int16_t>(stretched);
+            }
+            previous = value + 1;
+        }
+        for(int i = previous; i < 4096; i++) {
+            table[i] = 2047;
+        }
+        return table;
+    }();
+    return stretch_arr[probability];
+}
+
+static inline const uint32_t Get_Magnitude_Bucket(const uint32_t& byte) {
+    if(byte < 4) {
+        return byte;
+    }
+    if(byte < 8) {
+        return 4 + ((byte >> 1) & 1);
+    }
+    if(byte < 16) {
+        return 6 + ((byte >> 2) & 1);
+    }
+    return 3 + static_cast<uint32_t>(std::bit_width(byte));
+}
+
+static inline void Update_Probability(uint16_t& probability, const uint32_t& bit) {
+    if(bit) {
+        probability += (65535 - probability) >> CONTEXT_MODEL_ADAPTATION_SHIFT;
+    } else {
+        probability -= probability >> CONTEXT_MODEL_ADAPTATION_SHIFT;
+    }
+}
+
+static inline const int Clamp_Probability(const int& probability) {
+    return std::clamp(probability, 1, 4095);
+}
+
+// carryless binary arithmetic coder over 32 bit bounds, 12 bit probability of a one
+class BinaryArithmeticEncoder {
+    public:
+        explicit BinaryArithmeticEncoder(std::vector<char>& output_vec) : output_vec(output_vec) {}
+
+        const uint32_t Code(const uint32_t& bit, const int& probability) {
+            const uint32_t middle = low + static_cast<uint32_t>((static_cast<uint64_t>(high - low) * probability) >> 12);
+            if(bit) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+            while(((low ^ high) & 0xFF000000) == 0) {
+                output_vec.push_back(static_cast<char>(high >> 24));
+                low <<= 8;
+                high = (high << 8) | 0xFF;
+            }
+            return bit;
+        }
+
+        void Flush() {
+            for(int i = 0; i < 4; i++) {
+                output_vec.push_back(static_cast<char>(low >> 24));
+                low <<= 8;
+            }
+        }
+
+    private:
+        std::vector<char>& output_vec;
+        uint32_t low = 0;
+        uint32_t high = 0xFFFFFFFF;
+};
+
+class BinaryArithmeticDecoder {
+    public:
+        BinaryArithmeticDecoder(const char* encoded_data, const uint64_t& encoded_bytes) : encoded_data(encoded_data), encoded_bytes(encoded_bytes) {
+            for(int i = 0; i < 4; i++) {
+                code = (code << 8) | Next_Byte();
+            }
+        }
+
+        // the bit argument is only there so the model can drive either coder
+        const uint32_t Code(const uint32_t&, const int& probability) {
+            const uint32_t middle = low + static_cast<uint32_t>((static_cast<uint64_t>(high - low) * probability) >> 12);
+            const uint32_t bit = (code <= middle) ? 1 : 0;
+            if(bit) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+            while(((low ^ high) & 0xFF000000) == 0) {
+                low <<= 8;
+                high = (high << 8) | 0xFF;
+                code = (code << 8) | Next_Byte();
+            }
+            return bit;
+        }
+
+    private:
+        const uint32_t Next_Byte() {
+            return (position < encoded_bytes) ? static_cast<uint8_t>(encoded_data[position++]) : 0;
+        }
+
+        const char* encoded_data;
+        uint64_t encoded_bytes = 0;
+        uint64_t position = 0;
+        uint32_t low = 0;
+        uint32_t high = 0xFFFFFFFF;
+        uint32_t code = 0;
+};
+
+
+// ContextModel
+ContextModel::ContextModel(const bool& mixing) : mixing(mixing) {}
+
+void ContextModel::Reset(const uint8_t& data_type_size, const uint64_t& samples_per_row) {
+    if(data_type_size != 1 && data_type_size != 2 && data_type_size != 4) {
+        ERROR_MSG_AND_EXIT("Error: Invalid data type size.");
+    }
+    if(data_type_size != this->data_type_size || order0_epoch_vec.empty()) {
+        this->data_type_size = data_type_size;
+        const uint32_t order0_slots = data_type_size * 2;
+        const uint32_t order1_slots = order0_slots * 256;
+        const uint32_t order2_slots = order0_slots * CONTEXT_MODEL_BUCKETS * CONTEXT_MODEL_BUCKETS;
+        order0_probability_vec.resize(size_t{order0_slots} * 256);
+        order1_probability_vec.resize(size_t{order1_slots} * 256);
+        order2_probability_vec.resize(size_t{order2_slots} * 256);
+        order0_epoch_vec.assign(order0_slots, 0);
+        order1_epoch_vec.assign(order1_slots, 0);
+        order2_epoch_vec.assign(order2_slots, 0);
+        epoch = 0;
+    }
+    // on wrap around every slot is made stale by hand
+    if(++epoch == 0) {
+        std::fill(order0_epoch_vec.begin(), order0_epoch_vec.end(), 0);
+        std::fill(order1_epoch_vec.begin(), order1_epoch_vec.end(), 0);
+        std::fill(order2_epoch_vec.begin(), order2_epoch_vec.end(), 0);
+        epoch = 1;
+    }
+    mixer_weights_vec.assign(size_t{data_type_size} * 2, {21845, 21845, 21845});
+
+    this->samples_per_row = std::max<uint64_t>(samples_per_row, 1);
+    upper_sample_vec.assign(this->samples_per_row, 0);
+    current_sample_vec.assign(this->samples_per_row, 0);
+    upper_residual_vec.assign(this->samples_per_row, 0);
+}
+
+void ContextModel::Prepare_Slot(std::vector<uint16_t>& probability_vec, std::vector<uint32_t>& epoch_vec, const uint32_t& slot) {
+    if(epoch_vec[slot] != epoch) {
+        std::fill_n(probability_vec.begin() + size_t{slot} * 256, 256, uint16_t{32768});
+        epoch_vec[slot] = epoch;
+    }
+}
+
+// MED on the signed samples: the smaller neighbour above an edge, the larger below one, the plane through them otherwise
+const uint32_t ContextModel::Get_Prediction(const uint64_t& x, const bool& has_upper) const {
+    const int shift = 32 - 8 * data_type_size;
+    auto to_signed = [shift](const uint32_t& sample) {return static_cast<int64_t>(static_cast<int32_t>(sample << shift) >> shift);};
+    if(!has_upper) {
+        return (x == 0) ? 0 : current_sample_vec[x - 1];
+    }
+    if(x == 0) {
+        return upper_sample_vec[0];
+    }
+    const int64_t left = to_signed(current_sample_vec[x - 1]);
+    const int64_t upper = to_signed(upper_sample_vec[x]);
+    const int64_t upper_left = to_signed(upper_sample_vec[x - 1]);
+    int64_t prediction = left + upper - upper_left;
+    if(upper_left >= std::max(left, upper)) {
+        prediction = std::min(left, upper);
+    } else if(upper_left <= std::min(left, upper)) {
+        prediction = std::max(left, upper);
+    }
+    return static_cast<uint32_t>(prediction);
+}
+
+template <typename BitCoder>
+const uint32_t ContextModel::Code_Residual(BitCoder& coder, const uint32_t& residual, const uint32_t& left_residual, const uint32_t& upper_residual, const bool& has_upper) {
+    uint32_t coded_residual = 0;
+    uint32_t higher_bytes_zero = 1;
+    for(int plane = data_type_size - 1; plane >= 0; plane--) {
+        const uint32_t left_byte = (left_residual >> (8 * plane)) & 0xFF;
+        const uint32_t upper_byte = (upper_residual >> (8 * plane)) & 0xFF;
+        const uint32_t order0_slot = static_cast<uint32_t>(plane) * 2 + higher_bytes_zero;
+        const uint32_t order1_slot = order0_slot * 256 + left_byte;
+        const uint32_t order2_slot = (order0_slot * CONTEXT_MODEL_BUCKETS + Get_Magnitude_Bucket(left_byte)) * CONTEXT_MODEL_BUCKETS + Get_Magnitude_Bucket(upper_byte);
+        Prepare_Slot(order0_probability_vec, order0_epoch_vec, order0_slot);
+        Prepare_Slot(order1_probability_vec, order1_epoch_vec, order1_slot);
+        Prepare_Slot(order2_probability_vec, order2_epoch_vec, order2_slot);
+        uint16_t* order0_probabilities = &order0_probability_vec[size_t{order0_slot} * 256];
+        uint16_t* order1_probabilities = &order1_probability_vec[size_t{order1_slot} * 256];
+        uint16_t* order2_probabilities = &order2_probability_vec[size_t{order2_slot} * 256];
+        std::array<int32_t, CONTEXT_MODEL_MIXER_INPUTS>& weights_arr = mixer_weights_vec[order0_slot];
+
+        const uint32_t byte = (residual >> (8 * plane)) & 0xFF;
+        uint32_t node = 1;
+        for(int bit_index = 7; bit_index >= 0; bit_index--) {
+            int probability;
+            std::array<int32_t, CONTEXT_MODEL_MIXER_INPUTS> stretched_arr;
+            if(mixing) {
+                stretched_arr = {Stretch(order0_probabilities[node] >> 4), Stretch(order1_probabilities[node] >> 4), Stretch(order2_probabilities[node] >> 4)};
+                int64_t dot_product = 0;
+                for(int input = 0; input < CONTEXT_MODEL_MIXER_INPUTS; input++) {
+                    dot_product += static_cast<int64_t>(weights_arr[input]) * stretched_arr[input];
+                }
+                probability = Clamp_Probability(Squash(static_cast<int>(dot_product >> 16)));
+            } else {
+                probability = Clamp_Probability((has_upper ? order2_probabilities[node] : order1_probabilities[node]) >> 4);
+            }
+
+            const uint32_t bit = coder.Code((byte >> bit_index) & 1, probability);
+
+            Update_Probability(order0_probabilities[node], bit);
+            Update_Probability(order1_probabilities[node], bit);
+            Update_Probability(order2_probabilities[node], bit);
+            if(mixing) {
+                const int32_t error = (static_cast<int32_t>(bit) << 12) - probability;
+                for(int input = 0; input < CONTEXT_MODEL_MIXER_INPUTS; input++) {
+                    weights_arr[input] += (stretched_arr[input] * error) >> CONTEXT_MODEL_MIXER_SHIFT;
+                }
+            }
+            node = node * 2 + bit;
+        }
+        const uint32_t coded_byte = node & 0xFF;
+        coded_residual |= coded_byte << (8 * plane);
+        higher_bytes_zero = (higher_bytes_zero && coded_byte == 0) ? 1 : 0;
+    }
+    return coded_residual;
+}
+
+void ContextModel::Encode_Samples(const char* data, const uint64_t& number_of_samples, std::vector<char>& output_vec) {
+    const uint32_t sample_mask = (data_type_size == 4) ? 0xFFFFFFFF : ((uint32_t{1} << (8 * data_type_size)) - 1);
+    const int sign_shift = 8 * data_type_size - 1;
+    BinaryArithmeticEncoder encoder(output_vec);
+
+    uint64_t x = 0;
+    bool has_upper = false;
+    uint32_t left_residual = 0;
+    for(uint64_t i = 0; i < number_of_samples; i++) {
+        uint32_t sample = 0;
+        std::memcpy(&sample, data + i * data_type_size, data_type_size);
+        // zigzag of the wrapped difference, so small misses either way leave the high bytes zero
+        const uint32_t difference = (sample - Get_Prediction(x, has_upper)) & sample_mask;
+        const uint32_t sign = (difference >> sign_shift) & 1;
+        const uint32_t residual = ((difference << 1) ^ (0u - sign)) & sample_mask;
+
+        Code_Residual(encoder, residual, left_residual, has_upper ? upper_residual_vec[x] : 0, has_upper);
+
+        current_sample_vec[x] = sample;
+        upper_residual_vec[x] = residual;
+        left_residual = residual;
+        if(++x == samples_per_row) {
+            x = 0;
+            has_upper = true;
+            left_residual = 0;
+            upper_sample_vec.swap(current_sample_vec);
+        }
+    }
+    encoder.Flush();
+}
+
+void ContextModel::Decode_Samples(const char* encoded_data, const uint64_t& encoded_bytes, const uint64_t& number_of_samples, char* data) {
+    const uint32_t sample_mask = (data_type_size == 4) ? 0xFFFFFFFF : ((uint32_t{1} << (8 * data_type_size)) - 1);
+    BinaryArithmeticDecoder decoder(encoded_data, encoded_bytes);
+
+    uint64_t x = 0;
+    bool has_upper = false;
+    uint32_t left_residual = 0;
+    for(uint64_t i = 0; i < number_of_samples; i++) {
+        const uint32_t residual = Code_Residual(decoder, 0, left_residual, has_upper ? upper_residual_vec[x] : 0, has_upper);
+        const uint32_t difference = ((residual >> 1) ^ (0u - (residual & 1))) & sample_mask;
+        const uint32_t sample = (Get_Prediction(x, has_upper) + difference) & sample_mask;
+        std::memcpy(data + i * data_type_size, &sample, data_type_size);
+
+        current_sample_vec[x] = sample;
+        upper_residual_vec[x] = residual;
+        left_residual = residual;
+        if(++x == samples_per_row) {
+            x = 0;
+            has_upper = true;
+            left_residual = 0;
+            upper_sample_vec.swap(current_sample_vec);
+        }
+    }
+}
+
+//getters
+const bool ContextModel::Get_Mixing() const {return mixing;}
+
+
+// ContextModelCodec
+ContextModelCodec::ContextModelCodec(const bool& mixing, const int& number_of_threads, const uint64_t& tile_rows)
+    : mixing(mixing), number_of_threads(number_of_threads), tile_rows(std::max<uint64_t>(tile_rows, 1)) {
+    if(this->number_of_threads <= 0) {
+        if(const char* cm_threads = std::getenv("GEOBIN_CM_THREADS")) {
+            this->number_of_threads = std::atoi(cm_threads);
+        }
+    }
+    if(this->number_of_threads <= 0) {
+        this->number_of_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    this->number_of_threads = std::min(this->number_of_threads, MAX_CONTEXT_MODEL_THREADS);
+    for(int thread = 0; thread < this->number_of_threads; thread++) {
+        tile_models_vec.push_back(std::make_unique<ContextModel>(mixing));
+    }
+    tile_input_vecs.resize(2 * this->number_of_threads);
+    tile_output_vecs.resize(2 * this->number_of_threads);
+}
+
+void ContextModelCodec::Run_Tiles(const uint64_t& number_of_tiles, const std::function<void(ContextModel&, const uint64_t&)>& code_tile) {
+    std::atomic<uint64_t> next_tile{0};
+    auto code_tiles = [&](ContextModel& model) {
+        for(uint64_t tile = next_tile++; tile < number_of_tiles; tile = next_tile++) {
+            code_tile(model, tile);
+        }
+    };
+
+    const int threads_to_start = static_cast<int>(std::min<uint64_t>(number_of_threads, number_of_tiles));
+    std::vector<std::thread> thread_vec;
+    for(int thread = 1; thread < threads_to_start; thread++) {
+        thread_vec.emplace_back(code_tiles, std::ref(*tile_models_vec[thread]));
+    }
+    code_tiles(*tile_models_vec[0]);
+    for(auto& thread : thread_vec) {
+        thread.join();
+    }
+}
+
+void ContextModelCodec::Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row) {
+    const int data_type_size = std::max(1, this->Get_Data_Type_Size());
+    const uint64_t bytes_per_row = samples_per_row * data_type_size;
+    if(bytes_per_row == 0) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: no samples per row for "} + input_path.string());
+    }
+    const uint64_t original_bytes = Get_File_Size_Bytes(input_path);
+    const uint64_t tile_bytes = tile_rows * bytes_per_row;
+    const uint64_t number_of_tiles = (original_bytes + tile_bytes - 1) / tile_bytes;
+
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    output_file.write(CONTEXT_MODEL_FILE_MAGIC, 4);
+    Write_Value<uint8_t>(output_file, CONTEXT_MODEL_FILE_VERSION);
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(data_type_size));
+    Write_Value<uint8_t>(output_file, mixing ? CONTEXT_MODEL_FLAG_MIXING : 0);
+    Write_Value<uint64_t>(output_file, samples_per_row);
+    Write_Value<uint64_t>(output_file, original_bytes);
+    Write_Value<uint64_t>(output_file, tile_rows);
+    Write_Value<uint64_t>(output_file, number_of_tiles);
+    // the tile sizes are only known once every tile is coded, they are filled in at the end
+    const std::streampos tile_table_position = output_file.tellp();
+    std::vector<uint64_t> encoded_tile_bytes_vec(number_of_tiles, 0);
+    output_file.write(reinterpret_cast<const char*>(encoded_tile_bytes_vec.data()), number_of_tiles * sizeof(uint64_t));
+
+    const uint64_t batch_tiles = tile_input_vecs.size();
+    for(uint64_t first_tile = 0; first_tile < number_of_tiles; first_tile += batch_tiles) {
+        const uint64_t tiles_in_batch = std::min(batch_tiles, number_of_tiles - first_tile);
+        for(uint64_t tile = 0; tile < tiles_in_batch; tile++) {
+            tile_input_vecs[tile].resize(tile_bytes);
+            input_file.read(tile_input_vecs[tile].data(), tile_bytes);
+            tile_input_vecs[tile].resize(input_file.gcount());
+        }
+
+        this->Compute_Time_Encoded([&](){
+            Run_Tiles(tiles_in_batch, [&](ContextModel& model, const uint64_t& tile){
+                const std::vector<char>& tile_vec = tile_input_vecs[tile];
+                std::vector<char>& encoded_vec = tile_output_vecs[tile];
+                // a trailing partial sample can only be in the last tile, it goes in front of the coded stream as is
+                const uint64_t number_of_samples = tile_vec.size() / data_type_size;
+                encoded_vec.assign(tile_vec.begin() + number_of_samples * data_type_size, tile_vec.end());
+                model.Reset(static_cast<uint8_t>(data_type_size), samples_per_row);
+                model.Encode_Samples(tile_vec.data(), number_of_samples, encoded_vec);
+            });
+        });
+
+        for(uint64_t tile = 0; tile < tiles_in_batch; tile++) {
+            output_file.write(tile_output_vecs[tile].data(), tile_output_vecs[tile].size());
+            encoded_tile_bytes_vec[first_tile + tile] = tile_output_vecs[tile].size();
+        }
+    }
+
+    output_file.seekp(tile_table_position);
+    output_file.write(reinterpret_cast<const char*>(encoded_tile_bytes_vec.data()), number_of_tiles * sizeof(uint64_t));
+    if(!output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to write "} + output_path.string());
+    }
+}
+
+void ContextModelCodec::Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path) {
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    char magic[4] = {0};
+    input_file.read(magic, 4);
+    const uint8_t version = Read_Value<uint8_t>(input_file);
+    if(std::memcmp(magic, CONTEXT_MODEL_FILE_MAGIC, 4) != 0 || version != CONTEXT_MODEL_FILE_VERSION) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is not a context model encoded file"});
+    }
+    const uint8_t data_type_size = Read_Value<uint8_t>(input_file);
+    const uint8_t flags = Read_Value<uint8_t>(input_file);
+    const uint64_t samples_per_row = Read_Value<uint64_t>(input_file);
+    const uint64_t original_bytes = Read_Value<uint64_t>(input_file);
+    const uint64_t file_tile_rows = Read_Value<uint64_t>(input_file);
+    const uint64_t number_of_tiles = Read_Value<uint64_t>(input_file);
+    if(((flags & CONTEXT_MODEL_FLAG_MIXING) != 0) != mixing) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" was not encoded with "} + std::string{Get_Compression_Type()});
+    }
+    std::vector<uint64_t> encoded_tile_bytes_vec(number_of_tiles);
+    input_file.read(reinterpret_cast<char*>(encoded_tile_bytes_vec.data()), number_of_tiles * sizeof(uint64_t));
+    if(!input_file) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+    }
+
+    const uint64_t tile_bytes = file_tile_rows * samples_per_row * data_type_size;
+    const uint64_t batch_tiles = tile_input_vecs.size();
+    for(uint64_t first_tile = 0; first_tile < number_of_tiles; first_tile += batch_tiles) {
+        const uint64_t tiles_in_batch = std::min(batch_tiles, number_of_tiles - first_tile);
+        for(uint64_t tile = 0; tile < tiles_in_batch; tile++) {
+            tile_input_vecs[tile].resize(encoded_tile_bytes_vec[first_tile + tile]);
+            input_file.read(tile_input_vecs[tile].data(), tile_input_vecs[tile].size());
+            tile_output_vecs[tile].resize(std::min(tile_bytes, original_bytes - (first_tile + tile) * tile_bytes));
+        }
+        if(!input_file) {
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+        }
+
+        this->Compute_Time_Decoded([&](){
+            Run_Tiles(tiles_in_batch, [&](ContextModel& model, const uint64_t& tile){
+                const std::vector<char>& encoded_vec = tile_input_vecs[tile];
+                std::vector<char>& tile_vec = tile_output_vecs[tile];
+                const uint64_t number_of_samples = tile_vec.size() / data_type_size;
+                const uint64_t tail_bytes = tile_vec.size() - number_of_samples * data_type_size;
+                std::memcpy(tile_vec.data() + number_of_samples * data_type_size, encoded_vec.data(), std::min<uint64_t>(tail_bytes, encoded_vec.size()));
+                model.Reset(data_type_size, samples_per_row);
+                model.Decode_Samples(encoded_vec.data() + tail_bytes, encoded_vec.size() - std::min<uint64_t>(tail_bytes, encoded_vec.size()), number_of_samples, tile_vec.data());
+            });
+        });
+
+        for(uint64_t tile = 0; tile < tiles_in_batch; tile++) {
+            output_file.write(tile_output_vecs[tile].data(), tile_output_vecs[tile].size());
+        }
+    }
+}
+
+//getters
+const char* ContextModelCodec::Get_Compression_Type() const {return mixing ? "cmx" : "cm";}
+
+const int ContextModelCodec::Get_Number_Of_Threads() const {return number_of_threads;}
+
+const uint64_t ContextModelCodec::Get_Tile_Rows() const {return tile_rows;}
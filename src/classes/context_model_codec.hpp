@@ -0,0 +1,95 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#define DEFAULT_CONTEXT_MODEL_TILE_ROWS 64
+#define MAX_CONTEXT_MODEL_THREADS 64
+// neighbour residual bytes fall into this many magnitude buckets in the order-2 context
+#define CONTEXT_MODEL_BUCKETS 12
+// probability counters move 1/16 of the way towards every coded bit
+#define CONTEXT_MODEL_ADAPTATION_SHIFT 4
+#define CONTEXT_MODEL_MIXER_INPUTS 3
+
+// adaptive binary model of one tile of samples, coded through a carryless binary arithmetic coder.
+// every sample is predicted from its left and upper neighbour (MED, like LOCO-I) and the zigzagged residual is coded
+// most significant byte first, bit by bit. the bit probabilities come from an order-1 context (the left sample's
+// residual byte) and an order-2 context (the left and upper residual bytes, bucketed by magnitude). without mixing
+// the order-2 prediction is used once there is an upper row, with mixing order 0, 1 and 2 are blended by a small
+// online logistic mixer. nothing is shared between tiles, so tiles can be coded on separate threads
+class ContextModel {
+    public:
+        // Constructors
+        explicit ContextModel(const bool& mixing);
+
+        // starts a new tile. only the context slots a tile touches are cleared, so this is cheap for small rows
+        void Reset(const uint8_t& data_type_size, const uint64_t& samples_per_row);
+        // appends the coded samples to output_vec
+        void Encode_Samples(const char* data, const uint64_t& number_of_samples, std::vector<char>& output_vec);
+        // data must hold number_of_samples * data type size bytes, a short stream decodes as if padded with zeros
+        void Decode_Samples(const char* encoded_data, const uint64_t& encoded_bytes, const uint64_t& number_of_samples, char* data);
+
+        //getters
+        const bool Get_Mixing() const;
+
+    private:
+        template <typename BitCoder>
+        const uint32_t Code_Residual(BitCoder& coder, const uint32_t& residual, const uint32_t& left_residual, const uint32_t& upper_residual, const bool& has_upper);
+        const uint32_t Get_Prediction(const uint64_t& x, const bool& has_upper) const;
+        void Prepare_Slot(std::vector<uint16_t>& probability_vec, std::vector<uint32_t>& epoch_vec, const uint32_t& slot);
+
+        bool mixing = false;
+        uint8_t data_type_size = 1;
+        uint64_t samples_per_row = 0;
+        uint32_t epoch = 0;
+        // 256 bit tree nodes per context slot, 16 bit probabilities of a one
+        std::vector<uint16_t> order0_probability_vec;
+        std::vector<uint16_t> order1_probability_vec;
+        std::vector<uint16_t> order2_probability_vec;
+        // a slot whose epoch is stale is reinitialised on first use
+        std::vector<uint32_t> order0_epoch_vec;
+        std::vector<uint32_t> order1_epoch_vec;
+        std::vector<uint32_t> order2_epoch_vec;
+        // mixer weights (16.16) per byte plane and "higher bytes were zero" flag
+        std::vector<std::array<int32_t, CONTEXT_MODEL_MIXER_INPUTS>> mixer_weights_vec;
+        // the row above (samples and residuals) and the row being coded
+        std::vector<uint32_t> upper_sample_vec;
+        std::vector<uint32_t> current_sample_vec;
+        std::vector<uint32_t> upper_residual_vec;
+};
+
+// the archival tier: whole geobins are cut into tiles of tile_rows rows, every tile is modelled from scratch
+// and the tiles of a batch are coded on number_of_threads threads.
+// file layout: "GBCM" | version u8 | data type size u8 | flags u8 | samples per row u64 | original bytes u64 |
+//              tile rows u64 | number of tiles u64 | encoded tile bytes u64 per tile | tiles...
+class ContextModelCodec : public CommonStats {
+    public:
+        // Constructors
+        // number_of_threads <= 0 reads GEOBIN_CM_THREADS, then falls back to the hardware concurrency
+        ContextModelCodec(const bool& mixing, const int& number_of_threads = 0, const uint64_t& tile_rows = DEFAULT_CONTEXT_MODEL_TILE_ROWS);
+
+        void Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row);
+        void Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path);
+
+        //getters
+        const char* Get_Compression_Type() const;
+        const int Get_Number_Of_Threads() const;
+        const uint64_t Get_Tile_Rows() const;
+
+    private:
+        // runs code_tile(model, tile in batch) for every tile of the batch, each thread with its own model
+        void Run_Tiles(const uint64_t& number_of_tiles, const std::function<void(ContextModel&, const uint64_t&)>& code_tile);
+
+        bool mixing = false;
+        int number_of_threads = 1;
+        uint64_t tile_rows = DEFAULT_CONTEXT_MODEL_TILE_ROWS;
+        std::vector<std::unique_ptr<ContextModel>> tile_models_vec;
+        // one batch of tiles in and out, a batch is twice as many tiles as threads
+        std::vector<std::vector<char>> tile_input_vecs;
+        std::vector<std::vector<char>> tile_output_vecs;
+};
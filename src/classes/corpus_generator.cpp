@@ -0,0 +1,286 @@
+#include "corpus_generator.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+// fraction of the amplitude kept per octave, 2^-0.8, rough enough to look like mountains
+#define TERRAIN_ROUGHNESS 0.5743491774985174
+// heights below this are ocean in the mask layer
+#define OCEAN_SEA_LEVEL 0.55
+// float32 terrain is stored in metres between these
+#define TERRAIN_MINIMUM_METRES -8000.0
+#define TERRAIN_MAXIMUM_METRES 8000.0
+#define MATERIAL_REGIONS 32
+#define NUMBER_OF_MATERIALS 12
+
+using json = nlohmann::json;
+
+// uniform in [0, 1), 53 bits so it is exact in a double
+static double Next_Corpus_Unit(uint64_t& random_state) {
+    return static_cast<double>(Next_Corpus_Random(random_state) >> 11) * 0x1.0p-53;
+}
+
+
+//Constructors
+CorpusGenerator::CorpusGenerator(const CorpusSpec& spec) : spec(spec) {
+    if(spec.number_of_lods < 1 || spec.number_of_lods > MAX_CORPUS_NUMBER_OF_LODS) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: corpus number of lods must be between 1 and "} + std::to_string(MAX_CORPUS_NUMBER_OF_LODS));
+    }
+    if(spec.subsets_per_side < 1 || spec.subsets_per_side > MAX_CORPUS_SUBSETS_PER_SIDE) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: corpus subsets per side must be between 1 and "} + std::to_string(MAX_CORPUS_SUBSETS_PER_SIDE));
+    }
+}
+
+std::vector<std::filesystem::path> CorpusGenerator::Generate_Corpus(const std::filesystem::path& root_path) const {
+    std::vector<std::filesystem::path> layer_path_vec;
+    for(int kind = 0; kind < static_cast<int>(CorpusLayerKind::NUMBER_KINDS); kind++) {
+        for(const int data_type_size : {1, 2, 4}) {
+            layer_path_vec.push_back(Generate_Layer(root_path / "Synthetic", static_cast<CorpusLayerKind>(kind), data_type_size));
+        }
+    }
+    return layer_path_vec;
+}
+
+std::filesystem::path CorpusGenerator::Generate_Layer(const std::filesystem::path& planet_path, const CorpusLayerKind& kind, const int& data_type_size) const {
+    const std::string layer_name = std::string{Get_Layer_Kind_Name(kind)} + std::to_string(data_type_size);
+    const std::filesystem::path layer_path = planet_path / layer_name;
+    std::filesystem::create_directories(layer_path);
+    Write_Geometa(layer_path / (layer_name + ".geometa"), kind, data_type_size);
+
+    for(int side = 0; side < 6; side++) {
+        for(int c_number = 0; c_number < spec.subsets_per_side; c_number++) {
+            const std::vector<double> field_vec = Generate_Field(kind, side, c_number);
+            for(int lod_number = 0; lod_number < spec.number_of_lods; lod_number++) {
+                const std::filesystem::path file_path = layer_path / (layer_name + "_s" + std::to_string(side) + "_c" + std::to_string(c_number) +
+                                                                      "_lod" + std::to_string(lod_number) + ".geobin");
+                const std::vector<char> tile_vec = Quantize_Field(field_vec, kind, data_type_size, lod_number);
+                std::ofstream output_file(file_path, std::ios::binary);
+                if(!output_file.write(tile_vec.data(), tile_vec.size())) {
+                    ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to write "} + file_path.string());
+                }
+            }
+        }
+    }
+#ifdef DEBUG_MODE
+    PRINT_DEBUG(std::string{"Generated corpus layer: "} + layer_path.string());
+#endif
+    return layer_path;
+}
+
+std::vector<char> CorpusGenerator::Generate_Tile(const CorpusLayerKind& kind, const int& data_type_size, const int& side, const int& c_number, const int& lod_number) const {
+    return Quantize_Field(Generate_Field(kind, side, c_number), kind, data_type_size, lod_number);
+}
+
+std::vector<double> CorpusGenerator::Generate_Field(const CorpusLayerKind& kind, const int& side, const int& c_number) const {
+    uint64_t random_state = Get_Field_Seed(kind, side, c_number);
+    const uint64_t resolution = Get_Side_Resolution(spec.number_of_lods - 1);
+
+    switch(kind) {
+        case CorpusLayerKind::terrain:
+        case CorpusLayerKind::ocean_mask:
+            return Generate_Heightfield(random_state, resolution);
+        case CorpusLayerKind::material_map:
+            return Generate_Material_Field(random_state, resolution);
+        case CorpusLayerKind::noise: {
+            std::vector<double> field_vec(resolution * resolution);
+            for(auto& value : field_vec) {
+                value = Next_Corpus_Unit(random_state);
+            }
+            return field_vec;
+        }
+        default:
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: unknown corpus layer kind"});
+    }
+}
+
+// diamond-square on the 2^n + 1 grid, which is exactly the lod side resolution
+std::vector<double> CorpusGenerator::Generate_Heightfield(uint64_t& random_state, const uint64_t& resolution) const {
+    std::vector<double> height_vec(resolution * resolution);
+    auto height = [&](const uint64_t& row, const uint64_t& column) -> double& {return height_vec[row * resolution + column];};
+    auto displacement = [&](const double& amplitude) {return (2.0 * Next_Corpus_Unit(random_state) - 1.0) * amplitude;};
+
+    const uint64_t last = resolution - 1;
+    height(0, 0) = Next_Corpus_Unit(random_state);
+    height(0, last) = Next_Corpus_Unit(random_state);
+    height(last, 0) = Next_Corpus_Unit(random_state);
+    height(last, last) = Next_Corpus_Unit(random_state);
+
+    double amplitude = 0.5;
+    for(uint64_t step = last; step > 1; step /= 2) {
+        const uint64_t half = step / 2;
+        // diamond: centre of every square
+        for(uint64_t row = half; row < resolution; row += step) {
+            for(uint64_t column = half; column < resolution; column += step) {
+                height(row, column) = (height(row - half, column - half) + height(row - half, column + half) +
+                                       height(row + half, column - half) + height(row + half, column + half)) / 4.0 + displacement(amplitude);
+            }
+        }
+        // square: midpoint of every edge, edges of the tile only have three neighbours
+        for(uint64_t row = 0; row < resolution; row += half) {
+            for(uint64_t column = ((row / half) % 2 == 0) ? half : 0; column < resolution; column += step) {
+                double sum = 0.0;
+                int neighbours = 0;
+                if(row >= half) {sum += height(row - half, column); neighbours++;}
+                if(row + half < resolution) {sum += height(row + half, column); neighbours++;}
+                if(column >= half) {sum += height(row, column - half); neighbours++;}
+                if(column + half < resolution) {sum += height(row, column + half); neighbours++;}
+                height(row, column) = sum / neighbours + displacement(amplitude);
+            }
+        }
+        amplitude *= TERRAIN_ROUGHNESS;
+    }
+
+    const auto [minimum_it, maximum_it] = std::minmax_element(height_vec.begin(), height_vec.end());
+    const double minimum = *minimum_it;
+    const double range = std::max(*maximum_it - minimum, 1e-12);
+    for(auto& value : height_vec) {
+        value = (value - minimum) / range;
+    }
+    return height_vec;
+}
+
+// voronoi regions, each given one material id, so the layer is long runs with hard edges
+std::vector<double> CorpusGenerator::Generate_Material_Field(uint64_t& random_state, const uint64_t& resolution) const {
+    std::array<double, MATERIAL_REGIONS> region_rows_arr;
+    std::array<double, MATERIAL_REGIONS> region_columns_arr;
+    std::array<double, MATERIAL_REGIONS> region_materials_arr;
+    for(size_t region = 0; region < MATERIAL_REGIONS; region++) {
+        region_rows_arr[region] = Next_Corpus_Unit(random_state) * resolution;
+        region_columns_arr[region] = Next_Corpus_Unit(random_state) * resolution;
+        region_materials_arr[region] = static_cast<double>(Next_Corpus_Random(random_state) % NUMBER_OF_MATERIALS);
+    }
+
+    std::vector<double> material_vec(resolution * resolution);
+    for(uint64_t row = 0; row < resolution; row++) {
+        for(uint64_t column = 0; column < resolution; column++) {
+            size_t nearest_region = 0;
+            double nearest_distance = 0.0;
+            for(size_t region = 0; region < MATERIAL_REGIONS; region++) {
+                const double row_distance = region_rows_arr[region] - row;
+                const double column_distance = region_columns_arr[region] - column;
+                const double distance = row_distance * row_distance + column_distance * column_distance;
+                if(region == 0 || distance < nearest_distance) {
+                    nearest_region = region;
+                    nearest_distance = distance;
+                }
+            }
+            material_vec[row * resolution + column] = region_materials_arr[nearest_region];
+        }
+    }
+    return material_vec;
+}
+
+// picks every 2^(finest - lod) sample and stores it little endian at the layer's width
+std::vector<char> CorpusGenerator::Quantize_Field(const std::vector<double>& field_vec, const CorpusLayerKind& kind, const int& data_type_size, const int& lod_number) const {
+    const uint64_t field_resolution = Get_Side_Resolution(spec.number_of_lods - 1);
+    const uint64_t resolution = Get_Side_Resolution(lod_number);
+    const uint64_t stride = (field_resolution - 1) / (resolution - 1);
+    const double maximum_value = std::ldexp(1.0, 8 * data_type_size) - 1.0;
+
+    std::vector<char> tile_vec(resolution * resolution * data_type_size);
+    for(uint64_t row = 0; row < resolution; row++) {
+        for(uint64_t column = 0; column < resolution; column++) {
+            const double value = field_vec[(row * stride) * field_resolution + column * stride];
+            char* sample_ptr = &tile_vec[(row * resolution + column) * data_type_size];
+
+            if(kind == CorpusLayerKind::terrain && data_type_size == 4) {
+                const float metres = static_cast<float>(TERRAIN_MINIMUM_METRES + value * (TERRAIN_MAXIMUM_METRES - TERRAIN_MINIMUM_METRES));
+                std::memcpy(sample_ptr, &metres, sizeof(metres));
+                continue;
+            }
+
+            uint64_t sample = 0;
+            switch(kind) {
+                case CorpusLayerKind::terrain:
+                    sample = static_cast<uint64_t>(std::lround(value * maximum_value));
+                    break;
+                case CorpusLayerKind::ocean_mask:
+                    sample = (value < OCEAN_SEA_LEVEL) ? 0 : 1;
+                    break;
+                case CorpusLayerKind::material_map:
+                    sample = static_cast<uint64_t>(value);
+                    break;
+                case CorpusLayerKind::noise:
+                    sample = static_cast<uint64_t>(value * (maximum_value + 1.0));
+                    break;
+                default:
+                    break;
+            }
+            std::memcpy(sample_ptr, &sample, data_type_size);
+        }
+    }
+    return tile_vec;
+}
+
+void CorpusGenerator::Write_Geometa(const std::filesystem::path& geometa_path, const CorpusLayerKind& kind, const int& data_type_size) const {
+    json geometa_json;
+    geometa_json["storage_bytes_size"] = data_type_size;
+    geometa_json["storage_type"] = Get_Storage_Type_Name(kind, data_type_size);
+    geometa_json["synthetic_kind"] = Get_Layer_Kind_Name(kind);
+    geometa_json["synthetic_seed"] = spec.seed;
+    for(int side = 0; side < 6; side++) {
+        geometa_json["Side" + std::to_string(side)]["qT_subsets_resolution"] =
+            std::vector<uint64_t>(spec.subsets_per_side, Get_Side_Resolution(spec.number_of_lods - 1));
+    }
+
+    std::ofstream geometa_file(geometa_path);
+    if(!(geometa_file << std::setw(4) << geometa_json)) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to write "} + geometa_path.string());
+    }
+}
+
+// every field gets its own stream, so adding a kind or a subset never changes the others
+const uint64_t CorpusGenerator::Get_Field_Seed(const CorpusLayerKind& kind, const int& side, const int& c_number) const {
+    uint64_t state = spec.seed ^ (static_cast<uint64_t>(kind) << 48) ^ (static_cast<uint64_t>(side) << 40) ^ (static_cast<uint64_t>(c_number) << 32);
+    return Next_Corpus_Random(state);
+}
+
+//getters
+const CorpusSpec& CorpusGenerator::Get_Spec() const {return spec;}
+
+const char* CorpusGenerator::Get_Layer_Kind_Name(const CorpusLayerKind& kind) {
+    switch(kind) {
+        case CorpusLayerKind::terrain: return "terrain";
+        case CorpusLayerKind::ocean_mask: return "oceanmask";
+        case CorpusLayerKind::material_map: return "materialmap";
+        case CorpusLayerKind::noise: return "noise";
+        default: return "unknown";
+    }
+}
+
+const char* CorpusGenerator::Get_Storage_Type_Name(const CorpusLayerKind& kind, const int& data_type_size) {
+    if(kind == CorpusLayerKind::terrain && data_type_size == 4) {
+        return "float32";
+    }
+    switch(data_type_size) {
+        case 1: return "uint8";
+        case 2: return "uint16";
+        case 4: return "uint32";
+        default: return "unknown";
+    }
+}
+
+const uint64_t CorpusGenerator::Get_Side_Resolution(const int& lod_number) {
+    return 1 + (1ull << (6 + lod_number));
+}
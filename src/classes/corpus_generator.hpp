@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define DEFAULT_CORPUS_SEED 0x67656f62696eull
+#define DEFAULT_CORPUS_NUMBER_OF_LODS 3
+#define DEFAULT_CORPUS_SUBSETS_PER_SIDE 4
+// qT_subsets_resolution is read as uint16, so lod 9 (2^15 + 1 samples) is the last that fits
+#define MAX_CORPUS_NUMBER_OF_LODS 10
+#define MAX_CORPUS_SUBSETS_PER_SIDE 4
+
+// splitmix64, used instead of <random> distributions because those are allowed to differ between standard libraries
+inline uint64_t Next_Corpus_Random(uint64_t& state) {
+    uint64_t value = (state += 0x9e3779b97f4a7c15ull);
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+enum class CorpusLayerKind {
+    terrain,
+    ocean_mask,
+    material_map,
+    noise,
+    NUMBER_KINDS
+};
+
+struct CorpusSpec {
+    uint64_t seed = DEFAULT_CORPUS_SEED;
+    int number_of_lods = DEFAULT_CORPUS_NUMBER_OF_LODS;
+    int subsets_per_side = DEFAULT_CORPUS_SUBSETS_PER_SIDE;
+};
+
+// writes a PlanetData shaped tree of geobin/geometa pairs: <root>/Synthetic/<kind><storage bytes>/<layer>_s<side>_c<c>_lod<lod>.geobin
+// for every kind, storage size 1/2/4, side 0-5, subset c and lod. everything is derived from the seed,
+// so the same spec gives byte identical files on every machine.
+// each (side, c) field is generated once at the finest lod and decimated for the coarser ones, like a real lod pyramid
+class CorpusGenerator {
+    public:
+        // Constructors
+        CorpusGenerator(const CorpusSpec& spec);
+
+        // returns the layer directories that were written
+        std::vector<std::filesystem::path> Generate_Corpus(const std::filesystem::path& root_path) const;
+        std::filesystem::path Generate_Layer(const std::filesystem::path& planet_path, const CorpusLayerKind& kind, const int& data_type_size) const;
+        // one lod of one subset, side resolution rows of side resolution little endian samples
+        std::vector<char> Generate_Tile(const CorpusLayerKind& kind, const int& data_type_size, const int& side, const int& c_number, const int& lod_number) const;
+
+        //getters
+        const CorpusSpec& Get_Spec() const;
+        static const char* Get_Layer_Kind_Name(const CorpusLayerKind& kind);
+        // what the samples mean, written to the geometa as storage_type
+        static const char* Get_Storage_Type_Name(const CorpusLayerKind& kind, const int& data_type_size);
+        static const uint64_t Get_Side_Resolution(const int& lod_number);
+
+    private:
+        // heights in [0, 1] (material ids for the material map) at the finest lod, row major
+        std::vector<double> Generate_Field(const CorpusLayerKind& kind, const int& side, const int& c_number) const;
+        std::vector<double> Generate_Heightfield(uint64_t& random_state, const uint64_t& resolution) const;
+        std::vector<double> Generate_Material_Field(uint64_t& random_state, const uint64_t& resolution) const;
+        std::vector<char> Quantize_Field(const std::vector<double>& field_vec, const CorpusLayerKind& kind, const int& data_type_size, const int& lod_number) const;
+        void Write_Geometa(const std::filesystem::path& geometa_path, const CorpusLayerKind& kind, const int& data_type_size) const;
+        const uint64_t Get_Field_Seed(const CorpusLayerKind& kind, const int& side, const int& c_number) const;
+
+        CorpusSpec spec;
+};
@@ -0,0 +1,289 @@
+#include "directory_walker.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+
+enum class Walked_File_Kind : uint8_t {
+    other,
+    directory,
+    geobin,
+    geometa
+};
+
+static const Walked_File_Kind Get_File_Kind_From_Name(const char* name) {
+    const size_t length = std::strlen(name);
+    if(length > 7 && std::strcmp(name + length - 7, ".geobin") == 0) {
+        return Walked_File_Kind::geobin;
+    }
+    if(length > 8 && std::strcmp(name + length - 8, ".geometa") == 0) {
+        return Walked_File_Kind::geometa;
+    }
+    return Walked_File_Kind::other;
+}
+
+static const std::string Join_Directory_Path(const std::string& directory_path, const char* name) {
+    std::string child_path = directory_path;
+    if(!child_path.empty() && child_path.back() != '/') {
+        child_path.push_back('/');
+    }
+    child_path.append(name);
+    return child_path;
+}
+
+#ifdef __linux__
+// the kernel's record layout, glibc only exposes a wrapper for it since 2.30
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// lists one directory, subdirectories go to subdirectory_vec, false (with errno set) if it could not be opened
+static const bool Read_Directory(const std::string& directory_path, const bool& collect_file_sizes, std::vector<char>& buffer_vec,
+                                 std::vector<std::string>& subdirectory_vec, WalkedDirectory& walked_directory) {
+    const int directory_fd = open(directory_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(directory_fd < 0) {
+        return false;
+    }
+    while(true) {
+        const long bytes_read = syscall(SYS_getdents64, directory_fd, buffer_vec.data(), buffer_vec.size());
+        if(bytes_read <= 0) {
+            break;
+        }
+        for(long offset = 0; offset < bytes_read;) {
+            const LinuxDirent64* dirent = reinterpret_cast<const LinuxDirent64*>(buffer_vec.data() + offset);
+            offset += dirent->d_reclen;
+            const char* name = dirent->d_name;
+            if(name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+
+            Walked_File_Kind kind = Walked_File_Kind::other;
+            if(dirent->d_type == DT_DIR) {
+                kind = Walked_File_Kind::directory;
+            } else if(dirent->d_type == DT_REG || dirent->d_type == DT_LNK || dirent->d_type == DT_UNKNOWN) {
+                kind = Get_File_Kind_From_Name(name);
+            }
+            // d_type is authoritative for plain files, everything else is resolved like is_regular_file(status()) would
+            struct stat file_stat;
+            bool have_stat = false;
+            if(dirent->d_type == DT_UNKNOWN || (dirent->d_type == DT_LNK && kind != Walked_File_Kind::other)) {
+                bool is_symlink = (dirent->d_type == DT_LNK);
+                if(dirent->d_type == DT_UNKNOWN) {
+                    if(fstatat(directory_fd, name, &file_stat, AT_SYMLINK_NOFOLLOW) != 0) {
+                        continue;
+                    }
+                    is_symlink = S_ISLNK(file_stat.st_mode);
+                    if(S_ISDIR(file_stat.st_mode)) {
+                        kind = Walked_File_Kind::directory;
+                    }
+                }
+                // a symlinked file counts when its target is a regular file, symlinked directories are not entered
+                if(is_symlink && kind != Walked_File_Kind::other && fstatat(directory_fd, name, &file_stat, 0) != 0) {
+                    continue;
+                }
+                have_stat = true;
+                if(kind != Walked_File_Kind::directory && !S_ISREG(file_stat.st_mode)) {
+                    kind = Walked_File_Kind::other;
+                }
+            }
+
+            if(kind == Walked_File_Kind::directory) {
+                subdirectory_vec.push_back(Join_Directory_Path(directory_path, name));
+            } else if(kind == Walked_File_Kind::geometa) {
+                walked_directory.geometa_name_vec.emplace_back(name);
+            } else if(kind == Walked_File_Kind::geobin) {
+                walked_directory.geobin_name_vec.emplace_back(name);
+                if(collect_file_sizes) {
+                    if(!have_stat && fstatat(directory_fd, name, &file_stat, 0) != 0) {
+                        file_stat.st_size = 0;
+                    }
+                    walked_directory.geobin_size_vec.push_back(static_cast<uint64_t>(file_stat.st_size));
+                }
+            }
+        }
+    }
+    close(directory_fd);
+    return true;
+}
+#else
+static const bool Read_Directory(const std::string& directory_path, const bool& collect_file_sizes, std::vector<char>& buffer_vec,
+                                 std::vector<std::string>& subdirectory_vec, WalkedDirectory& walked_directory) {
+    std::error_code error_code;
+    std::filesystem::directory_iterator directory_it(directory_path, error_code);
+    if(error_code) {
+        return false;
+    }
+    for(const auto& entry : directory_it) {
+        const std::string name = entry.path().filename().string();
+        if(entry.is_directory(error_code) && !entry.is_symlink(error_code)) {
+            subdirectory_vec.push_back(Join_Directory_Path(directory_path, name.c_str()));
+            continue;
+        }
+        if(!entry.is_regular_file(error_code)) {
+            continue;
+        }
+        const Walked_File_Kind kind = Get_File_Kind_From_Name(name.c_str());
+        if(kind == Walked_File_Kind::geometa) {
+            walked_directory.geometa_name_vec.push_back(name);
+        } else if(kind == Walked_File_Kind::geobin) {
+            walked_directory.geobin_name_vec.push_back(name);
+            if(collect_file_sizes) {
+                walked_directory.geobin_size_vec.push_back(entry.file_size(error_code));
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+const bool WalkedDirectory::Has_Geobin_And_Geometa() const {
+    return !geobin_name_vec.empty() && !geometa_name_vec.empty();
+}
+
+
+DirectoryWalker::DirectoryWalker(const int& number_of_threads, const bool& collect_file_sizes)
+    : number_of_threads(number_of_threads), collect_file_sizes(collect_file_sizes) {
+    if(this->number_of_threads <= 0) {
+        if(const char* walker_threads = std::getenv("GEOBIN_WALKER_THREADS")) {
+            this->number_of_threads = std::atoi(walker_threads);
+        }
+    }
+    if(this->number_of_threads <= 0) {
+        this->number_of_threads = static_cast<int>(std::min<unsigned>(std::max(1u, std::thread::hardware_concurrency()), MAX_DIRECTORY_WALKER_THREADS));
+    }
+}
+
+const std::vector<WalkedDirectory> DirectoryWalker::Walk(const std::filesystem::path& root_path) const {
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    // directories still to be read, and how many are being read right now. the walk is over when both are zero
+    std::vector<std::string> pending_directory_vec{root_path.string()};
+    int directories_in_flight = 0;
+    std::vector<WalkedDirectory> walked_directory_vec;
+    std::string failed_directory;
+    int failed_errno = 0;
+
+    auto walk_directories = [&]() {
+        std::vector<char> buffer_vec(DIRECTORY_WALKER_BUFFER_BYTES);
+        std::vector<std::string> subdirectory_vec;
+        std::vector<WalkedDirectory> local_walked_directory_vec;
+        std::unique_lock<std::mutex> queue_lock(queue_mutex);
+        while(true) {
+            queue_condition.wait(queue_lock, [&] {return !pending_directory_vec.empty() || directories_in_flight == 0;});
+            if(pending_directory_vec.empty()) {
+                break;
+            }
+            // depth first off the back keeps the queue short on deep trees
+            const std::string directory_path = std::move(pending_directory_vec.back());
+            pending_directory_vec.pop_back();
+            directories_in_flight++;
+            queue_lock.unlock();
+
+            subdirectory_vec.clear();
+            WalkedDirectory walked_directory;
+            errno = 0;
+            const bool read = Read_Directory(directory_path, collect_file_sizes, buffer_vec, subdirectory_vec, walked_directory);
+            const int read_errno = errno;
+            if(!walked_directory.geobin_name_vec.empty() || !walked_directory.geometa_name_vec.empty()) {
+                walked_directory.directory_path = std::filesystem::path{directory_path};
+                local_walked_directory_vec.push_back(std::move(walked_directory));
+            }
+
+            queue_lock.lock();
+            if(!read && failed_directory.empty()) {
+                failed_directory = directory_path;
+                failed_errno = read_errno;
+            }
+            for(auto& subdirectory : subdirectory_vec) {
+                pending_directory_vec.push_back(std::move(subdirectory));
+            }
+            directories_in_flight--;
+            queue_condition.notify_all();
+        }
+        for(auto& walked_directory : local_walked_directory_vec) {
+            walked_directory_vec.push_back(std::move(walked_directory));
+        }
+    };
+
+    std::vector<std::thread> thread_vec;
+    for(int thread = 1; thread < number_of_threads; thread++) {
+        thread_vec.emplace_back(walk_directories);
+    }
+    walk_directories();
+    for(auto& thread : thread_vec) {
+        thread.join();
+    }
+
+    // an unreadable directory ends the run, like the recursive_directory_iterator it replaces
+    if(!failed_directory.empty()) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to read directory "} + failed_directory + std::string{": "} + std::string{std::strerror(failed_errno)});
+    }
+
+    std::sort(walked_directory_vec.begin(), walked_directory_vec.end(),
+              [](const WalkedDirectory& a, const WalkedDirectory& b) {return a.directory_path < b.directory_path;});
+    for(auto& walked_directory : walked_directory_vec) {
+        std::sort(walked_directory.geometa_name_vec.begin(), walked_directory.geometa_name_vec.end());
+        if(walked_directory.geobin_size_vec.empty()) {
+            std::sort(walked_directory.geobin_name_vec.begin(), walked_directory.geobin_name_vec.end());
+            continue;
+        }
+        // names and sizes sorted together
+        std::vector<size_t> order_vec(walked_directory.geobin_name_vec.size());
+        for(size_t i = 0; i < order_vec.size(); i++) {
+            order_vec[i] = i;
+        }
+        std::sort(order_vec.begin(), order_vec.end(),
+                  [&](const size_t& a, const size_t& b) {return walked_directory.geobin_name_vec[a] < walked_directory.geobin_name_vec[b];});
+        std::vector<std::string> sorted_name_vec;
+        std::vector<uint64_t> sorted_size_vec;
+        sorted_name_vec.reserve(order_vec.size());
+        sorted_size_vec.reserve(order_vec.size());
+        for(const size_t& index : order_vec) {
+            sorted_name_vec.push_back(std::move(walked_directory.geobin_name_vec[index]));
+            sorted_size_vec.push_back(walked_directory.geobin_size_vec[index]);
+        }
+        walked_directory.geobin_name_vec = std::move(sorted_name_vec);
+        walked_directory.geobin_size_vec = std::move(sorted_size_vec);
+    }
+#ifdef DEBUG_MODE
+    PRINT_DEBUG(std::string{"Walked "} + root_path.string() + std::string{" with "} + std::to_string(number_of_threads) + std::string{" threads, "} +
+                std::to_string(walked_directory_vec.size()) + std::string{" directories with geobin or geometa files"});
+#endif
+    return walked_directory_vec;
+}
+
+//getters
+const int DirectoryWalker::Get_Number_Of_Threads() const {return number_of_threads;}
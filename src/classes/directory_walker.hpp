@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define MAX_DIRECTORY_WALKER_THREADS 16
+#define DIRECTORY_WALKER_BUFFER_BYTES (64 * 1024)
+
+// a directory holding geobin and/or geometa files, names are sorted and relative to directory_path
+struct WalkedDirectory {
+    std::filesystem::path directory_path;
+    std::vector<std::string> geometa_name_vec;
+    std::vector<std::string> geobin_name_vec;
+    // parallel to geobin_name_vec, only filled when the walker collects file sizes
+    std::vector<uint64_t> geobin_size_vec;
+
+    const bool Has_Geobin_And_Geometa() const;
+};
+
+// enumerates a tree with a pool of threads sharing a queue of directories. on linux every directory is read with
+// getdents64 and classified by d_type, so only symlinks and file systems that report DT_UNKNOWN cost a stat.
+// directory symlinks are not followed, the same as recursive_directory_iterator
+class DirectoryWalker {
+    public:
+        // Constructors
+        // number_of_threads 0 takes GEOBIN_WALKER_THREADS, or the hardware concurrency capped at MAX_DIRECTORY_WALKER_THREADS
+        DirectoryWalker(const int& number_of_threads = 0, const bool& collect_file_sizes = false);
+
+        // every directory under (and including) root_path that holds a geobin or geometa file, sorted by path
+        const std::vector<WalkedDirectory> Walk(const std::filesystem::path& root_path) const;
+
+        //getters
+        const int Get_Number_Of_Threads() const;
+
+    private:
+        int number_of_threads;
+        bool collect_file_sizes;
+};
@@ -0,0 +1,171 @@
+#include "frequency_analyzer.hpp"
+#include "stream_codec.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+
+void Count_Byte_Histogram(const uint8_t* data, const uint64_t& number_of_bytes, std::array<uint32_t, 256>& counts_arr) {
+    if(number_of_bytes < BYTE_HISTOGRAM_SPLIT_MINIMUM_BYTES) {
+        for(uint64_t i = 0; i < number_of_bytes; i++) {
+            counts_arr[data[i]]++;
+        }
+        return;
+    }
+
+    alignas(64) uint32_t sub_counts_arr[4][256] = {};
+    uint64_t i = 0;
+    for(; i + 8 <= number_of_bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        sub_counts_arr[0][word & 0xFF]++;
+        sub_counts_arr[1][(word >> 8) & 0xFF]++;
+        sub_counts_arr[2][(word >> 16) & 0xFF]++;
+        sub_counts_arr[3][(word >> 24) & 0xFF]++;
+        sub_counts_arr[0][(word >> 32) & 0xFF]++;
+        sub_counts_arr[1][(word >> 40) & 0xFF]++;
+        sub_counts_arr[2][(word >> 48) & 0xFF]++;
+        sub_counts_arr[3][word >> 56]++;
+    }
+    for(; i < number_of_bytes; i++) {
+        sub_counts_arr[0][data[i]]++;
+    }
+    for(int symbol = 0; symbol < 256; symbol++) {
+        counts_arr[symbol] += sub_counts_arr[0][symbol] + sub_counts_arr[1][symbol] + sub_counts_arr[2][symbol] + sub_counts_arr[3][symbol];
+    }
+}
+
+
+// SymbolHistogram
+SymbolHistogram::SymbolHistogram(const uint8_t& data_type_size) : data_type_size(data_type_size) {
+    if(data_type_size != 1 && data_type_size != 2 && data_type_size != 4) {
+        ERROR_MSG_AND_EXIT("Error: Invalid data type size.");
+    }
+    if(data_type_size <= 2) {
+        dense_counts_vec.assign(size_t{1} << (8 * data_type_size), 0);
+    }
+}
+
+void SymbolHistogram::Count(const char* data, const uint64_t& number_of_bytes) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    switch(data_type_size) {
+        case 1: {
+            // 32 bit counters are folded into the 64 bit ones after every call, so they never overflow
+            Count_Byte_Histogram(bytes, number_of_bytes, byte_counts_arr);
+            for(int symbol = 0; symbol < 256; symbol++) {
+                dense_counts_vec[symbol] += byte_counts_arr[symbol];
+                byte_counts_arr[symbol] = 0;
+            }
+            break;
+        }
+        case 2: {
+            for(uint64_t i = 0; i + 2 <= number_of_bytes; i += 2) {
+                const uint32_t symbol = (static_cast<uint32_t>(bytes[i]) << 8) | bytes[i + 1];
+                if(dense_counts_vec[symbol]++ == 0) {
+                    touched_symbols_vec.push_back(symbol);
+                }
+            }
+            break;
+        }
+        default: {
+            for(uint64_t i = 0; i + 4 <= number_of_bytes; i += 4) {
+                const uint32_t symbol = (static_cast<uint32_t>(bytes[i]) << 24) | (static_cast<uint32_t>(bytes[i + 1]) << 16) |
+                                        (static_cast<uint32_t>(bytes[i + 2]) << 8) | bytes[i + 3];
+                sparse_counts_map[symbol]++;
+            }
+            break;
+        }
+    }
+}
+
+void SymbolHistogram::Add_Table(const FrequencyTable& table) {
+    for(const auto& [symbol, count] : table.symbol_count_vec) {
+        if(data_type_size == 4) {
+            sparse_counts_map[symbol] += count;
+        } else {
+            if(data_type_size == 2 && dense_counts_vec[symbol] == 0) {
+                touched_symbols_vec.push_back(symbol);
+            }
+            dense_counts_vec[symbol] += count;
+        }
+    }
+}
+
+void SymbolHistogram::Move_Into_Table(FrequencyTable& table) {
+    table.data_type_size = data_type_size;
+    table.symbol_count_vec.clear();
+    if(data_type_size == 1) {
+        for(uint32_t symbol = 0; symbol < 256; symbol++) {
+            if(dense_counts_vec[symbol] != 0) {
+                table.symbol_count_vec.emplace_back(symbol, dense_counts_vec[symbol]);
+                dense_counts_vec[symbol] = 0;
+            }
+        }
+    } else if(data_type_size == 2) {
+        std::sort(touched_symbols_vec.begin(), touched_symbols_vec.end());
+        for(const uint32_t& symbol : touched_symbols_vec) {
+            table.symbol_count_vec.emplace_back(symbol, dense_counts_vec[symbol]);
+            dense_counts_vec[symbol] = 0;
+        }
+        touched_symbols_vec.clear();
+    } else {
+        table.symbol_count_vec.assign(sparse_counts_map.begin(), sparse_counts_map.end());
+        sparse_counts_map.clear();
+        std::sort(table.symbol_count_vec.begin(), table.symbol_count_vec.end());
+    }
+}
+
+
+// FrequencyAnalyzer
+FrequencyAnalyzer::FrequencyAnalyzer(const uint8_t& data_type_size, const uint64_t& row_length, const uint64_t& rows_per_block)
+    : data_type_size(data_type_size), row_length(row_length), rows_per_block(std::max<uint64_t>(rows_per_block, 1)),
+      row_histogram(data_type_size), block_histogram(data_type_size), file_histogram(data_type_size) {
+    if(row_length == 0 || row_length % data_type_size != 0) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: row length "} + std::to_string(row_length) + std::string{" is not a multiple of the data type size."});
+    }
+}
+
+void FrequencyAnalyzer::Analyze_File(const std::filesystem::path& binary_path, const std::string& source, FrequencyTableWriter& table_writer) {
+    uint64_t row_number = 0;
+    FrequencyTable table;
+    // chunks hold whole rows, so a row never straddles two reads
+    For_Each_File_Chunk(binary_path, std::max<uint64_t>(row_length, FREQUENCY_CHUNK_BYTES), row_length, [&](const std::vector<char>& binary_data_vec){
+        for(uint64_t offset = 0; offset + row_length <= binary_data_vec.size(); offset += row_length, row_number++) {
+            row_histogram.Count(binary_data_vec.data() + offset, row_length);
+            row_histogram.Move_Into_Table(table);
+            block_histogram.Add_Table(table);
+            file_histogram.Add_Table(table);
+            table_writer.Append_Table(source, Frequency_Table_Scope::row, row_number, table);
+
+            if((row_number + 1) % rows_per_block == 0) {
+                block_histogram.Move_Into_Table(table);
+                table_writer.Append_Table(source, Frequency_Table_Scope::block, row_number / rows_per_block, table);
+            }
+        }
+    });
+    if(row_number == 0) {
+        return;
+    }
+    if(row_number % rows_per_block != 0) {
+        block_histogram.Move_Into_Table(table);
+        table_writer.Append_Table(source, Frequency_Table_Scope::block, row_number / rows_per_block, table);
+    }
+    file_histogram.Move_Into_Table(table);
+    table_writer.Append_Table(source, Frequency_Table_Scope::file, 0, table);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "frequency_table.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define DEFAULT_FREQUENCY_ROWS_PER_BLOCK 64
+#define FREQUENCY_CHUNK_BYTES (16ull << 20)
+// below this many bytes the four way split costs more to fold than it saves
+#define BYTE_HISTOGRAM_SPLIT_MINIMUM_BYTES 256
+
+// adds the byte counts of data to counts_arr. four interleaved sub-histograms fed from 8 byte loads keep
+// consecutive equal bytes from serialising on one counter, the fold back into counts_arr vectorises
+void Count_Byte_Histogram(const uint8_t* data, const uint64_t& number_of_bytes, std::array<uint32_t, 256>& counts_arr);
+
+// symbol counts for one data type size: dense counters with a list of the touched symbols for 1 and 2 byte
+// symbols, so a reset costs O(unique symbols), and a hash map for 4 byte symbols
+class SymbolHistogram {
+    public:
+        // Constructors
+        explicit SymbolHistogram(const uint8_t& data_type_size);
+
+        // data holds whole samples, symbols are read most significant byte first
+        void Count(const char* data, const uint64_t& number_of_bytes);
+        // adds a table in ascending symbol order, how the row counts roll up into blocks and the file
+        void Add_Table(const FrequencyTable& table);
+        // ascending symbols, and the counts start over
+        void Move_Into_Table(FrequencyTable& table);
+
+    private:
+        uint8_t data_type_size;
+        std::vector<uint64_t> dense_counts_vec;
+        std::vector<uint32_t> touched_symbols_vec;
+        std::unordered_map<uint32_t, uint64_t> sparse_counts_map;
+        std::array<uint32_t, 256> byte_counts_arr{};
+};
+
+// one streaming pass over a geobin that hands per-row, per-block and per-file tables to a FrequencyTableWriter.
+// rows are counted once, blocks and the file are the sums of their rows' tables
+class FrequencyAnalyzer {
+    public:
+        // Constructors
+        FrequencyAnalyzer(const uint8_t& data_type_size, const uint64_t& row_length, const uint64_t& rows_per_block = DEFAULT_FREQUENCY_ROWS_PER_BLOCK);
+
+        // a trailing partial row is ignored, a trailing partial block still gets its table
+        void Analyze_File(const std::filesystem::path& binary_path, const std::string& source, FrequencyTableWriter& table_writer);
+
+    private:
+        uint8_t data_type_size;
+        uint64_t row_length;
+        uint64_t rows_per_block;
+        SymbolHistogram row_histogram;
+        SymbolHistogram block_histogram;
+        SymbolHistogram file_histogram;
+};
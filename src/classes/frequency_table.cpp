@@ -0,0 +1,397 @@
+#include "frequency_table.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef GEOBIN_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+
+using json = nlohmann::ordered_json;
+
+// little endian base 128, seven bits per byte, high bit set on every byte but the last
+static void Append_Varint(std::vector<char>& buffer_vec, uint64_t value) {
+    while(value >= 0x80) {
+        buffer_vec.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer_vec.push_back(static_cast<char>(value));
+}
+
+static const bool Read_Varint(const std::vector<char>& buffer_vec, size_t& offset, uint64_t& value) {
+    value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        if(offset >= buffer_vec.size()) {
+            return false;
+        }
+        const uint8_t byte = static_cast<uint8_t>(buffer_vec[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* Get_Scope_Name(const Frequency_Table_Scope& scope) {
+    switch(scope) {
+        case Frequency_Table_Scope::row: return "row";
+        case Frequency_Table_Scope::block: return "block";
+        case Frequency_Table_Scope::file: return "file";
+    }
+    return "unknown";
+}
+
+
+// FrequencyTable
+const bool FrequencyTable::Has_Same_Counts(const FrequencyTable& other) const {
+    return data_type_size == other.data_type_size && symbol_count_vec == other.symbol_count_vec;
+}
+
+const uint64_t FrequencyTable::Get_Total_Count() const {
+    uint64_t total_count = 0;
+    for(const auto& [symbol, count] : symbol_count_vec) {
+        total_count += count;
+    }
+    return total_count;
+}
+
+
+// xxh64 primes
+#define FREQUENCY_HASH_PRIME_1 0x9E3779B185EBCA87ull
+#define FREQUENCY_HASH_PRIME_2 0xC2B2AE3D27D4EB4Full
+#define FREQUENCY_HASH_PRIME_3 0x165667B19E3779F9ull
+
+static inline const uint64_t Rotate_Left(const uint64_t& value, const int& bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline const uint64_t Hash_Round(const uint64_t& accumulator, const uint64_t& word) {
+    return Rotate_Left(accumulator + word * FREQUENCY_HASH_PRIME_2, 31) * FREQUENCY_HASH_PRIME_1;
+}
+
+const uint64_t Get_Frequency_Table_Hash(const FrequencyTable& table) {
+    uint64_t hash = FREQUENCY_HASH_PRIME_3 + (static_cast<uint64_t>(table.data_type_size) << 32) + table.symbol_count_vec.size();
+    for(const auto& [symbol, count] : table.symbol_count_vec) {
+        // symbols are at most 32 bits, rows never hold 2^32 samples, so one word per pair loses nothing
+        hash = Hash_Round(hash, (static_cast<uint64_t>(symbol) << 32) ^ count);
+    }
+    hash ^= hash >> 33;
+    hash *= FREQUENCY_HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= FREQUENCY_HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+
+// FrequencyTableWriter
+FrequencyTableWriter::FrequencyTableWriter(const std::filesystem::path& table_path, const bool& zstd_framed)
+    : table_path(table_path), zstd_framed(zstd_framed) {
+#ifndef GEOBIN_HAVE_ZSTD
+    this->zstd_framed = false;
+#endif
+}
+
+FrequencyTableWriter::~FrequencyTableWriter() {
+    if(!closed) {
+        Close();
+    }
+}
+
+const uint32_t FrequencyTableWriter::Append_Table(const std::string& source, const Frequency_Table_Scope& scope, const uint64_t& index, const FrequencyTable& table) {
+    // a hit is confirmed against the stored table, so a collision only costs a comparison
+    std::vector<uint32_t>& table_id_vec = table_ids_by_hash_map[Get_Frequency_Table_Hash(table)];
+    uint32_t table_id = static_cast<uint32_t>(tables_vec.size());
+    for(const uint32_t& candidate_id : table_id_vec) {
+        if(tables_vec[candidate_id].Has_Same_Counts(table)) {
+            table_id = candidate_id;
+            break;
+        }
+    }
+    if(table_id == tables_vec.size()) {
+        table_id_vec.push_back(table_id);
+        tables_vec.push_back(table);
+    }
+
+    int64_t& last_reference_index = last_reference_index_arr[static_cast<size_t>(scope)];
+    if(last_reference_index >= 0) {
+        FrequencyTableReference& previous_reference = references_vec[last_reference_index];
+        if(previous_reference.table_id == table_id && previous_reference.last_index + 1 == index && previous_reference.source == source) {
+            previous_reference.last_index = index;
+            return table_id;
+        }
+    }
+    last_reference_index = static_cast<int64_t>(references_vec.size());
+    references_vec.push_back(FrequencyTableReference{source, scope, index, index, table_id});
+    return table_id;
+}
+
+const bool FrequencyTableWriter::Close() {
+    if(closed) {
+        return true;
+    }
+    closed = true;
+    if(references_vec.empty()) {
+        std::error_code error_code;
+        std::filesystem::remove(table_path, error_code);
+        return true;
+    }
+
+    // the frequency order sort happens once per distinct table
+    for(auto& table : tables_vec) {
+        std::sort(table.symbol_count_vec.begin(), table.symbol_count_vec.end(), [](const std::pair<uint32_t, uint64_t>& a, const std::pair<uint32_t, uint64_t>& b){
+            return (a.second != b.second) ? (a.second > b.second) : (a.first < b.first);
+        });
+    }
+    table_ids_by_hash_map.clear();
+    // grouped by source and scope on disk, in index order inside a group
+    std::stable_sort(references_vec.begin(), references_vec.end(), [](const FrequencyTableReference& a, const FrequencyTableReference& b){
+        return (a.source != b.source) ? (a.source < b.source) : (a.scope < b.scope);
+    });
+
+    std::vector<char> payload_vec;
+    Append_Varint(payload_vec, tables_vec.size());
+    for(const auto& table : tables_vec) {
+        payload_vec.push_back(static_cast<char>(table.data_type_size));
+        Append_Varint(payload_vec, table.symbol_count_vec.size());
+        // counts only ever go down, the differences stay small
+        uint64_t previous_count = 0;
+        for(size_t i = 0; i < table.symbol_count_vec.size(); i++) {
+            const auto& [symbol, count] = table.symbol_count_vec[i];
+            Append_Varint(payload_vec, symbol);
+            Append_Varint(payload_vec, (i == 0) ? count : (previous_count - count));
+            previous_count = count;
+        }
+    }
+    // strings are shared by every reference of a source, so only a change of source is written out
+    Append_Varint(payload_vec, references_vec.size());
+    const std::string* previous_source = nullptr;
+    for(const auto& reference : references_vec) {
+        const bool new_source = (previous_source == nullptr || *previous_source != reference.source);
+        payload_vec.push_back(static_cast<char>(new_source ? 1 : 0));
+        if(new_source) {
+            Append_Varint(payload_vec, reference.source.size());
+            payload_vec.insert(payload_vec.end(), reference.source.begin(), reference.source.end());
+            previous_source = &reference.source;
+        }
+        payload_vec.push_back(static_cast<char>(reference.scope));
+        Append_Varint(payload_vec, reference.first_index);
+        Append_Varint(payload_vec, reference.last_index - reference.first_index);
+        Append_Varint(payload_vec, reference.table_id);
+    }
+
+    std::vector<char> file_vec(GEOBIN_FREQUENCY_TABLE_MAGIC, GEOBIN_FREQUENCY_TABLE_MAGIC + std::strlen(GEOBIN_FREQUENCY_TABLE_MAGIC));
+    Append_Varint(file_vec, GEOBIN_FREQUENCY_TABLE_VERSION);
+    file_vec.push_back(static_cast<char>(zstd_framed ? FREQUENCY_TABLE_FLAG_ZSTD : 0));
+#ifdef GEOBIN_HAVE_ZSTD
+    if(zstd_framed) {
+        const size_t header_size = file_vec.size();
+        file_vec.resize(header_size + ZSTD_compressBound(payload_vec.size()));
+        const size_t compressed_size = ZSTD_compress(file_vec.data() + header_size, file_vec.size() - header_size, payload_vec.data(), payload_vec.size(), 3);
+        if(ZSTD_isError(compressed_size)) {
+            ERROR_MSG(std::string{"ERROR: ZSTD_compress failed: "} + std::string{ZSTD_getErrorName(compressed_size)});
+            return false;
+        }
+        file_vec.resize(header_size + compressed_size);
+    } else
+#endif
+    {
+        file_vec.insert(file_vec.end(), payload_vec.begin(), payload_vec.end());
+    }
+
+    std::ofstream table_file(table_path, std::ios::binary | std::ios::trunc);
+    if(!table_file.write(file_vec.data(), file_vec.size())) {
+        ERROR_MSG(std::string{"ERROR: Unable to write frequency tables to "} + table_path.string());
+        return false;
+    }
+#ifdef DEBUG_MODE
+    PRINT_DEBUG(table_path.string() + std::string{": "} + std::to_string(tables_vec.size()) + std::string{" distinct tables for "} +
+                std::to_string(references_vec.size()) + std::string{" references"});
+#endif
+    return true;
+}
+
+//getters
+const std::vector<FrequencyTable>& FrequencyTableWriter::Get_Tables() const {return tables_vec;}
+
+const std::vector<FrequencyTableReference>& FrequencyTableWriter::Get_References() const {return references_vec;}
+
+const bool FrequencyTableWriter::Get_Default_Zstd_Framing() {
+    const char* frequency_zstd = std::getenv("GEOBIN_FREQUENCY_ZSTD");
+    return frequency_zstd != nullptr && std::string{frequency_zstd} != "0";
+}
+
+
+// FrequencyTableReader
+std::unique_ptr<FrequencyTableReader> FrequencyTableReader::Read(const std::filesystem::path& table_path) {
+    std::ifstream table_file(table_path, std::ios::binary);
+    if(!table_file) {
+        return nullptr;
+    }
+    std::vector<char> file_vec((std::istreambuf_iterator<char>(table_file)), std::istreambuf_iterator<char>());
+
+    const size_t magic_length = std::strlen(GEOBIN_FREQUENCY_TABLE_MAGIC);
+    if(file_vec.size() < magic_length || std::memcmp(file_vec.data(), GEOBIN_FREQUENCY_TABLE_MAGIC, magic_length) != 0) {
+        return nullptr;
+    }
+    size_t offset = magic_length;
+    uint64_t version = 0;
+    if(!Read_Varint(file_vec, offset, version) || version != GEOBIN_FREQUENCY_TABLE_VERSION || offset >= file_vec.size()) {
+        return nullptr;
+    }
+    const uint8_t flags = static_cast<uint8_t>(file_vec[offset++]);
+
+    std::vector<char> payload_vec;
+    if(flags & FREQUENCY_TABLE_FLAG_ZSTD) {
+#ifdef GEOBIN_HAVE_ZSTD
+        const unsigned long long payload_size = ZSTD_getFrameContentSize(file_vec.data() + offset, file_vec.size() - offset);
+        if(payload_size == ZSTD_CONTENTSIZE_ERROR || payload_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+            return nullptr;
+        }
+        payload_vec.resize(payload_size);
+        const size_t decompressed_size = ZSTD_decompress(payload_vec.data(), payload_vec.size(), file_vec.data() + offset, file_vec.size() - offset);
+        if(ZSTD_isError(decompressed_size) || decompressed_size != payload_size) {
+            return nullptr;
+        }
+#else
+        return nullptr;
+#endif
+    } else {
+        payload_vec.assign(file_vec.begin() + offset, file_vec.end());
+    }
+
+    auto reader = std::make_unique<FrequencyTableReader>();
+    offset = 0;
+    uint64_t number_of_tables = 0;
+    if(!Read_Varint(payload_vec, offset, number_of_tables) || number_of_tables > payload_vec.size()) {
+        return nullptr;
+    }
+    reader->tables_vec.resize(number_of_tables);
+    for(auto& table : reader->tables_vec) {
+        uint64_t number_of_symbols = 0;
+        if(offset >= payload_vec.size()) {
+            return nullptr;
+        }
+        table.data_type_size = static_cast<uint8_t>(payload_vec[offset++]);
+        if(!Read_Varint(payload_vec, offset, number_of_symbols) || number_of_symbols > payload_vec.size()) {
+            return nullptr;
+        }
+        table.symbol_count_vec.resize(number_of_symbols);
+        uint64_t previous_count = 0;
+        for(uint64_t i = 0; i < number_of_symbols; i++) {
+            uint64_t symbol = 0;
+            uint64_t count_delta = 0;
+            if(!Read_Varint(payload_vec, offset, symbol) || !Read_Varint(payload_vec, offset, count_delta)) {
+                return nullptr;
+            }
+            const uint64_t count = (i == 0) ? count_delta : (previous_count - count_delta);
+            table.symbol_count_vec[i] = {static_cast<uint32_t>(symbol), count};
+            previous_count = count;
+        }
+    }
+
+    uint64_t number_of_references = 0;
+    if(!Read_Varint(payload_vec, offset, number_of_references) || number_of_references > payload_vec.size()) {
+        return nullptr;
+    }
+    std::string source;
+    reader->references_vec.resize(number_of_references);
+    for(auto& reference : reader->references_vec) {
+        if(offset >= payload_vec.size()) {
+            return nullptr;
+        }
+        if(payload_vec[offset++] != 0) {
+            uint64_t source_length = 0;
+            if(!Read_Varint(payload_vec, offset, source_length) || offset + source_length > payload_vec.size()) {
+                return nullptr;
+            }
+            source.assign(payload_vec.data() + offset, source_length);
+            offset += source_length;
+        }
+        if(offset >= payload_vec.size()) {
+            return nullptr;
+        }
+        reference.source = source;
+        reference.scope = static_cast<Frequency_Table_Scope>(payload_vec[offset++]);
+        uint64_t index_span = 0;
+        uint64_t table_id = 0;
+        if(!Read_Varint(payload_vec, offset, reference.first_index) || !Read_Varint(payload_vec, offset, index_span) ||
+           !Read_Varint(payload_vec, offset, table_id) || table_id >= number_of_tables) {
+            return nullptr;
+        }
+        reference.last_index = reference.first_index + index_span;
+        reference.table_id = static_cast<uint32_t>(table_id);
+    }
+    return reader;
+}
+
+const FrequencyTable* FrequencyTableReader::Find_Table(const Frequency_Table_Scope& scope, const uint64_t& index) const {
+    // references are written in index order per scope, and a file holds few of them after merging
+    for(const auto& reference : references_vec) {
+        if(reference.scope == scope && reference.first_index <= index && index <= reference.last_index) {
+            return &tables_vec[reference.table_id];
+        }
+    }
+    return nullptr;
+}
+
+//getters
+const std::vector<FrequencyTable>& FrequencyTableReader::Get_Tables() const {return tables_vec;}
+
+const std::vector<FrequencyTableReference>& FrequencyTableReader::Get_References() const {return references_vec;}
+
+
+const bool Export_Frequency_Tables_To_Json(const std::filesystem::path& table_path, const std::filesystem::path& json_path) {
+    const std::unique_ptr<FrequencyTableReader> reader = FrequencyTableReader::Read(table_path);
+    if(reader == nullptr) {
+        return false;
+    }
+    // the lookup table keeps the shape of the old json dumps, symbol -> index
+    json tables_json = json::array();
+    for(size_t table_id = 0; table_id < reader->Get_Tables().size(); table_id++) {
+        const FrequencyTable& table = reader->Get_Tables()[table_id];
+        json lookup_table_json = json::object();
+        json counts_json = json::object();
+        for(size_t i = 0; i < table.symbol_count_vec.size(); i++) {
+            const std::string symbol_key = std::to_string(table.symbol_count_vec[i].first);
+            lookup_table_json[symbol_key] = i;
+            counts_json[symbol_key] = table.symbol_count_vec[i].second;
+        }
+        tables_json.push_back(json{{"table_id", table_id}, {"data_type_size", table.data_type_size},
+                                   {"total_amount_of_unique_bytes", table.symbol_count_vec.size()},
+                                   {"lookup_table", lookup_table_json}, {"counts", counts_json}});
+    }
+    json references_json = json::array();
+    for(const auto& reference : reader->Get_References()) {
+        references_json.push_back(json{{"source", reference.source}, {"scope", Get_Scope_Name(reference.scope)}, {"first_index", reference.first_index},
+                                       {"last_index", reference.last_index}, {"table_id", reference.table_id}});
+    }
+    std::ofstream json_file(json_path);
+    if(!json_file) {
+        return false;
+    }
+    json_file << std::setw(4) << json{{"tables", tables_json}, {"references", references_json}} << '\n';
+    return static_cast<bool>(json_file);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define GEOBIN_FREQUENCY_TABLE_MAGIC "GEOFREQ"
+#define GEOBIN_FREQUENCY_TABLE_VERSION 2
+// set in the header when the payload after it is a single zstd frame
+#define FREQUENCY_TABLE_FLAG_ZSTD 0x01
+
+enum class Frequency_Table_Scope : uint8_t {
+    row,
+    block,
+    file
+};
+
+// one distinct symbol distribution
+struct FrequencyTable {
+    uint8_t data_type_size = 1;
+    // in the writer's input: ascending symbols. stored and read back: most frequent first (ties by symbol),
+    // so a symbol's position is its lookup index
+    std::vector<std::pair<uint32_t, uint64_t>> symbol_count_vec;
+
+    const bool Has_Same_Counts(const FrequencyTable& other) const;
+    const uint64_t Get_Total_Count() const;
+};
+
+// rows (or blocks) first_index..last_index of one geobin all have the distribution table_id
+struct FrequencyTableReference {
+    // the binary path with separators replaced, the key the json dumps used
+    std::string source;
+    Frequency_Table_Scope scope = Frequency_Table_Scope::row;
+    uint64_t first_index = 0;
+    uint64_t last_index = 0;
+    uint32_t table_id = 0;
+};
+
+// 64 bit content hash of a table in ascending symbol order, built from the xxh64 round and avalanche
+const uint64_t Get_Frequency_Table_Hash(const FrequencyTable& table);
+
+// deduplicates tables by content hash so only distinct distributions are stored and sorted by frequency, rows keep a table id.
+// everything is written once on Close (or destruction): the magic, a version and a flags byte, then varint coded
+// tables (counts as differences from the previous count) and references
+class FrequencyTableWriter {
+    public:
+        // Constructors
+        // zstd framing is only honoured in builds with GEOBIN_HAVE_ZSTD, GEOBIN_FREQUENCY_ZSTD turns it on by default
+        FrequencyTableWriter(const std::filesystem::path& table_path, const bool& zstd_framed = Get_Default_Zstd_Framing());
+        ~FrequencyTableWriter();
+
+        // table must be in ascending symbol order, returns its id. the next index of the same source and scope with
+        // the same table extends that scope's previous reference instead of adding one, scopes may be interleaved
+        const uint32_t Append_Table(const std::string& source, const Frequency_Table_Scope& scope, const uint64_t& index, const FrequencyTable& table);
+        // nothing is written (and an old file is removed) when no table was appended, false if the write failed
+        const bool Close();
+
+        //getters
+        const std::vector<FrequencyTable>& Get_Tables() const;
+        const std::vector<FrequencyTableReference>& Get_References() const;
+        static const bool Get_Default_Zstd_Framing();
+
+    private:
+        std::filesystem::path table_path;
+        bool zstd_framed = false;
+        bool closed = false;
+        std::vector<FrequencyTable> tables_vec;
+        std::vector<FrequencyTableReference> references_vec;
+        // the last reference appended per scope, -1 before the first
+        std::array<int64_t, 3> last_reference_index_arr{-1, -1, -1};
+        // hash -> ids of the tables with that hash, the tables stay in ascending symbol order until Close
+        std::unordered_map<uint64_t, std::vector<uint32_t>> table_ids_by_hash_map;
+};
+
+class FrequencyTableReader {
+    public:
+        // Constructors
+        FrequencyTableReader() = default;
+
+        // nullptr if the file is missing, from another version, truncated or zstd framed in a build without zstd
+        static std::unique_ptr<FrequencyTableReader> Read(const std::filesystem::path& table_path);
+        // the table covering index in the given scope, nullptr if there is none
+        const FrequencyTable* Find_Table(const Frequency_Table_Scope& scope, const uint64_t& index) const;
+
+        //getters
+        const std::vector<FrequencyTable>& Get_Tables() const;
+        const std::vector<FrequencyTableReference>& Get_References() const;
+
+    private:
+        std::vector<FrequencyTable> tables_vec;
+        std::vector<FrequencyTableReference> references_vec;
+};
+
+// writes the tables (lookup table and counts) and the references as json for inspection, false if the table file is unreadable
+const bool Export_Frequency_Tables_To_Json(const std::filesystem::path& table_path, const std::filesystem::path& json_path);
@@ -0,0 +1,385 @@
+#include "geobin_catalog.hpp"
+#include "common_stats.hpp"
+#include "directory_walker.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+
+static const GeobinCatalog* active_catalog = nullptr;
+
+// little endian fixed width fields, strings are a uint32 length and the bytes
+template <typename T>
+static void Append_Value(std::vector<char>& buffer_vec, const T& value) {
+    const size_t offset = buffer_vec.size();
+    buffer_vec.resize(offset + sizeof(T));
+    std::memcpy(&buffer_vec[offset], &value, sizeof(T));
+}
+
+static void Append_String(std::vector<char>& buffer_vec, const std::string& text) {
+    Append_Value(buffer_vec, static_cast<uint32_t>(text.size()));
+    buffer_vec.insert(buffer_vec.end(), text.begin(), text.end());
+}
+
+// reader side, every read checks the bounds so a truncated file is rejected instead of read past
+struct CatalogReader {
+    const std::vector<char>& buffer_vec;
+    size_t offset = 0;
+    bool failed = false;
+
+    template <typename T>
+    T Read_Value() {
+        T value{};
+        if(offset + sizeof(T) > buffer_vec.size()) {
+            failed = true;
+            return value;
+        }
+        std::memcpy(&value, &buffer_vec[offset], sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    std::string Read_String() {
+        const uint32_t length = Read_Value<uint32_t>();
+        if(failed || offset + length > buffer_vec.size()) {
+            failed = true;
+            return std::string{};
+        }
+        std::string text(&buffer_vec[offset], length);
+        offset += length;
+        return text;
+    }
+};
+
+// the number after the last occurrence of delimiter, same rules as the old filename lambdas
+static bool Parse_Number_After(const std::string& stem, const char* delimiter, uint8_t& number) {
+    const size_t position = stem.rfind(delimiter);
+    if(position == std::string::npos) {
+        return false;
+    }
+    size_t index = position + std::strlen(delimiter);
+    while(index < stem.size() && (stem[index] < '0' || stem[index] > '9')) {
+        index++;
+    }
+    if(index == stem.size()) {
+        return false;
+    }
+    uint32_t value = 0;
+    for(; index < stem.size() && stem[index] >= '0' && stem[index] <= '9'; index++) {
+        value = value * 10 + static_cast<uint32_t>(stem[index] - '0');
+    }
+    number = static_cast<uint8_t>(value);
+    return true;
+}
+
+const bool Parse_Geobin_File_Name(const std::string& stem, uint8_t& side, uint8_t& c_number, uint8_t& lod_number) {
+    return Parse_Number_After(stem, "_lod", lod_number) && Parse_Number_After(stem, "_s", side) && Parse_Number_After(stem, "_c", c_number);
+}
+
+const bool Is_Path_Under(const std::filesystem::path& path, const std::filesystem::path& root_path) {
+    const std::string path_string = path.string();
+    const std::string prefix = root_path.string();
+    return path_string.compare(0, prefix.size(), prefix) == 0 &&
+           (path_string.size() == prefix.size() || path_string[prefix.size()] == '/' || (!prefix.empty() && prefix.back() == '/'));
+}
+
+
+std::unique_ptr<GeobinCatalog> GeobinCatalog::Build(const std::filesystem::path& root_path) {
+    auto catalog = std::make_unique<GeobinCatalog>();
+    catalog->root_path = root_path;
+
+    // one parallel walk, sizes are read by the walker threads while each directory is open
+    for(const auto& walked_directory : DirectoryWalker(0, true).Walk(root_path)) {
+        if(!walked_directory.Has_Geobin_And_Geometa()) {
+            continue;
+        }
+        CatalogDirectory directory;
+        directory.directory_path = walked_directory.directory_path;
+        directory.geometa_path = walked_directory.directory_path / walked_directory.geometa_name_vec.front();
+        // the active catalog is set aside while building so this is always the real json read
+        CommonStats geometa_stats;
+        const GeobinCatalog* previous_catalog = Get_Active_Geobin_Catalog();
+        Set_Active_Geobin_Catalog(nullptr);
+        geometa_stats.Set_Data_Type_Size_And_Side_Resolutions(directory.geometa_path);
+        Set_Active_Geobin_Catalog(previous_catalog);
+        directory.data_type_size = static_cast<int8_t>(geometa_stats.Get_Data_Type_Size());
+        directory.floating_point_samples = geometa_stats.Get_Floating_Point_Samples() ? 1 : 0;
+        directory.side_resolutions = geometa_stats.Get_Side_Resolutions();
+        directory.first_entry = static_cast<uint32_t>(catalog->entries_vec.size());
+
+        for(size_t i = 0; i < walked_directory.geobin_name_vec.size(); i++) {
+            CatalogEntry entry;
+            entry.file_name = walked_directory.geobin_name_vec[i];
+            entry.directory_index = static_cast<uint32_t>(catalog->directories_vec.size());
+            const std::string stem = std::filesystem::path{entry.file_name}.stem().string();
+            // kept either way, so the catalog lists the same files as a walk of the directory would
+            if(!Parse_Geobin_File_Name(stem, entry.side, entry.c_number, entry.lod_number)) {
+                entry.side = CATALOG_UNKNOWN_NUMBER;
+                entry.c_number = CATALOG_UNKNOWN_NUMBER;
+                entry.lod_number = CATALOG_UNKNOWN_NUMBER;
+            }
+            entry.file_size = walked_directory.geobin_size_vec[i];
+            catalog->entries_vec.push_back(std::move(entry));
+        }
+        directory.number_of_entries = static_cast<uint32_t>(catalog->entries_vec.size()) - directory.first_entry;
+        catalog->directories_vec.push_back(std::move(directory));
+    }
+    catalog->Index();
+    return catalog;
+}
+
+std::unique_ptr<GeobinCatalog> GeobinCatalog::Read(const std::filesystem::path& catalog_path) {
+    std::ifstream catalog_file(catalog_path, std::ios::binary);
+    if(!catalog_file) {
+        return nullptr;
+    }
+    const std::vector<char> buffer_vec((std::istreambuf_iterator<char>(catalog_file)), std::istreambuf_iterator<char>());
+    CatalogReader reader{buffer_vec};
+
+    const size_t magic_length = std::strlen(GEOBIN_CATALOG_MAGIC);
+    if(buffer_vec.size() < magic_length || std::memcmp(buffer_vec.data(), GEOBIN_CATALOG_MAGIC, magic_length) != 0) {
+        return nullptr;
+    }
+    reader.offset = magic_length;
+    if(reader.Read_Value<uint32_t>() != GEOBIN_CATALOG_VERSION) {
+        return nullptr;
+    }
+
+    auto catalog = std::make_unique<GeobinCatalog>();
+    catalog->root_path = std::filesystem::path{reader.Read_String()};
+    const uint32_t number_of_directories = reader.Read_Value<uint32_t>();
+    const uint32_t number_of_entries = reader.Read_Value<uint32_t>();
+    if(reader.failed) {
+        return nullptr;
+    }
+
+    catalog->directories_vec.resize(number_of_directories);
+    for(auto& directory : catalog->directories_vec) {
+        directory.directory_path = std::filesystem::path{reader.Read_String()};
+        directory.geometa_path = directory.directory_path / reader.Read_String();
+        directory.data_type_size = reader.Read_Value<int8_t>();
+        directory.floating_point_samples = reader.Read_Value<uint8_t>();
+        for(auto& side_arr : directory.side_resolutions) {
+            for(auto& resolution : side_arr) {
+                resolution = reader.Read_Value<uint16_t>();
+            }
+        }
+        directory.first_entry = reader.Read_Value<uint32_t>();
+        directory.number_of_entries = reader.Read_Value<uint32_t>();
+        if(reader.failed) {
+            return nullptr;
+        }
+    }
+
+    catalog->entries_vec.resize(number_of_entries);
+    for(auto& entry : catalog->entries_vec) {
+        entry.directory_index = reader.Read_Value<uint32_t>();
+        entry.file_name = reader.Read_String();
+        entry.side = reader.Read_Value<uint8_t>();
+        entry.c_number = reader.Read_Value<uint8_t>();
+        entry.lod_number = reader.Read_Value<uint8_t>();
+        entry.file_size = reader.Read_Value<uint64_t>();
+        if(reader.failed || entry.directory_index >= number_of_directories) {
+            return nullptr;
+        }
+    }
+    catalog->Index();
+    return catalog;
+}
+
+// magic, version, root, counts, then the directories and the entries, all in one write
+const bool GeobinCatalog::Write(const std::filesystem::path& catalog_path) const {
+    std::vector<char> buffer_vec(GEOBIN_CATALOG_MAGIC, GEOBIN_CATALOG_MAGIC + std::strlen(GEOBIN_CATALOG_MAGIC));
+    Append_Value(buffer_vec, static_cast<uint32_t>(GEOBIN_CATALOG_VERSION));
+    Append_String(buffer_vec, root_path.string());
+    Append_Value(buffer_vec, static_cast<uint32_t>(directories_vec.size()));
+    Append_Value(buffer_vec, static_cast<uint32_t>(entries_vec.size()));
+    for(const auto& directory : directories_vec) {
+        Append_String(buffer_vec, directory.directory_path.string());
+        Append_String(buffer_vec, directory.geometa_path.filename().string());
+        Append_Value(buffer_vec, directory.data_type_size);
+        Append_Value(buffer_vec, directory.floating_point_samples);
+        for(const auto& side_arr : directory.side_resolutions) {
+            for(const auto& resolution : side_arr) {
+                Append_Value(buffer_vec, resolution);
+            }
+        }
+        Append_Value(buffer_vec, directory.first_entry);
+        Append_Value(buffer_vec, directory.number_of_entries);
+    }
+    for(const auto& entry : entries_vec) {
+        Append_Value(buffer_vec, entry.directory_index);
+        Append_String(buffer_vec, entry.file_name);
+        Append_Value(buffer_vec, entry.side);
+        Append_Value(buffer_vec, entry.c_number);
+        Append_Value(buffer_vec, entry.lod_number);
+        Append_Value(buffer_vec, entry.file_size);
+    }
+
+    if(catalog_path.has_parent_path()) {
+        std::error_code error_code;
+        std::filesystem::create_directories(catalog_path.parent_path(), error_code);
+    }
+    // written next to the target and renamed, so a reader never sees half a catalog
+    const std::filesystem::path temporary_path = catalog_path.string() + std::string{".tmp"};
+    {
+        std::ofstream catalog_file(temporary_path, std::ios::binary | std::ios::trunc);
+        if(!catalog_file.write(buffer_vec.data(), buffer_vec.size())) {
+            return false;
+        }
+    }
+    std::error_code error_code;
+    std::filesystem::rename(temporary_path, catalog_path, error_code);
+    return !error_code;
+}
+
+void GeobinCatalog::Index() {
+    directory_index_map.clear();
+    geometa_index_map.clear();
+    entry_index_map.clear();
+    for(uint32_t index = 0; index < directories_vec.size(); index++) {
+        directory_index_map.emplace(directories_vec[index].directory_path.string(), index);
+        geometa_index_map.emplace(directories_vec[index].geometa_path.string(), index);
+    }
+    for(uint32_t index = 0; index < entries_vec.size(); index++) {
+        entry_index_map.emplace(Get_Entry_Path(entries_vec[index]).string(), index);
+    }
+}
+
+const CatalogDirectory* GeobinCatalog::Find_Directory(const std::filesystem::path& directory_path) const {
+    const auto it = directory_index_map.find(directory_path.string());
+    return (it != directory_index_map.end()) ? &directories_vec[it->second] : nullptr;
+}
+
+const CatalogDirectory* GeobinCatalog::Find_Directory_By_Geometa(const std::filesystem::path& geometa_path) const {
+    const auto it = geometa_index_map.find(geometa_path.string());
+    return (it != geometa_index_map.end()) ? &directories_vec[it->second] : nullptr;
+}
+
+const CatalogEntry* GeobinCatalog::Find_Entry(const std::filesystem::path& geobin_path) const {
+    auto it = entry_index_map.find(geobin_path.string());
+    if(it == entry_index_map.end()) {
+        it = entry_index_map.find(geobin_path.string() + std::string{".geobin"});
+    }
+    return (it != entry_index_map.end()) ? &entries_vec[it->second] : nullptr;
+}
+
+const CatalogEntry* GeobinCatalog::Find_Parent_Entry(const CatalogEntry& entry) const {
+    if(entry.lod_number == 0 || entry.lod_number == CATALOG_UNKNOWN_NUMBER) {
+        return nullptr;
+    }
+    const CatalogDirectory& directory = directories_vec[entry.directory_index];
+    for(uint32_t index = directory.first_entry; index < directory.first_entry + directory.number_of_entries; index++) {
+        const CatalogEntry& candidate = entries_vec[index];
+        if(candidate.side == entry.side && candidate.c_number == entry.c_number && candidate.lod_number + 1 == entry.lod_number) {
+            return &candidate;
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<const CatalogEntry*> GeobinCatalog::Find_Side_Entries(const CatalogEntry& entry) const {
+    std::vector<const CatalogEntry*> side_entries_vec;
+    if(entry.lod_number == CATALOG_UNKNOWN_NUMBER) {
+        side_entries_vec.push_back(&entry);
+        return side_entries_vec;
+    }
+    const CatalogDirectory& directory = directories_vec[entry.directory_index];
+    for(uint32_t index = directory.first_entry; index < directory.first_entry + directory.number_of_entries; index++) {
+        const CatalogEntry& candidate = entries_vec[index];
+        if(candidate.c_number == entry.c_number && candidate.lod_number == entry.lod_number) {
+            side_entries_vec.push_back(&candidate);
+        }
+    }
+    std::stable_sort(side_entries_vec.begin(), side_entries_vec.end(), [](const CatalogEntry* a, const CatalogEntry* b) {
+        return a->side < b->side;
+    });
+    return side_entries_vec;
+}
+
+//getters
+const std::filesystem::path& GeobinCatalog::Get_Root_Path() const {return root_path;}
+
+const std::vector<CatalogDirectory>& GeobinCatalog::Get_Directories() const {return directories_vec;}
+
+const std::vector<CatalogEntry>& GeobinCatalog::Get_Entries() const {return entries_vec;}
+
+const std::vector<std::filesystem::path> GeobinCatalog::Get_Directory_Path_Vec(const std::filesystem::path& dir_path) const {
+    std::vector<std::filesystem::path> directory_path_vec;
+    for(const auto& directory : directories_vec) {
+        if(Is_Path_Under(directory.directory_path, dir_path)) {
+            directory_path_vec.push_back(directory.directory_path);
+        }
+    }
+    return directory_path_vec;
+}
+
+const std::vector<std::filesystem::path> GeobinCatalog::Get_Geobin_File_Vec(const CatalogDirectory& directory) const {
+    std::vector<std::filesystem::path> geobin_files_vec;
+    geobin_files_vec.reserve(directory.number_of_entries);
+    for(uint32_t index = directory.first_entry; index < directory.first_entry + directory.number_of_entries; index++) {
+        geobin_files_vec.push_back(directory.directory_path / entries_vec[index].file_name);
+    }
+    return geobin_files_vec;
+}
+
+const std::filesystem::path GeobinCatalog::Get_Entry_Path(const CatalogEntry& entry) const {
+    return directories_vec[entry.directory_index].directory_path / entry.file_name;
+}
+
+std::filesystem::path GeobinCatalog::Get_Default_Catalog_Path(const std::filesystem::path& root_path) {
+    if(const char* catalog_path = std::getenv("GEOBIN_CATALOG")) {
+        return std::filesystem::path{catalog_path};
+    }
+    return std::filesystem::path{DEFAULT_GEOBIN_CATALOG_DIRECTORY} / (Remove_all_Seperators_From_Path(root_path).string() + std::string{".catalog"});
+}
+
+
+void Set_Active_Geobin_Catalog(const GeobinCatalog* catalog) {
+    active_catalog = catalog;
+}
+
+const GeobinCatalog* Get_Active_Geobin_Catalog() {
+    return active_catalog;
+}
+
+const GeobinCatalog& Load_And_Activate_Geobin_Catalog(const std::filesystem::path& root_path, const bool& rebuild) {
+    // one catalog per process, the previous one stays valid until the next load replaces it
+    static std::unique_ptr<GeobinCatalog> loaded_catalog;
+    Set_Active_Geobin_Catalog(nullptr);
+
+    const std::filesystem::path catalog_path = GeobinCatalog::Get_Default_Catalog_Path(root_path);
+    std::unique_ptr<GeobinCatalog> catalog = rebuild ? nullptr : GeobinCatalog::Read(catalog_path);
+    if(catalog == nullptr || catalog->Get_Root_Path() != root_path) {
+        catalog = GeobinCatalog::Build(root_path);
+        if(!catalog->Write(catalog_path)) {
+            ERROR_MSG(std::string{"WARNING: unable to save the catalog to "} + catalog_path.string() + std::string{", it will be rebuilt next run"});
+        }
+    }
+#ifdef DEBUG_MODE
+    PRINT_DEBUG(std::string{"Catalog for "} + root_path.string() + std::string{": "} + std::to_string(catalog->Get_Directories().size()) +
+                std::string{" directories, "} + std::to_string(catalog->Get_Entries().size()) + std::string{" files"});
+#endif
+    loaded_catalog = std::move(catalog);
+    Set_Active_Geobin_Catalog(loaded_catalog.get());
+    return *loaded_catalog;
+}
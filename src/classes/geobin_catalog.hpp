@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define GEOBIN_CATALOG_MAGIC "GEOBCAT"
+#define GEOBIN_CATALOG_VERSION 3
+#define DEFAULT_GEOBIN_CATALOG_DIRECTORY "geobin_catalogs"
+// side, c and lod of a geobin whose name does not carry them
+#define CATALOG_UNKNOWN_NUMBER 0xFF
+
+// a directory that holds a geometa and geobin files, with the geometa already parsed
+struct CatalogDirectory {
+    std::filesystem::path directory_path;
+    std::filesystem::path geometa_path;
+    int8_t data_type_size = 0;
+    uint8_t floating_point_samples = 0;
+    std::array<std::array<uint16_t, 4>, 6> side_resolutions{};
+    // entries of this directory are entries_vec[first_entry, first_entry + number_of_entries)
+    uint32_t first_entry = 0;
+    uint32_t number_of_entries = 0;
+};
+
+// one geobin file, side/c/lod parsed out of <layer>_s<side>_c<c>_lod<lod>.geobin once at build time,
+// all three CATALOG_UNKNOWN_NUMBER when the name does not follow that pattern
+struct CatalogEntry {
+    std::string file_name;
+    uint32_t directory_index = 0;
+    uint8_t side = CATALOG_UNKNOWN_NUMBER;
+    uint8_t c_number = CATALOG_UNKNOWN_NUMBER;
+    uint8_t lod_number = CATALOG_UNKNOWN_NUMBER;
+    uint64_t file_size = 0;
+};
+
+// everything the runs need to know about a planet tree, built in one walk and saved as a compact binary file.
+// the catalog is not revalidated on load, rebuild it (geobin_compression catalog <dir>) after adding or removing files
+class GeobinCatalog {
+    public:
+        // Constructors
+        GeobinCatalog() = default;
+
+        // walks root_path once, parses every geometa and file name, file sizes come from the same walk
+        static std::unique_ptr<GeobinCatalog> Build(const std::filesystem::path& root_path);
+        // nullptr if the file is missing, from another version or truncated
+        static std::unique_ptr<GeobinCatalog> Read(const std::filesystem::path& catalog_path);
+        const bool Write(const std::filesystem::path& catalog_path) const;
+
+        const CatalogDirectory* Find_Directory(const std::filesystem::path& directory_path) const;
+        const CatalogDirectory* Find_Directory_By_Geometa(const std::filesystem::path& geometa_path) const;
+        // by the file's path (directory path / file name, as walked) or that path without .geobin, so only the
+        // entry of that directory matches, corpora with the same layer names never shadow each other
+        const CatalogEntry* Find_Entry(const std::filesystem::path& geobin_path) const;
+        // the same side and c one lod coarser in the same directory, nullptr for lod 0, unknown names or when it is missing
+        const CatalogEntry* Find_Parent_Entry(const CatalogEntry& entry) const;
+        // every side's entry with the same c and lod in the same directory, ascending side, entry itself included.
+        // an entry with an unknown name is only grouped with itself
+        const std::vector<const CatalogEntry*> Find_Side_Entries(const CatalogEntry& entry) const;
+
+        //getters
+        const std::filesystem::path& Get_Root_Path() const;
+        const std::vector<CatalogDirectory>& Get_Directories() const;
+        const std::vector<CatalogEntry>& Get_Entries() const;
+        // directories under (or equal to) dir_path, in catalog order
+        const std::vector<std::filesystem::path> Get_Directory_Path_Vec(const std::filesystem::path& dir_path) const;
+        const std::vector<std::filesystem::path> Get_Geobin_File_Vec(const CatalogDirectory& directory) const;
+        const std::filesystem::path Get_Entry_Path(const CatalogEntry& entry) const;
+        // GEOBIN_CATALOG when set, geobin_catalogs/<root with separators removed>.catalog otherwise
+        static std::filesystem::path Get_Default_Catalog_Path(const std::filesystem::path& root_path);
+
+    private:
+        void Index();
+
+        std::filesystem::path root_path;
+        std::vector<CatalogDirectory> directories_vec;
+        std::vector<CatalogEntry> entries_vec;
+        // lookups, rebuilt after Build and Read
+        std::unordered_map<std::string, uint32_t> directory_index_map;
+        std::unordered_map<std::string, uint32_t> geometa_index_map;
+        // keyed by Get_Entry_Path
+        std::unordered_map<std::string, uint32_t> entry_index_map;
+};
+
+// pulls side, c and lod out of a geobin stem, false if one of them is missing
+const bool Parse_Geobin_File_Name(const std::string& stem, uint8_t& side, uint8_t& c_number, uint8_t& lod_number);
+// path is root_path or below it, a whole component at a time so PlanetData2 is not under PlanetData
+const bool Is_Path_Under(const std::filesystem::path& path, const std::filesystem::path& root_path);
+
+// while a catalog is active the directory helpers in file_functions, Get_Side_Resolution and
+// Set_Data_Type_Size_And_Side_Resolutions answer from it instead of touching the file system
+void Set_Active_Geobin_Catalog(const GeobinCatalog* catalog);
+const GeobinCatalog* Get_Active_Geobin_Catalog();
+// reads the tree's saved catalog (building and saving it when missing or for another root) and activates it
+const GeobinCatalog& Load_And_Activate_Geobin_Catalog(const std::filesystem::path& root_path, const bool& rebuild = false);
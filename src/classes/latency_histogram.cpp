@@ -0,0 +1,92 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+
+void LatencyHistogram::Record(const uint64_t& value) {
+    bucket_counts_arr[Get_Bucket_Index(value)].fetch_add(1, std::memory_order_relaxed);
+    total_count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current_max = max_value.load(std::memory_order_relaxed);
+    while(value > current_max && !max_value.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for(size_t bucket = 0; bucket < bucket_counts_arr.size(); bucket++) {
+        const uint64_t count = other.bucket_counts_arr[bucket].load(std::memory_order_relaxed);
+        if(count != 0) {
+            bucket_counts_arr[bucket].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    total_count.fetch_add(other.Get_Count(), std::memory_order_relaxed);
+
+    const uint64_t other_max = other.Get_Max();
+    uint64_t current_max = max_value.load(std::memory_order_relaxed);
+    while(other_max > current_max && !max_value.compare_exchange_weak(current_max, other_max, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::Reset() {
+    for(auto& count : bucket_counts_arr) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    total_count.store(0, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+const size_t LatencyHistogram::Get_Bucket_Index(const uint64_t& value) {
+    if(value < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    // keep the top HISTOGRAM_SUB_BUCKET_BITS + 1 bits, the shift picks the power of two
+    const int shift = (63 - std::countl_zero(value)) - HISTOGRAM_SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift) * HISTOGRAM_SUB_BUCKETS + static_cast<size_t>(value >> shift);
+}
+
+const uint64_t LatencyHistogram::Get_Bucket_Upper_Value(const size_t& bucket_index) {
+    if(bucket_index < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return static_cast<uint64_t>(bucket_index);
+    }
+    const int shift = static_cast<int>(bucket_index / HISTOGRAM_SUB_BUCKETS) - 1;
+    const uint64_t top_bits = static_cast<uint64_t>(bucket_index % HISTOGRAM_SUB_BUCKETS) + HISTOGRAM_SUB_BUCKETS;
+    return ((top_bits + 1) << shift) - 1;
+}
+
+//getters
+const uint64_t LatencyHistogram::Get_Count() const {return total_count.load(std::memory_order_relaxed);}
+
+const uint64_t LatencyHistogram::Get_Max() const {return max_value.load(std::memory_order_relaxed);}
+
+const uint64_t LatencyHistogram::Get_Value_At_Percentile(const double& percentile) const {
+    const uint64_t count = Get_Count();
+    if(count == 0) {
+        return 0;
+    }
+    const uint64_t target_count = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count))));
+
+    uint64_t cumulative_count = 0;
+    for(size_t bucket = 0; bucket < bucket_counts_arr.size(); bucket++) {
+        cumulative_count += bucket_counts_arr[bucket].load(std::memory_order_relaxed);
+        if(cumulative_count >= target_count) {
+            return std::min(Get_Bucket_Upper_Value(bucket), Get_Max());
+        }
+    }
+    return Get_Max();
+}
+
+
+LatencyHistogram& Get_Or_Create_Latency_Histogram(std::atomic<LatencyHistogram*>& histogram_ptr) {
+    LatencyHistogram* histogram = histogram_ptr.load(std::memory_order_acquire);
+    if(histogram != nullptr) {
+        return *histogram;
+    }
+    // another thread sharing the shard may win the race, then ours is dropped
+    LatencyHistogram* new_histogram = new LatencyHistogram();
+    if(histogram_ptr.compare_exchange_strong(histogram, new_histogram, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *new_histogram;
+    }
+    delete new_histogram;
+    return *histogram;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// values below 2 * HISTOGRAM_SUB_BUCKETS are counted exactly, above that every power of two
+// is split into HISTOGRAM_SUB_BUCKETS linear buckets, so a reported value is within 1/32 (~3%) of the truth
+#define HISTOGRAM_SUB_BUCKET_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_NUMBER_OF_BUCKETS ((65 - HISTOGRAM_SUB_BUCKET_BITS) * HISTOGRAM_SUB_BUCKETS)
+
+// HDR style log-bucketed histogram covering the full uint64 range in fixed memory
+// Record is wait-free, so threads that end up on the same stats shard can still share one
+class LatencyHistogram {
+    public:
+        LatencyHistogram() = default;
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        void Record(const uint64_t& value);
+        void Merge(const LatencyHistogram& other);
+        void Reset();
+
+        //getters
+        const uint64_t Get_Count() const;
+        const uint64_t Get_Max() const;
+        // highest value equivalent to the bucket holding the percentile-th sample, percentile in [0, 100]
+        const uint64_t Get_Value_At_Percentile(const double& percentile) const;
+
+        static const size_t Get_Bucket_Index(const uint64_t& value);
+        static const uint64_t Get_Bucket_Upper_Value(const size_t& bucket_index);
+
+    private:
+        std::array<std::atomic<uint64_t>, HISTOGRAM_NUMBER_OF_BUCKETS> bucket_counts_arr{};
+        std::atomic<uint64_t> total_count{0};
+        std::atomic<uint64_t> max_value{0};
+};
+
+// shards allocate their histograms the first time a thread records into them
+LatencyHistogram& Get_Or_Create_Latency_Histogram(std::atomic<LatencyHistogram*>& histogram_ptr);
@@ -0,0 +1,120 @@
+#include "memory_tracking.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+
+
+#ifdef GEOBIN_COUNT_ALLOCATIONS
+// plain thread_local integers, no constructors, so they are safe to touch from inside operator new
+static thread_local uint64_t thread_allocations = 0;
+static thread_local uint64_t thread_allocated_bytes = 0;
+
+static void* Counted_Allocate(std::size_t size, const std::size_t& alignment) {
+    thread_allocations++;
+    thread_allocated_bytes += size;
+    if(size == 0) {
+        size = 1;
+    }
+    if(alignment <= alignof(std::max_align_t)) {
+        return std::malloc(size);
+    }
+    // aligned_alloc wants the size to be a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = Counted_Allocate(size, 0);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* ptr = Counted_Allocate(size, static_cast<std::size_t>(alignment));
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {std::free(ptr);}
+void operator delete[](void* ptr) noexcept {std::free(ptr);}
+void operator delete(void* ptr, std::size_t) noexcept {std::free(ptr);}
+void operator delete[](void* ptr, std::size_t) noexcept {std::free(ptr);}
+void operator delete(void* ptr, std::align_val_t) noexcept {std::free(ptr);}
+void operator delete[](void* ptr, std::align_val_t) noexcept {std::free(ptr);}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {std::free(ptr);}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {std::free(ptr);}
+#endif
+
+
+AllocationCounts Get_Thread_Allocation_Counts() {
+#ifdef GEOBIN_COUNT_ALLOCATIONS
+    return AllocationCounts{thread_allocations, thread_allocated_bytes};
+#else
+    return AllocationCounts{};
+#endif
+}
+
+AllocationCounts Get_Thread_Allocations_Since(const AllocationCounts& start_counts) {
+    const AllocationCounts end_counts = Get_Thread_Allocation_Counts();
+    return AllocationCounts{end_counts.allocations - start_counts.allocations, end_counts.bytes - start_counts.bytes};
+}
+
+const bool Is_Allocation_Counting_Enabled() {
+#ifdef GEOBIN_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// value of a "Key:   1234 kB" line in /proc/self/status, 0 if it is not there
+static uint64_t Read_Proc_Status_Kilobytes(const std::string& key) {
+    std::ifstream status_file("/proc/self/status");
+    std::string line;
+    while(std::getline(status_file, line)) {
+        if(line.compare(0, key.size(), key) == 0) {
+            return std::strtoull(line.c_str() + key.size(), nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+const uint64_t Get_Peak_Resident_Set_Bytes() {
+    const uint64_t high_water_kilobytes = Read_Proc_Status_Kilobytes("VmHWM:");
+    if(high_water_kilobytes != 0) {
+        return high_water_kilobytes * 1024;
+    }
+    rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    // ru_maxrss is in kilobytes on linux
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+const uint64_t Get_Current_Resident_Set_Bytes() {
+    return Read_Proc_Status_Kilobytes("VmRSS:") * 1024;
+}
+
+const bool Reset_Peak_Resident_Set() {
+    std::ofstream clear_refs_file("/proc/self/clear_refs");
+    if(!clear_refs_file) {
+        return false;
+    }
+    clear_refs_file << "5";
+    return static_cast<bool>(clear_refs_file.flush());
+}
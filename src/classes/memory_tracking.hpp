@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+// heap allocations made by the calling thread since it started
+// all zero unless built with GEOBIN_COUNT_ALLOCATIONS, which replaces the global operator new/delete
+AllocationCounts Get_Thread_Allocation_Counts();
+AllocationCounts Get_Thread_Allocations_Since(const AllocationCounts& start_counts);
+const bool Is_Allocation_Counting_Enabled();
+
+// process resident set size, high-water mark comes from VmHWM in /proc/self/status (getrusage as a fallback)
+const uint64_t Get_Peak_Resident_Set_Bytes();
+const uint64_t Get_Current_Resident_Set_Bytes();
+// restarts the high-water mark at the current RSS (linux >= 4.0), false if the kernel does not allow it
+const bool Reset_Peak_Resident_Set();
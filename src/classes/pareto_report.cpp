@@ -0,0 +1,288 @@
+#include "pareto_report.hpp"
+#include "codec_pipeline.hpp"
+#include "codec_selector.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define PLOT_WIDTH 520
+#define PLOT_HEIGHT 340
+#define PLOT_MARGIN_LEFT 60
+#define PLOT_MARGIN_RIGHT 20
+#define PLOT_MARGIN_TOP 20
+#define PLOT_MARGIN_BOTTOM 45
+
+
+const double ParetoPoint::Get_Compression_Ratio() const {
+    return static_cast<double>(compressed_bytes) / static_cast<double>(std::max<uint64_t>(original_bytes, 1));
+}
+
+const double ParetoPoint::Get_Encoded_Throughput() const {
+    return static_cast<double>(original_bytes) / std::max(encoded_microseconds, 1e-9);
+}
+
+const double ParetoPoint::Get_Decoded_Throughput() const {
+    return static_cast<double>(original_bytes) / std::max(decoded_microseconds, 1e-9);
+}
+
+static std::string Escape_Html(const std::string& text) {
+    std::string escaped;
+    for(const char character : text) {
+        switch(character) {
+            case '&': escaped += "&amp;"; break;
+            case '<': escaped += "&lt;"; break;
+            case '>': escaped += "&gt;"; break;
+            case '"': escaped += "&quot;"; break;
+            default: escaped += character; break;
+        }
+    }
+    return escaped;
+}
+
+static std::string Quote_Csv(const std::string& field) {
+    std::string quoted = "\"";
+    for(const char character : field) {
+        quoted += (character == '"') ? std::string{"\"\""} : std::string{character};
+    }
+    return quoted + "\"";
+}
+
+// scatter of one group, x is throughput on a log scale, y is the ratio starting at 0
+static std::string Make_Frontier_Svg(const std::vector<const ParetoPoint*>& group_vec, const bool& decode) {
+    auto throughput_of = [&decode](const ParetoPoint* point) {return decode ? point->Get_Decoded_Throughput() : point->Get_Encoded_Throughput();};
+    auto on_frontier = [&decode](const ParetoPoint* point) {return decode ? point->on_decode_frontier : point->on_encode_frontier;};
+
+    double minimum_throughput = throughput_of(group_vec[0]);
+    double maximum_throughput = minimum_throughput;
+    double maximum_ratio = 0.0;
+    for(const ParetoPoint* point : group_vec) {
+        minimum_throughput = std::min(minimum_throughput, throughput_of(point));
+        maximum_throughput = std::max(maximum_throughput, throughput_of(point));
+        maximum_ratio = std::max(maximum_ratio, point->Get_Compression_Ratio());
+    }
+    const double log_minimum = std::floor(std::log10(std::max(minimum_throughput, 1e-6)));
+    const double log_maximum = std::max(std::ceil(std::log10(std::max(maximum_throughput, 1e-6))), log_minimum + 1.0);
+    const double ratio_top = std::max(maximum_ratio * 1.05, 1e-6);
+
+    const double plot_width = PLOT_WIDTH - PLOT_MARGIN_LEFT - PLOT_MARGIN_RIGHT;
+    const double plot_height = PLOT_HEIGHT - PLOT_MARGIN_TOP - PLOT_MARGIN_BOTTOM;
+    auto x_of = [&](const double& throughput) {
+        return PLOT_MARGIN_LEFT + (std::log10(std::max(throughput, 1e-6)) - log_minimum) / (log_maximum - log_minimum) * plot_width;
+    };
+    auto y_of = [&](const double& ratio) {return PLOT_MARGIN_TOP + (1.0 - ratio / ratio_top) * plot_height;};
+
+    std::ostringstream svg;
+    svg << std::fixed << std::setprecision(1);
+    svg << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << PLOT_WIDTH << "\" height=\"" << PLOT_HEIGHT << "\" font-family=\"sans-serif\" font-size=\"10\">\n";
+    // axes, decade ticks on x, five ticks on y
+    svg << "<line x1=\"" << PLOT_MARGIN_LEFT << "\" y1=\"" << PLOT_MARGIN_TOP + plot_height << "\" x2=\"" << PLOT_MARGIN_LEFT + plot_width
+        << "\" y2=\"" << PLOT_MARGIN_TOP + plot_height << "\" stroke=\"#333\"/>\n";
+    svg << "<line x1=\"" << PLOT_MARGIN_LEFT << "\" y1=\"" << PLOT_MARGIN_TOP << "\" x2=\"" << PLOT_MARGIN_LEFT << "\" y2=\"" << PLOT_MARGIN_TOP + plot_height << "\" stroke=\"#333\"/>\n";
+    for(double decade = log_minimum; decade <= log_maximum; decade += 1.0) {
+        const double x = x_of(std::pow(10.0, decade));
+        svg << "<line x1=\"" << x << "\" y1=\"" << PLOT_MARGIN_TOP << "\" x2=\"" << x << "\" y2=\"" << PLOT_MARGIN_TOP + plot_height << "\" stroke=\"#eee\"/>\n";
+        svg << "<text x=\"" << x << "\" y=\"" << PLOT_MARGIN_TOP + plot_height + 14 << "\" text-anchor=\"middle\">" << std::defaultfloat << std::setprecision(12) << std::pow(10.0, decade)
+            << std::fixed << std::setprecision(1) << "</text>\n";
+    }
+    for(int tick = 0; tick <= 5; tick++) {
+        const double ratio = ratio_top * tick / 5.0;
+        svg << "<text x=\"" << PLOT_MARGIN_LEFT - 6 << "\" y=\"" << y_of(ratio) + 3 << "\" text-anchor=\"end\">" << std::setprecision(3) << ratio << std::setprecision(1) << "</text>\n";
+    }
+    svg << "<text x=\"" << PLOT_MARGIN_LEFT + plot_width / 2 << "\" y=\"" << PLOT_HEIGHT - 8 << "\" text-anchor=\"middle\">"
+        << (decode ? "decode" : "encode") << " throughput MB/s (log)</text>\n";
+    svg << "<text transform=\"rotate(-90)\" x=\"" << -(PLOT_MARGIN_TOP + plot_height / 2) << "\" y=\"14\" text-anchor=\"middle\">compressed / original</text>\n";
+
+    std::vector<const ParetoPoint*> frontier_vec;
+    for(const ParetoPoint* point : group_vec) {
+        if(on_frontier(point)) {
+            frontier_vec.push_back(point);
+        }
+    }
+    std::sort(frontier_vec.begin(), frontier_vec.end(), [&](const ParetoPoint* first, const ParetoPoint* second) {return throughput_of(first) < throughput_of(second);});
+    svg << "<polyline fill=\"none\" stroke=\"#d62728\" stroke-width=\"1.5\" points=\"";
+    for(const ParetoPoint* point : frontier_vec) {
+        svg << x_of(throughput_of(point)) << ',' << y_of(point->Get_Compression_Ratio()) << ' ';
+    }
+    svg << "\"/>\n";
+
+    for(const ParetoPoint* point : group_vec) {
+        const double x = x_of(throughput_of(point));
+        const double y = y_of(point->Get_Compression_Ratio());
+        svg << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"4\" fill=\"" << (on_frontier(point) ? "#d62728" : "#1f77b4") << "\"><title>"
+            << Escape_Html(point->spec) << " ratio " << std::setprecision(4) << point->Get_Compression_Ratio() << " " << std::setprecision(1)
+            << throughput_of(point) << " MB/s</title></circle>\n";
+        if(on_frontier(point)) {
+            svg << "<text x=\"" << x + 6 << "\" y=\"" << y - 6 << "\" fill=\"#d62728\">" << Escape_Html(point->spec) << "</text>\n";
+        }
+    }
+    svg << "</svg>\n";
+    return svg.str();
+}
+
+
+//Constructors
+ParetoReport::ParetoReport(const std::vector<std::string>& spec_vec, const int& measured_iterations, const int& warmup_iterations)
+    : spec_vec(spec_vec), measured_iterations(measured_iterations), warmup_iterations(warmup_iterations) {
+    if(spec_vec.empty() || measured_iterations < 1 || warmup_iterations < 0) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: pareto report needs at least one spec and one measured iteration"});
+    }
+}
+
+void ParetoReport::Run_On_Directory_Tree(const std::filesystem::path& root_path) {
+    points_vec.clear();
+    for(const auto& dir_path : Get_Geobin_And_Geometa_Directory_Path_Vec(root_path)) {
+        std::map<int, std::vector<std::filesystem::path>> lod_files_map;
+        for(const auto& file : Get_Geobin_File_Vec(dir_path)) {
+            lod_files_map[Get_Lod_Number(file.stem())].push_back(file);
+        }
+
+        for(const auto& [lod_number, files_vec] : lod_files_map) {
+            for(const auto& spec : spec_vec) {
+                CodecPipeline pipeline(spec);
+                pipeline.Set_Number_Of_Iterations(measured_iterations);
+                pipeline.Set_Warmup_Iterations(warmup_iterations);
+                Run_Pipeline_Compression_Decompression_On_Files(files_vec, pipeline);
+
+                ParetoPoint point;
+                point.layer = dir_path.lexically_relative(root_path).string();
+                point.lod_number = lod_number;
+                point.spec = spec;
+                for(const auto& sample : pipeline.Get_Iteration_Samples()) {
+                    point.original_bytes += sample.original_bytes;
+                    point.compressed_bytes += sample.compressed_bytes;
+                    point.encoded_microseconds += sample.encoded_microseconds;
+                    point.decoded_microseconds += sample.decoded_microseconds;
+                }
+                points_vec.push_back(point);
+#ifdef DEBUG_MODE
+                PRINT_DEBUG(point.layer + std::string{" lod"} + std::to_string(lod_number) + std::string{" "} + spec + std::string{" ratio "} +
+                            std::to_string(point.Get_Compression_Ratio()));
+#endif
+            }
+        }
+    }
+    Mark_Frontiers();
+}
+
+// groups are contiguous in points_vec, quadratic in the number of specs, which is small
+void ParetoReport::Mark_Frontiers() {
+    for(size_t group_start = 0; group_start < points_vec.size();) {
+        size_t group_end = group_start;
+        while(group_end < points_vec.size() && points_vec[group_end].layer == points_vec[group_start].layer &&
+              points_vec[group_end].lod_number == points_vec[group_start].lod_number) {
+            group_end++;
+        }
+
+        for(size_t candidate = group_start; candidate < group_end; candidate++) {
+            bool encode_dominated = false;
+            bool decode_dominated = false;
+            const double ratio = points_vec[candidate].Get_Compression_Ratio();
+            for(size_t other = group_start; other < group_end; other++) {
+                const double other_ratio = points_vec[other].Get_Compression_Ratio();
+                auto dominates = [&](const double& other_throughput, const double& throughput) {
+                    return other_ratio <= ratio && other_throughput >= throughput && (other_ratio < ratio || other_throughput > throughput);
+                };
+                encode_dominated |= dominates(points_vec[other].Get_Encoded_Throughput(), points_vec[candidate].Get_Encoded_Throughput());
+                decode_dominated |= dominates(points_vec[other].Get_Decoded_Throughput(), points_vec[candidate].Get_Decoded_Throughput());
+            }
+            points_vec[candidate].on_encode_frontier = !encode_dominated;
+            points_vec[candidate].on_decode_frontier = !decode_dominated;
+        }
+        group_start = group_end;
+    }
+}
+
+void ParetoReport::Write_Csv(const std::filesystem::path& csv_path) const {
+    std::ofstream csv_file(csv_path);
+    if(!csv_file) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to write "} + csv_path.string());
+    }
+    csv_file << "layer,lod,spec,original_bytes,compressed_bytes,compression_ratio,encoded_megabytes_per_second,decoded_megabytes_per_second,"
+                "encode_frontier,decode_frontier\n";
+    csv_file << std::setprecision(8);
+    for(const auto& point : points_vec) {
+        csv_file << Quote_Csv(point.layer) << ',' << point.lod_number << ',' << Quote_Csv(point.spec) << ',' << point.original_bytes << ','
+                 << point.compressed_bytes << ',' << point.Get_Compression_Ratio() << ',' << point.Get_Encoded_Throughput() << ','
+                 << point.Get_Decoded_Throughput() << ',' << point.on_encode_frontier << ',' << point.on_decode_frontier << '\n';
+    }
+}
+
+void ParetoReport::Write_Html(const std::filesystem::path& html_path) const {
+    std::ofstream html_file(html_path);
+    if(!html_file) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to write "} + html_path.string());
+    }
+    html_file << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>geobin codec pareto frontiers</title>\n"
+                 "<style>body{font-family:sans-serif;margin:20px}table{border-collapse:collapse;font-size:12px}"
+                 "td,th{border:1px solid #ccc;padding:2px 6px;text-align:right}td:first-child{text-align:left}"
+                 ".frontier{color:#d62728;font-weight:bold}.plots{display:flex;flex-wrap:wrap;gap:16px}</style></head><body>\n"
+                 "<h1>Compression ratio vs throughput</h1>\n<p>Lower ratio is better. Red points are on the pareto frontier of their plot. "
+              << measured_iterations << " measured iteration(s) after " << warmup_iterations << " warm-up.</p>\n";
+
+    html_file << std::fixed;
+    for(size_t group_start = 0; group_start < points_vec.size();) {
+        std::vector<const ParetoPoint*> group_vec;
+        size_t group_end = group_start;
+        while(group_end < points_vec.size() && points_vec[group_end].layer == points_vec[group_start].layer &&
+              points_vec[group_end].lod_number == points_vec[group_start].lod_number) {
+            group_vec.push_back(&points_vec[group_end]);
+            group_end++;
+        }
+
+        html_file << "<h2>" << Escape_Html(points_vec[group_start].layer) << " lod " << points_vec[group_start].lod_number << "</h2>\n<div class=\"plots\">\n"
+                  << Make_Frontier_Svg(group_vec, false) << Make_Frontier_Svg(group_vec, true) << "</div>\n";
+        html_file << "<table><tr><th>spec</th><th>ratio</th><th>encode MB/s</th><th>decode MB/s</th><th>frontier</th></tr>\n";
+        for(const ParetoPoint* point : group_vec) {
+            const bool frontier = point->on_encode_frontier || point->on_decode_frontier;
+            html_file << "<tr" << (frontier ? " class=\"frontier\"" : "") << "><td>" << Escape_Html(point->spec) << "</td><td>" << std::setprecision(4)
+                      << point->Get_Compression_Ratio() << "</td><td>" << std::setprecision(1) << point->Get_Encoded_Throughput() << "</td><td>"
+                      << point->Get_Decoded_Throughput() << "</td><td>" << (point->on_encode_frontier ? "encode " : "")
+                      << (point->on_decode_frontier ? "decode" : "") << "</td></tr>\n";
+        }
+        html_file << "</table>\n";
+        group_start = group_end;
+    }
+    html_file << "</body></html>\n";
+}
+
+//getters
+const std::vector<ParetoPoint>& ParetoReport::Get_Points() const {return points_vec;}
+
+const std::vector<std::string> ParetoReport::Get_Registered_Candidate_Specs() {
+    std::vector<std::string> candidate_spec_vec;
+    auto add_spec = [&candidate_spec_vec](const std::string& spec) {
+        if(std::find(candidate_spec_vec.begin(), candidate_spec_vec.end(), spec) == candidate_spec_vec.end()) {
+            candidate_spec_vec.push_back(spec);
+        }
+    };
+    for(const auto& backend : CodecRegistry::Get_Instance().Get_Stage_Names(Stage_Kind::backend)) {
+        add_spec(backend);
+        add_spec(std::string{"delta|"} + backend);
+        add_spec(std::string{"xor|"} + backend);
+    }
+    for(const auto& spec : CodecSelector::Get_Default_Candidate_Specs()) {
+        add_spec(spec);
+    }
+    return candidate_spec_vec;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define DEFAULT_PARETO_MEASURED_ITERATIONS 3
+#define DEFAULT_PARETO_WARMUP_ITERATIONS 1
+
+// one spec over every file of one layer at one lod, totals across the measured iterations
+struct ParetoPoint {
+    std::string layer;
+    int lod_number = 0;
+    std::string spec;
+    uint64_t original_bytes = 0;
+    uint64_t compressed_bytes = 0;
+    double encoded_microseconds = 0.0;
+    double decoded_microseconds = 0.0;
+    // no other spec in the group is at least as small and at least as fast (and better in one of the two)
+    bool on_encode_frontier = false;
+    bool on_decode_frontier = false;
+
+    // compressed / original, lower is better like everywhere else
+    const double Get_Compression_Ratio() const;
+    // bytes per microsecond, which is also MB/s
+    const double Get_Encoded_Throughput() const;
+    const double Get_Decoded_Throughput() const;
+};
+
+// runs every candidate pipeline over a corpus with the in-memory repetition harness, then marks the
+// ratio vs encode throughput and ratio vs decode throughput pareto frontiers of every (layer, lod) group
+class ParetoReport {
+    public:
+        // Constructors
+        ParetoReport(const std::vector<std::string>& spec_vec, const int& measured_iterations = DEFAULT_PARETO_MEASURED_ITERATIONS,
+                     const int& warmup_iterations = DEFAULT_PARETO_WARMUP_ITERATIONS);
+
+        void Run_On_Directory_Tree(const std::filesystem::path& root_path);
+        void Write_Csv(const std::filesystem::path& csv_path) const;
+        // self-contained page, one inline svg scatter per group and direction, frontier points joined and labelled
+        void Write_Html(const std::filesystem::path& html_path) const;
+
+        //getters
+        const std::vector<ParetoPoint>& Get_Points() const;
+        // every registered backend on its own and behind delta and xor, plus the auto selector's candidates
+        static const std::vector<std::string> Get_Registered_Candidate_Specs();
+
+    private:
+        void Mark_Frontiers();
+
+        std::vector<std::string> spec_vec;
+        int measured_iterations;
+        int warmup_iterations;
+        // grouped by layer then lod, in spec order inside a group
+        std::vector<ParetoPoint> points_vec;
+};
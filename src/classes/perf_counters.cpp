@@ -0,0 +1,136 @@
+#include "perf_counters.hpp"
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef __linux__
+static int Open_Perf_Event(const uint32_t& type, const uint64_t& config, const int& group_fd) {
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = type;
+    attributes.config = config;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // user space only, so the default perf_event_paranoid level still lets us count
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, group_fd, 0));
+}
+
+static uint64_t Get_Cache_Miss_Config(const uint64_t& cache, const uint64_t& operation) {
+    return cache | (operation << 8) | (static_cast<uint64_t>(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+}
+#endif
+
+
+//Constructors
+PerfCounterGroup::PerfCounterGroup() {
+    counter_fds_arr.fill(-1);
+    read_index_arr.fill(-1);
+#ifdef __linux__
+    const std::array<std::pair<uint32_t, uint64_t>, NUMBER_OF_PERF_COUNTERS> events_arr = {{
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, Get_Cache_Miss_Config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    }};
+
+    for(size_t counter = 0; counter < events_arr.size(); counter++) {
+        const int fd = Open_Perf_Event(events_arr[counter].first, events_arr[counter].second, group_fd);
+        if(fd < 0) {
+            if(unavailable_reason.empty()) {
+                unavailable_reason = std::string{Get_Perf_Counter_Name(static_cast<PerfCounter>(counter))} + std::string{": "} + std::strerror(errno);
+            }
+            continue;
+        }
+        // the first counter that opens leads the group
+        if(group_fd < 0) {
+            group_fd = fd;
+        }
+        counter_fds_arr[counter] = fd;
+        read_index_arr[counter] = number_of_open_counters++;
+    }
+#else
+    unavailable_reason = "perf_event_open is linux only";
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#ifdef __linux__
+    for(const int fd : counter_fds_arr) {
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+const bool PerfCounterGroup::Read(PerfReading& reading) const {
+    if(group_fd < 0) {
+        return false;
+    }
+#ifdef __linux__
+    // group layout: number of counters, time enabled, time running, then one value per counter in open order
+    std::array<uint64_t, NUMBER_OF_PERF_COUNTERS + 3> read_buffer_arr;
+    const ssize_t bytes_read = read(group_fd, read_buffer_arr.data(), sizeof(uint64_t) * (number_of_open_counters + 3));
+    if(bytes_read != static_cast<ssize_t>(sizeof(uint64_t) * (number_of_open_counters + 3))) {
+        return false;
+    }
+    reading.time_enabled = read_buffer_arr[1];
+    reading.time_running = read_buffer_arr[2];
+    for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+        reading.counts_arr[counter] = (read_index_arr[counter] >= 0) ? read_buffer_arr[3 + read_index_arr[counter]] : 0;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+//getters
+const bool PerfCounterGroup::Is_Available() const {return group_fd >= 0;}
+
+const bool PerfCounterGroup::Is_Counter_Available(const PerfCounter& counter) const {
+    return read_index_arr[static_cast<size_t>(counter)] >= 0;
+}
+
+const std::string& PerfCounterGroup::Get_Unavailable_Reason() const {return unavailable_reason;}
+
+
+const bool Get_Perf_Count_Deltas(const PerfReading& start_reading, const PerfReading& end_reading, PerfCounts& deltas_arr) {
+    const uint64_t time_enabled = end_reading.time_enabled - start_reading.time_enabled;
+    const uint64_t time_running = end_reading.time_running - start_reading.time_running;
+    if(time_running == 0) {
+        return false;
+    }
+    for(size_t counter = 0; counter < NUMBER_OF_PERF_COUNTERS; counter++) {
+        const uint64_t delta = end_reading.counts_arr[counter] - start_reading.counts_arr[counter];
+        deltas_arr[counter] = (time_running == time_enabled) ? delta
+                            : static_cast<uint64_t>(static_cast<double>(delta) * static_cast<double>(time_enabled) / static_cast<double>(time_running));
+    }
+    return true;
+}
+
+PerfCounterGroup& Get_Thread_Perf_Counter_Group() {
+    thread_local PerfCounterGroup perf_counter_group;
+    return perf_counter_group;
+}
+
+const char* Get_Perf_Counter_Name(const PerfCounter& counter) {
+    switch(counter) {
+        case PerfCounter::cycles: return "cycles";
+        case PerfCounter::instructions: return "instructions";
+        case PerfCounter::branch_misses: return "branch_misses";
+        case PerfCounter::l1d_read_misses: return "l1d_read_misses";
+        case PerfCounter::llc_misses: return "llc_misses";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+enum class PerfCounter {
+    cycles,
+    instructions,
+    branch_misses,
+    l1d_read_misses,
+    llc_misses,
+    NUMBER_PERF_COUNTERS
+};
+
+#define NUMBER_OF_PERF_COUNTERS static_cast<size_t>(PerfCounter::NUMBER_PERF_COUNTERS)
+
+using PerfCounts = std::array<uint64_t, NUMBER_OF_PERF_COUNTERS>;
+
+// one group read. when the PMU has more events than counters the kernel multiplexes the group, and it only
+// counts while time_running advances, so the times say how much of the enabled time the counts cover
+struct PerfReading {
+    PerfCounts counts_arr{};
+    uint64_t time_enabled = 0;
+    uint64_t time_running = 0;
+};
+
+// user space hardware counters for the calling thread, opened as one perf_event_open group so a read is one syscall
+// any counter the kernel/VM refuses is left out and reported as unavailable instead of failing the run
+class PerfCounterGroup {
+    public:
+        PerfCounterGroup();
+        ~PerfCounterGroup();
+        PerfCounterGroup(const PerfCounterGroup&) = delete;
+        PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+        // running totals since the group was opened, false if nothing could be opened
+        const bool Read(PerfReading& reading) const;
+
+        //getters
+        const bool Is_Available() const;
+        const bool Is_Counter_Available(const PerfCounter& counter) const;
+        const std::string& Get_Unavailable_Reason() const;
+
+    private:
+        int group_fd = -1;
+        std::array<int, NUMBER_OF_PERF_COUNTERS> counter_fds_arr;
+        // position of each opened counter in the group read, -1 when it did not open
+        std::array<int, NUMBER_OF_PERF_COUNTERS> read_index_arr;
+        int number_of_open_counters = 0;
+        std::string unavailable_reason;
+};
+
+// one group per thread, opened the first time that thread asks for it
+PerfCounterGroup& Get_Thread_Perf_Counter_Group();
+
+// counts between two reads of the same group, scaled up by enabled / running time when the group was multiplexed
+// out for part of it. false when the group never ran in between, the counts would be pure guesswork
+const bool Get_Perf_Count_Deltas(const PerfReading& start_reading, const PerfReading& end_reading, PerfCounts& deltas_arr);
+
+const char* Get_Perf_Counter_Name(const PerfCounter& counter);
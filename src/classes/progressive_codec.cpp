@@ -0,0 +1,308 @@
+#include "progressive_codec.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define PROGRESSIVE_FILE_MAGIC "GBPG"
+#define PROGRESSIVE_FILE_VERSION 1
+// magic, version, data type size, levels, samples per row, rows
+#define PROGRESSIVE_FIXED_HEADER_BYTES (4 + 3 + 2 * sizeof(uint64_t))
+
+
+template <typename T>
+static void Write_Value(std::ostream& output_stream, const T& value) {
+    output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T Load_Value(const char* data) {
+    T value{};
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+static inline const uint32_t Get_Progressive_Sample_Mask(const int& sample_width) {
+    return (sample_width >= 4) ? 0xFFFFFFFF : ((uint32_t{1} << (8 * sample_width)) - 1);
+}
+
+static inline const int64_t Sign_Extend_Sample(const uint32_t& sample, const int& sample_width) {
+    const int shift = 32 - 8 * sample_width;
+    return static_cast<int64_t>(static_cast<int32_t>(sample << shift) >> shift);
+}
+
+// samples of the level with this stride that the coarser level did not already have, in raster order
+template <typename Function>
+static void For_Each_Level_Sample(const uint64_t& rows, const uint64_t& samples_per_row, const uint64_t& stride, const bool& first_level, Function function) {
+    for(uint64_t row = 0; row < rows; row += stride) {
+        const bool coarse_row = (row % (2 * stride) == 0);
+        // on a row the coarser level had, only every other sample is new
+        const uint64_t first_column = (coarse_row && !first_level) ? stride : 0;
+        const uint64_t column_step = (coarse_row && !first_level) ? 2 * stride : stride;
+        for(uint64_t column = first_column; column < samples_per_row; column += column_step) {
+            function(row, column);
+        }
+    }
+}
+
+
+//Constructors
+ProgressiveCodec::ProgressiveCodec(const std::string& spec, const int& levels)
+    : pipeline(std::make_unique<CodecPipeline>(spec)), compression_type(std::string{"progressive|"} + spec), levels(std::clamp(levels, 1, MAX_PROGRESSIVE_LEVELS)) {}
+
+const uint64_t ProgressiveCodec::Get_Level_Stride(const int& levels, const int& level) {
+    return uint64_t{1} << (levels - 1 - level);
+}
+
+const uint64_t ProgressiveCodec::Get_Header_Bytes(const int& levels) {
+    return PROGRESSIVE_FIXED_HEADER_BYTES + levels * sizeof(uint64_t);
+}
+
+// the neighbours of the coarser level (stride * 2) around the sample, repeated past its last row or column
+const uint32_t ProgressiveCodec::Get_Upsampled_Sample(const uint64_t& row, const uint64_t& column, const uint64_t& stride) const {
+    const uint64_t coarse_stride = 2 * stride;
+    const uint64_t last_row = ((rows - 1) / coarse_stride) * coarse_stride;
+    const uint64_t last_column = ((samples_per_row - 1) / coarse_stride) * coarse_stride;
+    const uint64_t top_row = (row / coarse_stride) * coarse_stride;
+    const uint64_t bottom_row = std::min(top_row + ((row != top_row) ? coarse_stride : 0), last_row);
+    const uint64_t left_column = (column / coarse_stride) * coarse_stride;
+    const uint64_t right_column = std::min(left_column + ((column != left_column) ? coarse_stride : 0), last_column);
+
+    const int64_t sum = Sign_Extend_Sample(sample_vec[top_row * samples_per_row + left_column], sample_width) +
+                        Sign_Extend_Sample(sample_vec[top_row * samples_per_row + right_column], sample_width) +
+                        Sign_Extend_Sample(sample_vec[bottom_row * samples_per_row + left_column], sample_width) +
+                        Sign_Extend_Sample(sample_vec[bottom_row * samples_per_row + right_column], sample_width);
+    return static_cast<uint32_t>((sum + 2) >> 2);
+}
+
+void ProgressiveCodec::Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row) {
+    sample_width = std::max(1, this->Get_Data_Type_Size());
+    if(sample_width != 1 && sample_width != 2 && sample_width != 4) {
+        ERROR_MSG_AND_EXIT("Error: Invalid data type size.");
+    }
+    const uint64_t bytes_per_row = samples_per_row * sample_width;
+    const uint64_t original_bytes = Get_File_Size_Bytes(input_path);
+    if(bytes_per_row == 0 || original_bytes % bytes_per_row != 0) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is not a whole number of rows of "} + std::to_string(samples_per_row) + std::string{" samples"});
+    }
+    this->samples_per_row = samples_per_row;
+    rows = original_bytes / bytes_per_row;
+
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+    level_vec.resize(original_bytes);
+    input_file.read(level_vec.data(), original_bytes);
+    sample_vec.assign(rows * samples_per_row, 0);
+    for(uint64_t i = 0; i < sample_vec.size(); i++) {
+        std::memcpy(&sample_vec[i], &level_vec[i * sample_width], sample_width);
+    }
+
+    // no more levels than it takes to get the coarsest grid down to a single sample
+    int file_levels = 1;
+    while(file_levels < levels && (uint64_t{1} << file_levels) < std::max(rows, samples_per_row)) {
+        file_levels++;
+    }
+
+    output_file.write(PROGRESSIVE_FILE_MAGIC, 4);
+    Write_Value<uint8_t>(output_file, PROGRESSIVE_FILE_VERSION);
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(sample_width));
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(file_levels));
+    Write_Value<uint64_t>(output_file, samples_per_row);
+    Write_Value<uint64_t>(output_file, rows);
+    // the level end offsets are filled in once the levels are written
+    std::vector<uint64_t> level_end_vec(file_levels, 0);
+    output_file.write(reinterpret_cast<const char*>(level_end_vec.data()), file_levels * sizeof(uint64_t));
+
+    pipeline->Set_Data_Type_Size(sample_width);
+    const uint32_t sample_mask = Get_Progressive_Sample_Mask(sample_width);
+    const int sign_shift = 8 * sample_width - 1;
+    for(int level = 0; level < file_levels; level++) {
+        const uint64_t stride = Get_Level_Stride(file_levels, level);
+        // one timed region per level, residuals and chunks together, the file write stays outside it
+        this->Compute_Time_Encoded([&](){
+            level_vec.clear();
+            For_Each_Level_Sample(rows, samples_per_row, stride, level == 0, [&](const uint64_t& row, const uint64_t& column) {
+                uint32_t value = sample_vec[row * samples_per_row + column];
+                if(level != 0) {
+                    // zigzag of the wrapped difference, small misses either way keep the high bytes zero
+                    const uint32_t difference = (value - Get_Upsampled_Sample(row, column, stride)) & sample_mask;
+                    value = ((difference << 1) ^ (0u - ((difference >> sign_shift) & 1))) & sample_mask;
+                }
+                const char* value_bytes = reinterpret_cast<const char*>(&value);
+                level_vec.insert(level_vec.end(), value_bytes, value_bytes + sample_width);
+            });
+
+            pipeline->Set_Samples_Per_Row((samples_per_row - 1) / stride + 1);
+            encoded_level_vec.clear();
+            const uint64_t chunk_bytes = uint64_t{PROGRESSIVE_CHUNK_SAMPLES} * sample_width;
+            for(uint64_t offset = 0; offset < level_vec.size(); offset += chunk_bytes) {
+                const uint64_t bytes = std::min(chunk_bytes, level_vec.size() - offset);
+                chunk_vec.assign(level_vec.begin() + offset, level_vec.begin() + offset + bytes);
+                pipeline->Set_Binary_Data_Vec(chunk_vec);
+                pipeline->Encode_Row();
+                const std::vector<char>& encoded_vec = pipeline->Get_Encoded_Data_Vec();
+                const uint32_t encoded_size = static_cast<uint32_t>(encoded_vec.size());
+                const char* size_bytes = reinterpret_cast<const char*>(&encoded_size);
+                encoded_level_vec.insert(encoded_level_vec.end(), size_bytes, size_bytes + sizeof(uint32_t));
+                encoded_level_vec.insert(encoded_level_vec.end(), encoded_vec.begin(), encoded_vec.end());
+            }
+        });
+        output_file.write(encoded_level_vec.data(), encoded_level_vec.size());
+        level_end_vec[level] = static_cast<uint64_t>(output_file.tellp());
+    }
+    output_file.seekp(PROGRESSIVE_FIXED_HEADER_BYTES);
+    output_file.write(reinterpret_cast<const char*>(level_end_vec.data()), file_levels * sizeof(uint64_t));
+    if(!output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to write "} + output_path.string());
+    }
+}
+
+const int ProgressiveCodec::Decode_Prefix(const char* encoded_data, const uint64_t& encoded_bytes, std::vector<char>& grid_vec, uint64_t& grid_samples_per_row) {
+    grid_vec.clear();
+    grid_samples_per_row = 0;
+    if(encoded_bytes < PROGRESSIVE_FIXED_HEADER_BYTES) {
+        return 0;
+    }
+    if(std::memcmp(encoded_data, PROGRESSIVE_FILE_MAGIC, 4) != 0 || Load_Value<uint8_t>(encoded_data + 4) != PROGRESSIVE_FILE_VERSION) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: not a progressive encoded file"});
+    }
+    sample_width = Load_Value<uint8_t>(encoded_data + 5);
+    const int file_levels = Load_Value<uint8_t>(encoded_data + 6);
+    samples_per_row = Load_Value<uint64_t>(encoded_data + 7);
+    rows = Load_Value<uint64_t>(encoded_data + 7 + sizeof(uint64_t));
+    if((sample_width != 1 && sample_width != 2 && sample_width != 4) || file_levels < 1 || file_levels > MAX_PROGRESSIVE_LEVELS) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: corrupt progressive header"});
+    }
+    if(encoded_bytes < Get_Header_Bytes(file_levels)) {
+        return 0;
+    }
+
+    pipeline->Set_Data_Type_Size(sample_width);
+    sample_vec.assign(rows * samples_per_row, 0);
+    const uint32_t sample_mask = Get_Progressive_Sample_Mask(sample_width);
+    uint64_t position = Get_Header_Bytes(file_levels);
+    int decoded_levels = 0;
+    for(int level = 0; level < file_levels; level++) {
+        const uint64_t level_end = Load_Value<uint64_t>(encoded_data + PROGRESSIVE_FIXED_HEADER_BYTES + level * sizeof(uint64_t));
+        if(level_end > encoded_bytes) {
+            break;
+        }
+        const uint64_t stride = Get_Level_Stride(file_levels, level);
+        pipeline->Set_Samples_Per_Row((samples_per_row - 1) / stride + 1);
+
+        level_vec.clear();
+        while(position < level_end) {
+            if(position + sizeof(uint32_t) > level_end || position + sizeof(uint32_t) + Load_Value<uint32_t>(encoded_data + position) > level_end) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: corrupt progressive level "} + std::to_string(level));
+            }
+            const uint32_t chunk_bytes = Load_Value<uint32_t>(encoded_data + position);
+            chunk_vec.assign(encoded_data + position + sizeof(uint32_t), encoded_data + position + sizeof(uint32_t) + chunk_bytes);
+            pipeline->Set_Encoded_Data_Vec(chunk_vec);
+            pipeline->Decode_Row();
+            level_vec.insert(level_vec.end(), pipeline->Get_Decoded_Data_Vec().begin(), pipeline->Get_Decoded_Data_Vec().end());
+            position += sizeof(uint32_t) + chunk_bytes;
+        }
+
+        uint64_t offset = 0;
+        For_Each_Level_Sample(rows, samples_per_row, stride, level == 0, [&](const uint64_t& row, const uint64_t& column) {
+            if(offset + sample_width > level_vec.size()) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: progressive level "} + std::to_string(level) + std::string{" decoded short"});
+            }
+            uint32_t value = 0;
+            std::memcpy(&value, &level_vec[offset], sample_width);
+            offset += sample_width;
+            if(level != 0) {
+                value = (Get_Upsampled_Sample(row, column, stride) + (((value >> 1) ^ (0u - (value & 1))) & sample_mask)) & sample_mask;
+            }
+            sample_vec[row * samples_per_row + column] = value;
+        });
+        decoded_levels = level + 1;
+    }
+    if(decoded_levels == 0) {
+        return 0;
+    }
+
+    grid_stride = Get_Level_Stride(file_levels, decoded_levels - 1);
+    grid_samples_per_row = (samples_per_row - 1) / grid_stride + 1;
+    grid_vec.reserve(((rows - 1) / grid_stride + 1) * grid_samples_per_row * sample_width);
+    for(uint64_t row = 0; row < rows; row += grid_stride) {
+        for(uint64_t column = 0; column < samples_per_row; column += grid_stride) {
+            const char* value_bytes = reinterpret_cast<const char*>(&sample_vec[row * samples_per_row + column]);
+            grid_vec.insert(grid_vec.end(), value_bytes, value_bytes + sample_width);
+        }
+    }
+    return decoded_levels;
+}
+
+void ProgressiveCodec::Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const int& levels) {
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    // the fixed header says how many level offsets follow, the offsets say how much of the file to read
+    std::vector<char> encoded_vec(PROGRESSIVE_FIXED_HEADER_BYTES);
+    input_file.read(encoded_vec.data(), encoded_vec.size());
+    if(!input_file) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+    }
+    const int file_levels = Load_Value<uint8_t>(encoded_vec.data() + 6);
+    encoded_vec.resize(Get_Header_Bytes(file_levels));
+    input_file.read(encoded_vec.data() + PROGRESSIVE_FIXED_HEADER_BYTES, encoded_vec.size() - PROGRESSIVE_FIXED_HEADER_BYTES);
+    const uint64_t prefix_bytes = Get_Prefix_Bytes(encoded_vec.data(), encoded_vec.size(), (levels <= 0) ? file_levels : std::min(levels, file_levels));
+    if(!input_file || prefix_bytes < encoded_vec.size()) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+    }
+    const uint64_t header_bytes = encoded_vec.size();
+    encoded_vec.resize(prefix_bytes);
+    input_file.read(encoded_vec.data() + header_bytes, prefix_bytes - header_bytes);
+
+    std::vector<char> grid_vec;
+    uint64_t grid_samples_per_row = 0;
+    int decoded_levels = 0;
+    this->Compute_Time_Decoded([&](){
+        decoded_levels = Decode_Prefix(encoded_vec.data(), input_file.gcount() + header_bytes, grid_vec, grid_samples_per_row);
+    });
+    if(decoded_levels == 0 || (levels <= 0 && decoded_levels != file_levels)) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+    }
+    output_file.write(grid_vec.data(), grid_vec.size());
+}
+
+const uint64_t ProgressiveCodec::Get_Prefix_Bytes(const char* header_data, const uint64_t& header_bytes, const int& levels) {
+    if(header_bytes < PROGRESSIVE_FIXED_HEADER_BYTES) {
+        return 0;
+    }
+    const int file_levels = Load_Value<uint8_t>(header_data + 6);
+    if(header_bytes < Get_Header_Bytes(file_levels) || file_levels < 1) {
+        return 0;
+    }
+    const int last_level = std::clamp(levels, 1, file_levels) - 1;
+    return Load_Value<uint64_t>(header_data + PROGRESSIVE_FIXED_HEADER_BYTES + last_level * sizeof(uint64_t));
+}
+
+//getters
+const char* ProgressiveCodec::Get_Compression_Type() const {return compression_type.c_str();}
+const int ProgressiveCodec::Get_Levels() const {return levels;}
+const uint64_t ProgressiveCodec::Get_Grid_Stride() const {return grid_stride;}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include "codec_pipeline.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define DEFAULT_PROGRESSIVE_LEVELS 4
+#define MAX_PROGRESSIVE_LEVELS 16
+// residuals of a level go through the pipeline in chunks of this many samples
+#define PROGRESSIVE_CHUNK_SAMPLES 8192
+
+// codes a tile coarse to fine over decimated sample grids. level 0 is every 2^(levels - 1)th sample of every
+// 2^(levels - 1)th row, every later level halves the stride and codes only the samples it adds, as the zigzagged
+// residual against the bilinear upsampling of the level before it. the last level is the full tile.
+// the header records where every level ends, so a streaming client can fetch the header, then only the prefix
+// of the file it needs for the resolution it wants, and refine later by fetching the rest.
+// file layout: "GBPG" | version u8 | data type size u8 | levels u8 | samples per row u64 | rows u64 |
+//              end offset u64 per level (from the start of the file) |
+//              then per level, per chunk: encoded chunk size u32 | encoded chunk
+class ProgressiveCodec : public CommonStats {
+    public:
+        // Constructors
+        ProgressiveCodec(const std::string& spec, const int& levels = DEFAULT_PROGRESSIVE_LEVELS);
+
+        void Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row);
+        // levels <= 0 decodes the whole tile. otherwise only the prefix of the file those levels need is read and
+        // the decimated grid of the last of them is written
+        void Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const int& levels = 0);
+
+        // decodes every level that is complete in the first encoded_bytes of an encoded file into grid_vec, the grid of
+        // the finest of them, row major with grid_samples_per_row samples per row. returns the number of levels decoded,
+        // 0 when not even the header and level 0 are there
+        const int Decode_Prefix(const char* encoded_data, const uint64_t& encoded_bytes, std::vector<char>& grid_vec, uint64_t& grid_samples_per_row);
+
+        // bytes of the file the first levels need, 0 while header_bytes is too short to hold the header
+        static const uint64_t Get_Prefix_Bytes(const char* header_data, const uint64_t& header_bytes, const int& levels);
+        static const uint64_t Get_Header_Bytes(const int& levels);
+
+        //getters
+        const char* Get_Compression_Type() const;
+        const int Get_Levels() const;
+        // stride between the samples of the grid the last Decode_Prefix returned
+        const uint64_t Get_Grid_Stride() const;
+
+    private:
+        // stride between the samples of a level, the last level is the full tile
+        static const uint64_t Get_Level_Stride(const int& levels, const int& level);
+        const uint32_t Get_Upsampled_Sample(const uint64_t& row, const uint64_t& column, const uint64_t& stride) const;
+
+        std::unique_ptr<CodecPipeline> pipeline;
+        std::string compression_type;
+        int levels = DEFAULT_PROGRESSIVE_LEVELS;
+        // shape of the tile being coded
+        int sample_width = 1;
+        uint64_t samples_per_row = 0;
+        uint64_t rows = 0;
+        uint64_t grid_stride = 1;
+        // the full tile, only the samples of the levels coded so far are valid while decoding
+        std::vector<uint32_t> sample_vec;
+        std::vector<char> level_vec;
+        std::vector<char> chunk_vec;
+        // the framed chunks of the level being encoded, written out once its timing has stopped
+        std::vector<char> encoded_level_vec;
+};
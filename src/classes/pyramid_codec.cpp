@@ -0,0 +1,246 @@
+#include "pyramid_codec.hpp"
+#include "geobin_catalog.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define PYRAMID_FILE_MAGIC "GBPY"
+#define PYRAMID_FILE_VERSION 1
+
+
+template <typename T>
+static void Write_Value(std::ostream& output_stream, const T& value) {
+    output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T Read_Value(std::istream& input_stream) {
+    T value{};
+    input_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+static inline const uint32_t Get_Pyramid_Sample_Mask(const int& sample_width) {
+    return (sample_width >= 4) ? 0xFFFFFFFF : ((uint32_t{1} << (8 * sample_width)) - 1);
+}
+
+static inline const int64_t Sign_Extend_Sample(const uint32_t& sample, const int& sample_width) {
+    const int shift = 32 - 8 * sample_width;
+    return static_cast<int64_t>(static_cast<int32_t>(sample << shift) >> shift);
+}
+
+
+//Constructors
+PyramidCodec::PyramidCodec(const std::string& spec, const uint64_t& rows_per_band)
+    : pipeline(std::make_unique<CodecPipeline>(spec)), compression_type(std::string{"pyramid|"} + spec), rows_per_band(std::max<uint64_t>(rows_per_band, 1)) {}
+
+const bool PyramidCodec::Load_Parent(const std::filesystem::path& parent_path, const uint64_t& samples_per_row, const int& data_type_size) {
+    parent_samples_per_row = 0;
+    parent_rows = 0;
+    if(parent_path.empty() || samples_per_row < 3 || samples_per_row % 2 == 0) {
+        return false;
+    }
+
+    const uint64_t samples_per_parent_row = (samples_per_row - 1) / 2 + 1;
+    const uint64_t bytes_per_parent_row = samples_per_parent_row * data_type_size;
+    std::ifstream parent_file(parent_path, std::ios::binary);
+    if(!parent_file) {
+        return false;
+    }
+    band_vec.resize(bytes_per_parent_row);
+    parent_sample_vec.clear();
+    while(parent_file.read(band_vec.data(), bytes_per_parent_row)) {
+        for(uint64_t column = 0; column < samples_per_parent_row; column++) {
+            uint32_t sample = 0;
+            std::memcpy(&sample, &band_vec[column * data_type_size], data_type_size);
+            parent_sample_vec.push_back(sample);
+        }
+        parent_rows++;
+    }
+    if(parent_rows == 0) {
+        return false;
+    }
+    parent_samples_per_row = samples_per_parent_row;
+    return true;
+}
+
+// rows past the parent's last row reuse it, columns always have a right neighbour on an odd child column
+const uint32_t PyramidCodec::Get_Upsampled_Parent_Sample(const uint64_t& row, const uint64_t& column) const {
+    const uint64_t top_row = std::min(row / 2, parent_rows - 1);
+    const uint64_t bottom_row = std::min(top_row + (row & 1), parent_rows - 1);
+    const uint64_t left_column = column / 2;
+    const uint64_t right_column = std::min(left_column + (column & 1), parent_samples_per_row - 1);
+
+    const int64_t sum = Sign_Extend_Sample(parent_sample_vec[top_row * parent_samples_per_row + left_column], sample_width) +
+                        Sign_Extend_Sample(parent_sample_vec[top_row * parent_samples_per_row + right_column], sample_width) +
+                        Sign_Extend_Sample(parent_sample_vec[bottom_row * parent_samples_per_row + left_column], sample_width) +
+                        Sign_Extend_Sample(parent_sample_vec[bottom_row * parent_samples_per_row + right_column], sample_width);
+    return static_cast<uint32_t>((sum + 2) >> 2);
+}
+
+void PyramidCodec::Apply_Parent_Prediction(std::vector<char>& samples_vec, const uint64_t& first_row, const uint64_t& samples_per_row, const bool& residual_to_sample) const {
+    const uint32_t sample_mask = Get_Pyramid_Sample_Mask(sample_width);
+    const int sign_shift = 8 * sample_width - 1;
+    const uint64_t number_of_samples = samples_vec.size() / sample_width;
+    for(uint64_t i = 0; i < number_of_samples; i++) {
+        const uint32_t prediction = Get_Upsampled_Parent_Sample(first_row + i / samples_per_row, i % samples_per_row);
+        uint32_t value = 0;
+        std::memcpy(&value, &samples_vec[i * sample_width], sample_width);
+        if(residual_to_sample) {
+            value = (prediction + (((value >> 1) ^ (0u - (value & 1))) & sample_mask)) & sample_mask;
+        } else {
+            // zigzag of the wrapped difference, small misses either way keep the high bytes zero
+            const uint32_t difference = (value - prediction) & sample_mask;
+            value = ((difference << 1) ^ (0u - ((difference >> sign_shift) & 1))) & sample_mask;
+        }
+        std::memcpy(&samples_vec[i * sample_width], &value, sample_width);
+    }
+}
+
+void PyramidCodec::Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row,
+                               const std::filesystem::path& parent_path) {
+    sample_width = std::max(1, this->Get_Data_Type_Size());
+    if(sample_width != 1 && sample_width != 2 && sample_width != 4) {
+        ERROR_MSG_AND_EXIT("Error: Invalid data type size.");
+    }
+    const uint64_t bytes_per_row = samples_per_row * sample_width;
+    const uint64_t original_bytes = Get_File_Size_Bytes(input_path);
+    const bool has_parent = Load_Parent(parent_path, samples_per_row, sample_width);
+
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    const std::string parent_file_name = has_parent ? parent_path.filename().string() : std::string{};
+    output_file.write(PYRAMID_FILE_MAGIC, 4);
+    Write_Value<uint8_t>(output_file, PYRAMID_FILE_VERSION);
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(sample_width));
+    Write_Value<uint64_t>(output_file, samples_per_row);
+    Write_Value<uint64_t>(output_file, rows_per_band);
+    Write_Value<uint64_t>(output_file, original_bytes);
+    Write_Value<uint64_t>(output_file, parent_samples_per_row);
+    Write_Value<uint16_t>(output_file, static_cast<uint16_t>(parent_file_name.size()));
+    output_file.write(parent_file_name.data(), parent_file_name.size());
+
+    pipeline->Set_Data_Type_Size(sample_width);
+    pipeline->Set_Samples_Per_Row(samples_per_row);
+
+    const uint64_t bytes_per_band = rows_per_band * bytes_per_row;
+    for(uint64_t first_row = 0; first_row * bytes_per_row < original_bytes; first_row += rows_per_band) {
+        band_vec.resize(bytes_per_band);
+        input_file.read(band_vec.data(), bytes_per_band);
+        band_vec.resize(input_file.gcount());
+
+        this->Compute_Time_Encoded([&](){
+            if(has_parent) {
+                Apply_Parent_Prediction(band_vec, first_row, samples_per_row, false);
+            }
+            pipeline->Set_Binary_Data_Vec(band_vec);
+            pipeline->Encode_Row();
+        });
+
+        const std::vector<char>& encoded_vec = pipeline->Get_Encoded_Data_Vec();
+        Write_Value<uint32_t>(output_file, static_cast<uint32_t>(encoded_vec.size()));
+        output_file.write(encoded_vec.data(), encoded_vec.size());
+    }
+    if(!output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to write "} + output_path.string());
+    }
+}
+
+void PyramidCodec::Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const std::filesystem::path& parent_path) {
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    char magic[4] = {0};
+    input_file.read(magic, 4);
+    const uint8_t version = Read_Value<uint8_t>(input_file);
+    if(std::memcmp(magic, PYRAMID_FILE_MAGIC, 4) != 0 || version != PYRAMID_FILE_VERSION) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is not a pyramid encoded file"});
+    }
+    sample_width = Read_Value<uint8_t>(input_file);
+    const uint64_t samples_per_row = Read_Value<uint64_t>(input_file);
+    const uint64_t file_rows_per_band = std::max<uint64_t>(Read_Value<uint64_t>(input_file), 1);
+    const uint64_t original_bytes = Read_Value<uint64_t>(input_file);
+    const uint64_t file_parent_samples_per_row = Read_Value<uint64_t>(input_file);
+    input_file.seekg(Read_Value<uint16_t>(input_file), std::ios::cur);
+
+    const bool has_parent = (file_parent_samples_per_row != 0);
+    if(has_parent && (!Load_Parent(parent_path, samples_per_row, sample_width) || parent_samples_per_row != file_parent_samples_per_row)) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" needs its decoded parent lod, "} + parent_path.string() + std::string{" is not it"});
+    }
+
+    pipeline->Set_Data_Type_Size(sample_width);
+    pipeline->Set_Samples_Per_Row(samples_per_row);
+
+    const uint64_t bytes_per_row = samples_per_row * sample_width;
+    std::vector<char> encoded_vec;
+    for(uint64_t first_row = 0; first_row * bytes_per_row < original_bytes; first_row += file_rows_per_band) {
+        encoded_vec.resize(Read_Value<uint32_t>(input_file));
+        input_file.read(encoded_vec.data(), encoded_vec.size());
+        if(!input_file) {
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+        }
+
+        this->Compute_Time_Decoded([&](){
+            pipeline->Set_Encoded_Data_Vec(encoded_vec);
+            pipeline->Decode_Row();
+            band_vec.assign(pipeline->Get_Decoded_Data_Vec().begin(), pipeline->Get_Decoded_Data_Vec().end());
+            if(has_parent) {
+                Apply_Parent_Prediction(band_vec, first_row, samples_per_row, true);
+            }
+        });
+        output_file.write(band_vec.data(), band_vec.size());
+    }
+}
+
+const std::filesystem::path PyramidCodec::Find_Parent_Geobin_Path(const std::filesystem::path& geobin_path) {
+    const GeobinCatalog* catalog = Get_Active_Geobin_Catalog();
+    if(catalog == nullptr) {
+        return std::filesystem::path{};
+    }
+    // looked up by full path and Find_Parent_Entry stays in that directory, a same-named layer elsewhere is never the parent
+    const CatalogEntry* entry = catalog->Find_Entry(geobin_path);
+    const CatalogEntry* parent_entry = (entry != nullptr) ? catalog->Find_Parent_Entry(*entry) : nullptr;
+    return (parent_entry != nullptr) ? catalog->Get_Entry_Path(*parent_entry) : std::filesystem::path{};
+}
+
+const std::string PyramidCodec::Read_Parent_File_Name(const std::filesystem::path& encoded_path) {
+    std::ifstream input_file(encoded_path, std::ios::binary);
+    char magic[4] = {0};
+    input_file.read(magic, 4);
+    if(!input_file || std::memcmp(magic, PYRAMID_FILE_MAGIC, 4) != 0) {
+        return std::string{};
+    }
+    // version, data type size, samples per row, rows per band, original bytes, parent samples per row
+    input_file.seekg(2 + 4 * sizeof(uint64_t), std::ios::cur);
+    std::string parent_file_name(Read_Value<uint16_t>(input_file), '\0');
+    input_file.read(parent_file_name.data(), parent_file_name.size());
+    return input_file ? parent_file_name : std::string{};
+}
+
+//getters
+const char* PyramidCodec::Get_Compression_Type() const {return compression_type.c_str();}
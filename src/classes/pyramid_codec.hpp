@@ -0,0 +1,55 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include "codec_pipeline.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define DEFAULT_PYRAMID_ROWS_PER_BAND 16
+
+// codes a lod tile as the residual against its parent lod tile upsampled bilinearly. a parent of resolution p sits on
+// the even rows and columns of its child of resolution 2 * (p - 1) + 1, so only the detail a lod adds is left to code.
+// residuals are zigzagged and coded through the spec's pipeline in bands of rows, a band amortises the per call tables
+// of the static backends. lod 0, and tiles whose parent is not known, are coded as is. decoding needs the decoded parent,
+// so a pyramid decodes coarse to fine, each lod refining the last.
+// file layout: "GBPY" | version u8 | data type size u8 | samples per row u64 | rows per band u64 | original bytes u64 |
+//              parent samples per row u64 (0 without a parent) | parent name length u16 | parent file name |
+//              then per band: encoded band size u32 | encoded band
+class PyramidCodec : public CommonStats {
+    public:
+        // Constructors
+        PyramidCodec(const std::string& spec, const uint64_t& rows_per_band = DEFAULT_PYRAMID_ROWS_PER_BAND);
+
+        // parent_path is the parent lod geobin, empty to code without one
+        void Encode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row,
+                         const std::filesystem::path& parent_path);
+        // parent_path must hold the decoded parent whenever the file was coded against one
+        void Decode_File(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const std::filesystem::path& parent_path);
+
+        // the parent lod geobin in geobin_path's own directory from the active catalog, empty for lod 0 or when nothing is catalogued
+        static const std::filesystem::path Find_Parent_Geobin_Path(const std::filesystem::path& geobin_path);
+        // the parent file name an encoded file was coded against, empty if it has none
+        static const std::string Read_Parent_File_Name(const std::filesystem::path& encoded_path);
+
+        //getters
+        const char* Get_Compression_Type() const;
+
+    private:
+        // false (and no parent) when the parent's resolution does not divide into samples_per_row
+        const bool Load_Parent(const std::filesystem::path& parent_path, const uint64_t& samples_per_row, const int& data_type_size);
+        const uint32_t Get_Upsampled_Parent_Sample(const uint64_t& row, const uint64_t& column) const;
+        // residual_to_sample false turns samples into residuals, true undoes it. band starts at first_row
+        void Apply_Parent_Prediction(std::vector<char>& samples_vec, const uint64_t& first_row, const uint64_t& samples_per_row, const bool& residual_to_sample) const;
+
+        std::unique_ptr<CodecPipeline> pipeline;
+        std::string compression_type;
+        uint64_t rows_per_band = DEFAULT_PYRAMID_ROWS_PER_BAND;
+        // data type size of the file being coded
+        int sample_width = 1;
+        uint64_t parent_samples_per_row = 0;
+        uint64_t parent_rows = 0;
+        std::vector<uint32_t> parent_sample_vec;
+        std::vector<char> band_vec;
+};
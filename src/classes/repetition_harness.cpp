@@ -0,0 +1,65 @@
+#include "repetition_harness.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+
+static std::atomic<int> pinned_cpu{-1};
+
+const bool Pin_Current_Thread_To_Cpu(const int& cpu) {
+#ifdef __linux__
+    if(cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    // pid 0 is the calling thread
+    if(sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+        return false;
+    }
+    pinned_cpu.store(cpu, std::memory_order_relaxed);
+    return true;
+#else
+    return false;
+#endif
+}
+
+const int Get_Pinned_Cpu() {return pinned_cpu.load(std::memory_order_relaxed);}
+
+const uint64_t Get_Cache_Flush_Bytes() {
+    static const uint64_t cache_flush_bytes = [] {
+        long last_level_cache_bytes = 0;
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+        last_level_cache_bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if(last_level_cache_bytes <= 0) {
+            last_level_cache_bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+        if(last_level_cache_bytes <= 0) {
+            return static_cast<uint64_t>(DEFAULT_CACHE_FLUSH_BYTES);
+        }
+        // virtual machines sometimes report the whole socket's cache or more, a flush per iteration must stay cheap
+        return std::clamp<uint64_t>(2 * static_cast<uint64_t>(last_level_cache_bytes), 8ull << 20, MAX_CACHE_FLUSH_BYTES);
+    }();
+    return cache_flush_bytes;
+}
+
+void Flush_Data_Caches() {
+    static std::vector<char> flush_vec(Get_Cache_Flush_Bytes());
+    static char pass = 0;
+    pass++;
+    // one write and one read per cache line, the volatile sum keeps the reads from being dropped
+    for(size_t offset = 0; offset < flush_vec.size(); offset += 64) {
+        flush_vec[offset] = pass;
+    }
+    volatile char sum = 0;
+    for(size_t offset = 0; offset < flush_vec.size(); offset += 64) {
+        sum = sum + flush_vec[offset];
+    }
+}
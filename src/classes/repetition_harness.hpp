@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// streamed through by Flush_Data_Caches when the last level cache size can not be read
+#define DEFAULT_CACHE_FLUSH_BYTES (64ull << 20)
+#define MAX_CACHE_FLUSH_BYTES (256ull << 20)
+
+// pins the calling thread to one cpu, false if the cpu does not exist or affinity is not allowed.
+// GEOBIN_PIN_CPU=<n> does this for the main thread at startup
+const bool Pin_Current_Thread_To_Cpu(const int& cpu);
+// -1 until Pin_Current_Thread_To_Cpu succeeds
+const int Get_Pinned_Cpu();
+
+// evicts the data caches by writing and reading a buffer twice the last level cache (at most MAX_CACHE_FLUSH_BYTES),
+// called between measured iterations when GEOBIN_FLUSH_CACHES is set so every iteration starts cold
+void Flush_Data_Caches();
+const uint64_t Get_Cache_Flush_Bytes();
@@ -0,0 +1,364 @@
+#include "results_database.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <unistd.h>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+// set by cmake, see the build description block in CMAKELISTS.txt. a build without it leaves the fields out of
+// every record rather than guessing
+#ifndef GEOBIN_GIT_REVISION
+#define GEOBIN_GIT_REVISION ""
+#endif
+#ifndef GEOBIN_BUILD_TYPE
+#ifdef DEBUG_MODE
+#define GEOBIN_BUILD_TYPE "Debug"
+#else
+#define GEOBIN_BUILD_TYPE ""
+#endif
+#endif
+#ifndef GEOBIN_COMPILER_FLAGS
+#define GEOBIN_COMPILER_FLAGS ""
+#endif
+
+using json = nlohmann::json;
+
+// metrics compare looks at, ratio is compressed / original so lower is better.
+// the ratio does not depend on timing, so a single sample per side is enough to compare it
+struct ComparedMetric {
+    const char* name;
+    bool higher_is_better;
+    bool deterministic;
+};
+
+static const std::array<ComparedMetric, 3> compared_metrics_arr = {{
+    {"average_encoded_throughput_bytes_per_microseconds", true, false},
+    {"average_decoded_throughput_bytes_per_microseconds", true, false},
+    {"average_compression_ratio", false, true},
+}};
+
+static std::string Read_Cpu_Model() {
+    std::ifstream cpuinfo_file("/proc/cpuinfo");
+    std::string line;
+    while(std::getline(cpuinfo_file, line)) {
+        if(line.rfind("model name", 0) == 0 || line.rfind("Model", 0) == 0) {
+            const size_t colon_pos = line.find(':');
+            if(colon_pos != std::string::npos && colon_pos + 2 <= line.size()) {
+                return line.substr(colon_pos + 2);
+            }
+        }
+    }
+    return std::string{};
+}
+
+static std::string Get_Compiler_Name() {
+#if defined(__clang__)
+    return std::string{"clang "} + __clang_version__;
+#elif defined(__GNUC__)
+    return std::string{"gcc "} + __VERSION__;
+#else
+    return std::string{};
+#endif
+}
+
+const RunInfo& Get_Run_Info() {
+    static const RunInfo run_info = [] {
+        RunInfo info;
+        const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm utc_time;
+        gmtime_r(&now, &utc_time);
+        std::ostringstream timestamp_stream;
+        timestamp_stream << std::put_time(&utc_time, "%Y-%m-%dT%H:%M:%SZ");
+        info.timestamp = timestamp_stream.str();
+
+        std::ostringstream run_id_stream;
+        run_id_stream << std::put_time(&utc_time, "%Y%m%dT%H%M%SZ") << '-' << getpid();
+        info.run_id = run_id_stream.str();
+
+        const char* label = std::getenv("GEOBIN_RUN_LABEL");
+        info.label = (label != nullptr) ? std::string{label} : std::string{};
+        info.git_revision = GEOBIN_GIT_REVISION;
+        info.build_type = GEOBIN_BUILD_TYPE;
+        info.compiler = Get_Compiler_Name();
+        info.compiler_flags = GEOBIN_COMPILER_FLAGS;
+        info.cpu_model = Read_Cpu_Model();
+
+        std::array<char, 256> hostname_arr{};
+        info.hostname = (gethostname(hostname_arr.data(), hostname_arr.size() - 1) == 0) ? std::string{hostname_arr.data()} : std::string{};
+        return info;
+    }();
+    return run_info;
+}
+
+// two sided 95% student t quantile, exact table up to 30 degrees of freedom and a cornish-fisher expansion above
+static double Get_T_Quantile_95(const double& degrees_of_freedom) {
+    static const std::array<double, 30> t_table_arr = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if(degrees_of_freedom < 1.0) {
+        return t_table_arr[0];
+    }
+    if(degrees_of_freedom <= 30.0) {
+        return t_table_arr[static_cast<size_t>(degrees_of_freedom) - 1];
+    }
+    const double z = 1.959963984540054;
+    return z + (z * z * z + z) / (4.0 * degrees_of_freedom) +
+           (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z) / (96.0 * degrees_of_freedom * degrees_of_freedom);
+}
+
+static void Get_Mean_And_Variance(const std::vector<double>& sample_vec, double& mean, double& variance) {
+    mean = 0.0;
+    for(const double sample : sample_vec) {
+        mean += sample;
+    }
+    mean /= static_cast<double>(sample_vec.size());
+    variance = 0.0;
+    for(const double sample : sample_vec) {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance = (sample_vec.size() > 1) ? variance / static_cast<double>(sample_vec.size() - 1) : 0.0;
+}
+
+
+//Constructors
+ResultsDatabase::ResultsDatabase(const std::filesystem::path& database_path) : database_path(database_path) {}
+
+void ResultsDatabase::Append_Record(const std::string& record_json) const {
+    json record = json::parse(record_json, nullptr, false);
+    if(record.is_discarded()) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: results record is not valid JSON"});
+    }
+
+    const RunInfo& run_info = Get_Run_Info();
+    record["run"] = {
+        {"run_id", run_info.run_id},
+        {"label", run_info.label},
+        {"timestamp", run_info.timestamp},
+    };
+    // only what is actually known about the build and the machine
+    const std::array<std::pair<const char*, const std::string*>, 6> run_fields_arr = {{
+        {"git_revision", &run_info.git_revision},
+        {"build_type", &run_info.build_type},
+        {"compiler", &run_info.compiler},
+        {"compiler_flags", &run_info.compiler_flags},
+        {"cpu_model", &run_info.cpu_model},
+        {"hostname", &run_info.hostname},
+    }};
+    for(const auto& [name, value] : run_fields_arr) {
+        if(!value->empty()) {
+            record["run"][name] = *value;
+        }
+    }
+
+    if(database_path.has_parent_path()) {
+        std::filesystem::create_directories(database_path.parent_path());
+    }
+    // one write per line, so records from concurrent runs do not interleave
+    const std::string line = record.dump() + '\n';
+    std::ofstream database_file(database_path, std::ios::app | std::ios::binary);
+    if(!database_file.write(line.data(), line.size())) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to append to results database "} + database_path.string());
+    }
+}
+
+std::vector<MetricComparison> ResultsDatabase::Compare_Runs(const std::string& baseline_selector, const std::string& candidate_selector,
+                                                            const double& threshold_percent) const {
+    std::ifstream database_file(database_path);
+    if(!database_file) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to open results database "} + database_path.string());
+    }
+
+    std::vector<json> record_vec;
+    std::vector<std::string> run_id_vec;
+    std::string line;
+    while(std::getline(database_file, line)) {
+        json record = json::parse(line, nullptr, false);
+        // a run killed mid write leaves a partial last line, skip it
+        if(record.is_discarded() || !record.contains("run")) {
+            continue;
+        }
+        const std::string run_id = record["run"].value("run_id", std::string{});
+        if(std::find(run_id_vec.begin(), run_id_vec.end(), run_id) == run_id_vec.end()) {
+            run_id_vec.push_back(run_id);
+        }
+        record_vec.push_back(std::move(record));
+    }
+
+    auto resolve_selector = [&run_id_vec](const std::string& selector) -> std::string {
+        if(selector == "latest" && run_id_vec.size() >= 1) {
+            return run_id_vec[run_id_vec.size() - 1];
+        }
+        if(selector == "previous" && run_id_vec.size() >= 2) {
+            return run_id_vec[run_id_vec.size() - 2];
+        }
+        return selector;
+    };
+    auto matches_selector = [](const json& run_json, const std::string& selector) -> bool {
+        const std::string git_revision = run_json.value("git_revision", std::string{});
+        return run_json.value("run_id", std::string{}) == selector || run_json.value("label", std::string{}) == selector ||
+               (selector.size() >= 7 && git_revision.rfind(selector, 0) == 0);
+    };
+    const std::string baseline_run = resolve_selector(baseline_selector);
+    const std::string candidate_run = resolve_selector(candidate_selector);
+
+    // key -> metric index -> samples
+    std::map<std::string, std::array<std::array<std::vector<double>, compared_metrics_arr.size()>, 2>> samples_map;
+    for(const auto& record : record_vec) {
+        const bool baseline = matches_selector(record["run"], baseline_run);
+        const bool candidate = matches_selector(record["run"], candidate_run);
+        if(!baseline && !candidate) {
+            continue;
+        }
+        const std::string key = record.value("compression_type", std::string{}) + std::string{" "} + record.value("directory_compressed", std::string{});
+        // records that kept their measured iterations contribute one sample per iteration
+        const bool per_iteration = record.contains("iterations") && record["iterations"].is_array() && !record["iterations"].empty();
+        for(size_t metric = 0; metric < compared_metrics_arr.size(); metric++) {
+            std::vector<double> values_vec;
+            if(per_iteration) {
+                for(const auto& iteration : record["iterations"]) {
+                    if(iteration.contains(compared_metrics_arr[metric].name)) {
+                        values_vec.push_back(iteration[compared_metrics_arr[metric].name].get<double>());
+                    }
+                }
+            } else if(record.contains(compared_metrics_arr[metric].name)) {
+                values_vec.push_back(record[compared_metrics_arr[metric].name].get<double>());
+            }
+            for(const int side : {0, 1}) {
+                if((side == 0) ? baseline : candidate) {
+                    auto& sample_vec = samples_map[key][side][metric];
+                    sample_vec.insert(sample_vec.end(), values_vec.begin(), values_vec.end());
+                }
+            }
+        }
+    }
+
+    std::vector<MetricComparison> comparison_vec;
+    for(const auto& [key, sides_arr] : samples_map) {
+        for(size_t metric = 0; metric < compared_metrics_arr.size(); metric++) {
+            const std::vector<double>& baseline_vec = sides_arr[0][metric];
+            const std::vector<double>& candidate_vec = sides_arr[1][metric];
+            MetricComparison comparison;
+            comparison.key = key;
+            comparison.metric = compared_metrics_arr[metric].name;
+            comparison.baseline_samples = baseline_vec.size();
+            comparison.candidate_samples = candidate_vec.size();
+            if(baseline_vec.empty() || candidate_vec.empty()) {
+                comparison_vec.push_back(comparison);
+                continue;
+            }
+
+            double baseline_variance = 0.0;
+            double candidate_variance = 0.0;
+            Get_Mean_And_Variance(baseline_vec, comparison.baseline_mean, baseline_variance);
+            Get_Mean_And_Variance(candidate_vec, comparison.candidate_mean, candidate_variance);
+            const double difference = comparison.candidate_mean - comparison.baseline_mean;
+
+            double half_width = 0.0;
+            if(baseline_vec.size() >= 2 && candidate_vec.size() >= 2) {
+                const double baseline_term = baseline_variance / baseline_vec.size();
+                const double candidate_term = candidate_variance / candidate_vec.size();
+                const double standard_error = std::sqrt(baseline_term + candidate_term);
+                if(standard_error > 0.0) {
+                    // welch-satterthwaite degrees of freedom
+                    const double degrees_of_freedom = (baseline_term + candidate_term) * (baseline_term + candidate_term) /
+                                                      (baseline_term * baseline_term / (baseline_vec.size() - 1) +
+                                                       candidate_term * candidate_term / (candidate_vec.size() - 1));
+                    half_width = Get_T_Quantile_95(degrees_of_freedom) * standard_error;
+                }
+            } else if(!compared_metrics_arr[metric].deterministic) {
+                // one timing sample says nothing about noise
+                comparison_vec.push_back(comparison);
+                continue;
+            }
+
+            const double scale = (comparison.baseline_mean != 0.0) ? 100.0 / std::fabs(comparison.baseline_mean) : 0.0;
+            comparison.change_percent = difference * scale;
+            comparison.change_low_percent = (difference - half_width) * scale;
+            comparison.change_high_percent = (difference + half_width) * scale;
+
+            // the whole interval has to sit on one side of zero and the change has to be bigger than the threshold
+            const bool higher_is_better = compared_metrics_arr[metric].higher_is_better;
+            const bool significant_increase = comparison.change_low_percent > 0.0 && comparison.change_percent >= threshold_percent;
+            const bool significant_decrease = comparison.change_high_percent < 0.0 && comparison.change_percent <= -threshold_percent;
+            if(significant_increase) {
+                comparison.verdict = higher_is_better ? MetricVerdict::improvement : MetricVerdict::regression;
+            } else if(significant_decrease) {
+                comparison.verdict = higher_is_better ? MetricVerdict::regression : MetricVerdict::improvement;
+            } else {
+                comparison.verdict = MetricVerdict::unchanged;
+            }
+            comparison_vec.push_back(comparison);
+        }
+    }
+    return comparison_vec;
+}
+
+//getters
+const std::filesystem::path& ResultsDatabase::Get_Database_Path() const {return database_path;}
+
+std::filesystem::path ResultsDatabase::Get_Default_Database_Path() {
+    const char* database_path = std::getenv("GEOBIN_RESULTS_DB");
+    return std::filesystem::path{(database_path != nullptr && database_path[0] != '\0') ? database_path : DEFAULT_RESULTS_DATABASE_PATH};
+}
+
+std::filesystem::path ResultsDatabase::Get_Recording_Database_Path() {
+    const char* database_path = std::getenv("GEOBIN_RESULTS_DB");
+    return std::filesystem::path{(database_path != nullptr) ? database_path : ""};
+}
+
+const char* ResultsDatabase::Get_Verdict_Name(const MetricVerdict& verdict) {
+    switch(verdict) {
+        case MetricVerdict::unchanged: return "unchanged";
+        case MetricVerdict::improvement: return "improvement";
+        case MetricVerdict::regression: return "REGRESSION";
+        case MetricVerdict::insufficient_samples: return "insufficient_samples";
+        default: return "unknown";
+    }
+}
+
+
+const int Print_Metric_Comparisons(const std::vector<MetricComparison>& comparison_vec) {
+    int number_of_regressions = 0;
+    std::cout << std::fixed << std::setprecision(3);
+    for(const auto& comparison : comparison_vec) {
+        std::cout << std::setw(20) << std::left << ResultsDatabase::Get_Verdict_Name(comparison.verdict) << ' ' << comparison.metric << "  " << comparison.key << '\n'
+                  << "    baseline " << comparison.baseline_mean << " (n=" << comparison.baseline_samples << ")"
+                  << "  candidate " << comparison.candidate_mean << " (n=" << comparison.candidate_samples << ")";
+        if(comparison.verdict != MetricVerdict::insufficient_samples) {
+            std::cout << "  change " << std::showpos << comparison.change_percent << "% [" << comparison.change_low_percent << "%, "
+                      << comparison.change_high_percent << "%]" << std::noshowpos;
+        }
+        std::cout << '\n';
+        if(comparison.verdict == MetricVerdict::regression) {
+            number_of_regressions++;
+        }
+    }
+    std::cout << number_of_regressions << " regression(s) in " << comparison_vec.size() << " comparisons" << std::endl;
+    return number_of_regressions;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#define DEFAULT_RESULTS_DATABASE_PATH "geobin_results.jsonl"
+// relative change that has to be outside the confidence interval before compare calls it a regression
+#define DEFAULT_REGRESSION_THRESHOLD_PERCENT 1.0
+
+// what produced a record, filled in once per process
+// git revision, build type and flags are stamped in by cmake at configure time, so reconfigure after committing.
+// anything that can't be found out stays empty and is left out of the records
+struct RunInfo {
+    std::string run_id;
+    // GEOBIN_RUN_LABEL, lets several runs be pooled under one name for compare
+    std::string label;
+    std::string timestamp;
+    std::string git_revision;
+    std::string build_type;
+    std::string compiler;
+    std::string compiler_flags;
+    std::string cpu_model;
+    std::string hostname;
+};
+
+const RunInfo& Get_Run_Info();
+
+enum class MetricVerdict {
+    unchanged,
+    improvement,
+    regression,
+    insufficient_samples
+};
+
+// one metric of one (codec, directory) pair, baseline vs candidate
+struct MetricComparison {
+    std::string key;
+    std::string metric;
+    uint64_t baseline_samples = 0;
+    uint64_t candidate_samples = 0;
+    double baseline_mean = 0.0;
+    double candidate_mean = 0.0;
+    // relative change of the candidate mean and the 95% confidence interval around it, in percent
+    double change_percent = 0.0;
+    double change_low_percent = 0.0;
+    double change_high_percent = 0.0;
+    MetricVerdict verdict = MetricVerdict::insufficient_samples;
+};
+
+// append only JSON lines file, one line per (codec, directory) stats record, each tagged with the RunInfo that wrote it
+class ResultsDatabase {
+    public:
+        // Constructors
+        ResultsDatabase(const std::filesystem::path& database_path);
+
+        // record_json is a serialized json object (what Write_Stats_To_File writes), a "run" object is added to it
+        void Append_Record(const std::string& record_json) const;
+
+        // selectors match a run id, a label or a git revision prefix, "latest" and "previous" pick the last two run ids.
+        // every record is one sample (per iteration samples are used when the record has them),
+        // means are compared with a welch t interval at 95%
+        std::vector<MetricComparison> Compare_Runs(const std::string& baseline_selector, const std::string& candidate_selector,
+                                                   const double& threshold_percent) const;
+
+        //getters
+        const std::filesystem::path& Get_Database_Path() const;
+        // where compare reads from, GEOBIN_RESULTS_DB when set, DEFAULT_RESULTS_DATABASE_PATH otherwise
+        static std::filesystem::path Get_Default_Database_Path();
+        // where runs are recorded, opt in: GEOBIN_RESULTS_DB, empty (no recording) when it is unset or empty
+        static std::filesystem::path Get_Recording_Database_Path();
+        static const char* Get_Verdict_Name(const MetricVerdict& verdict);
+
+    private:
+        std::filesystem::path database_path;
+};
+
+// prints one line per metric, returns the number of regressions
+const int Print_Metric_Comparisons(const std::vector<MetricComparison>& comparison_vec);
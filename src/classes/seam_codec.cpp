@@ -0,0 +1,363 @@
+#include "seam_codec.hpp"
+#include "../functions/file_functions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define SEAM_FILE_MAGIC "GBSM"
+#define SEAM_FILE_VERSION 1
+
+
+template <typename T>
+static void Write_Value(std::ostream& output_stream, const T& value) {
+    output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T Read_Value(std::istream& input_stream) {
+    T value{};
+    input_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+static inline const uint32_t Get_Seam_Sample_Mask(const int& sample_width) {
+    return (sample_width >= 4) ? 0xFFFFFFFF : ((uint32_t{1} << (8 * sample_width)) - 1);
+}
+
+static inline const int64_t Sign_Extend_Sample(const uint32_t& sample, const int& sample_width) {
+    const int shift = 32 - 8 * sample_width;
+    return static_cast<int64_t>(static_cast<int32_t>(sample << shift) >> shift);
+}
+
+
+//Constructors
+SeamCodec::SeamCodec(const std::string& spec, const uint64_t& rows_per_band)
+    : pipeline(std::make_unique<CodecPipeline>(spec)), compression_type(std::string{"seam|"} + spec), rows_per_band(std::max<uint64_t>(rows_per_band, 1)) {}
+
+const uint32_t SeamCodec::Get_Edge_Sample(const Face& face, const uint8_t& edge, const uint64_t& index) const {
+    switch(edge) {
+        case 0: return face.sample_vec[index];
+        case 1: return face.sample_vec[(face.rows - 1) * samples_per_row + index];
+        case 2: return face.sample_vec[index * samples_per_row];
+        default: return face.sample_vec[index * samples_per_row + samples_per_row - 1];
+    }
+}
+
+uint32_t& SeamCodec::Get_Edge_Sample(Face& face, const uint8_t& edge, const uint64_t& index) {
+    switch(edge) {
+        case 0: return face.sample_vec[index];
+        case 1: return face.sample_vec[(face.rows - 1) * samples_per_row + index];
+        case 2: return face.sample_vec[index * samples_per_row];
+        default: return face.sample_vec[index * samples_per_row + samples_per_row - 1];
+    }
+}
+
+void SeamCodec::Get_Edge_Range(const Face& face, const uint8_t& edge, uint64_t& first_index, uint64_t& last_index) const {
+    first_index = 0;
+    last_index = samples_per_row;
+    if(edge >= 2) {
+        first_index = (face.edges_arr[0].source_face != SEAM_NO_SOURCE) ? 1 : 0;
+        last_index = face.rows - ((face.edges_arr[1].source_face != SEAM_NO_SOURCE) ? 1 : 0);
+    }
+}
+
+void SeamCodec::Get_Interior(const Face& face, uint64_t& first_row, uint64_t& last_row, uint64_t& first_column, uint64_t& last_column) const {
+    first_row = (face.edges_arr[0].source_face != SEAM_NO_SOURCE) ? 1 : 0;
+    last_row = face.rows - ((face.edges_arr[1].source_face != SEAM_NO_SOURCE) ? 1 : 0);
+    first_column = (face.edges_arr[2].source_face != SEAM_NO_SOURCE) ? 1 : 0;
+    last_column = samples_per_row - ((face.edges_arr[3].source_face != SEAM_NO_SOURCE) ? 1 : 0);
+}
+
+// an edge takes the earlier face edge (either direction) it differs least from, as long as that beats
+// the row or column next to it inside its own face, which is all the usual pipeline would have to go on
+void SeamCodec::Find_Seams(const uint64_t& face_index) {
+    Face& face = faces_vec[face_index];
+    face.edges_arr.fill(SeamEdge{});
+    if(face.rows != samples_per_row || samples_per_row < 3) {
+        return;
+    }
+    const uint64_t edge_length = samples_per_row;
+    for(uint8_t edge = 0; edge < SEAM_EDGES_PER_FACE; edge++) {
+        // the row or column one step inside the face
+        uint64_t inner_cost = 0;
+        for(uint64_t i = 0; i < edge_length; i++) {
+            uint32_t inner_sample = 0;
+            switch(edge) {
+                case 0: inner_sample = face.sample_vec[samples_per_row + i]; break;
+                case 1: inner_sample = face.sample_vec[(face.rows - 2) * samples_per_row + i]; break;
+                case 2: inner_sample = face.sample_vec[i * samples_per_row + 1]; break;
+                default: inner_sample = face.sample_vec[i * samples_per_row + samples_per_row - 2]; break;
+            }
+            inner_cost += std::abs(Sign_Extend_Sample(Get_Edge_Sample(face, edge, i), sample_width) - Sign_Extend_Sample(inner_sample, sample_width));
+        }
+
+        uint64_t best_cost = inner_cost;
+        for(uint64_t source_face = 0; source_face < face_index; source_face++) {
+            const Face& source = faces_vec[source_face];
+            if(source.rows != samples_per_row) {
+                continue;
+            }
+            for(uint8_t source_edge = 0; source_edge < SEAM_EDGES_PER_FACE; source_edge++) {
+                for(uint8_t reversed = 0; reversed < 2; reversed++) {
+                    uint64_t cost = 0;
+                    for(uint64_t i = 0; i < edge_length && cost <= best_cost; i++) {
+                        const uint32_t source_sample = Get_Edge_Sample(source, source_edge, reversed ? edge_length - 1 - i : i);
+                        cost += std::abs(Sign_Extend_Sample(Get_Edge_Sample(face, edge, i), sample_width) - Sign_Extend_Sample(source_sample, sample_width));
+                    }
+                    if(cost < best_cost || (cost == 0 && face.edges_arr[edge].source_face == SEAM_NO_SOURCE)) {
+                        best_cost = cost;
+                        face.edges_arr[edge] = SeamEdge{static_cast<uint8_t>(source_face), source_edge, reversed, static_cast<uint8_t>(cost == 0)};
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SeamCodec::Encode_Faces(const std::vector<std::filesystem::path>& face_paths, const std::filesystem::path& output_path, const uint64_t& samples_per_row) {
+    sample_width = std::max(1, this->Get_Data_Type_Size());
+    if(sample_width != 1 && sample_width != 2 && sample_width != 4) {
+        ERROR_MSG_AND_EXIT("Error: Invalid data type size.");
+    }
+    if(face_paths.empty() || face_paths.size() > SEAM_NO_SOURCE) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to code "} + std::to_string(face_paths.size()) + std::string{" faces together"});
+    }
+    this->samples_per_row = samples_per_row;
+    const uint64_t bytes_per_row = samples_per_row * sample_width;
+
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + output_path.string());
+    }
+    output_file.write(SEAM_FILE_MAGIC, 4);
+    Write_Value<uint8_t>(output_file, SEAM_FILE_VERSION);
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(sample_width));
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(face_paths.size()));
+    Write_Value<uint64_t>(output_file, samples_per_row);
+
+    pipeline->Set_Data_Type_Size(sample_width);
+    const uint32_t sample_mask = Get_Seam_Sample_Mask(sample_width);
+    const int sign_shift = 8 * sample_width - 1;
+    number_of_seams = 0;
+    number_of_exact_seams = 0;
+    faces_vec.assign(face_paths.size(), Face{});
+    for(uint64_t face_index = 0; face_index < face_paths.size(); face_index++) {
+        Face& face = faces_vec[face_index];
+        const uint64_t original_bytes = Get_File_Size_Bytes(face_paths[face_index]);
+        if(bytes_per_row == 0 || original_bytes % bytes_per_row != 0) {
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + face_paths[face_index].string() + std::string{" is not a whole number of rows of "} + std::to_string(samples_per_row) + std::string{" samples"});
+        }
+        face.rows = original_bytes / bytes_per_row;
+        std::ifstream input_file(face_paths[face_index], std::ios::binary);
+        band_vec.resize(original_bytes);
+        input_file.read(band_vec.data(), original_bytes);
+        if(!input_file) {
+            ERROR_MSG_AND_EXIT(std::string{"Error: Unable to read "} + face_paths[face_index].string());
+        }
+        face.sample_vec.assign(face.rows * samples_per_row, 0);
+        for(uint64_t i = 0; i < face.sample_vec.size(); i++) {
+            std::memcpy(&face.sample_vec[i], &band_vec[i * sample_width], sample_width);
+        }
+
+        // seam residuals, zigzagged like every other residual in the tree
+        this->Compute_Time_Encoded([&](){
+            Find_Seams(face_index);
+            band_vec.clear();
+            for(uint8_t edge = 0; edge < SEAM_EDGES_PER_FACE; edge++) {
+                const SeamEdge& seam = face.edges_arr[edge];
+                if(seam.source_face == SEAM_NO_SOURCE || seam.exact) {
+                    continue;
+                }
+                uint64_t first_index = 0;
+                uint64_t last_index = 0;
+                Get_Edge_Range(face, edge, first_index, last_index);
+                for(uint64_t i = first_index; i < last_index; i++) {
+                    const uint32_t prediction = Get_Edge_Sample(faces_vec[seam.source_face], seam.source_edge, seam.reversed ? samples_per_row - 1 - i : i);
+                    const uint32_t difference = (Get_Edge_Sample(face, edge, i) - prediction) & sample_mask;
+                    const uint32_t value = ((difference << 1) ^ (0u - ((difference >> sign_shift) & 1))) & sample_mask;
+                    band_vec.insert(band_vec.end(), reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sample_width);
+                }
+            }
+            if(!band_vec.empty()) {
+                pipeline->Set_Samples_Per_Row(samples_per_row);
+                pipeline->Set_Binary_Data_Vec(band_vec);
+                pipeline->Encode_Row();
+            }
+        });
+        Write_Value<uint64_t>(output_file, face.rows);
+        for(const SeamEdge& seam : face.edges_arr) {
+            Write_Value<uint8_t>(output_file, seam.source_face);
+            Write_Value<uint8_t>(output_file, seam.source_edge);
+            Write_Value<uint8_t>(output_file, seam.reversed);
+            Write_Value<uint8_t>(output_file, seam.exact);
+            number_of_seams += (seam.source_face != SEAM_NO_SOURCE);
+            number_of_exact_seams += (seam.source_face != SEAM_NO_SOURCE && seam.exact);
+        }
+        const uint32_t residual_bytes = band_vec.empty() ? 0 : static_cast<uint32_t>(pipeline->Get_Encoded_Data_Vec().size());
+        Write_Value<uint32_t>(output_file, residual_bytes);
+        output_file.write(pipeline->Get_Encoded_Data_Vec().data(), residual_bytes);
+
+        uint64_t first_row = 0;
+        uint64_t last_row = 0;
+        uint64_t first_column = 0;
+        uint64_t last_column = 0;
+        Get_Interior(face, first_row, last_row, first_column, last_column);
+        pipeline->Set_Samples_Per_Row(last_column - first_column);
+        for(uint64_t band_row = first_row; band_row < last_row; band_row += rows_per_band) {
+            this->Compute_Time_Encoded([&](){
+                band_vec.clear();
+                for(uint64_t row = band_row; row < std::min(band_row + rows_per_band, last_row); row++) {
+                    for(uint64_t column = first_column; column < last_column; column++) {
+                        const char* value_bytes = reinterpret_cast<const char*>(&face.sample_vec[row * samples_per_row + column]);
+                        band_vec.insert(band_vec.end(), value_bytes, value_bytes + sample_width);
+                    }
+                }
+                pipeline->Set_Binary_Data_Vec(band_vec);
+                pipeline->Encode_Row();
+            });
+            const std::vector<char>& encoded_vec = pipeline->Get_Encoded_Data_Vec();
+            Write_Value<uint32_t>(output_file, static_cast<uint32_t>(encoded_vec.size()));
+            output_file.write(encoded_vec.data(), encoded_vec.size());
+        }
+    }
+    if(!output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to write "} + output_path.string());
+    }
+}
+
+void SeamCodec::Decode_Faces(const std::filesystem::path& input_path, const std::vector<std::filesystem::path>& output_paths) {
+    std::ifstream input_file(input_path, std::ios::binary);
+    if(!input_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string());
+    }
+    char magic[4] = {0};
+    input_file.read(magic, 4);
+    const uint8_t version = Read_Value<uint8_t>(input_file);
+    if(std::memcmp(magic, SEAM_FILE_MAGIC, 4) != 0 || version != SEAM_FILE_VERSION) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is not a seam encoded file"});
+    }
+    sample_width = Read_Value<uint8_t>(input_file);
+    const uint8_t number_of_faces = Read_Value<uint8_t>(input_file);
+    samples_per_row = Read_Value<uint64_t>(input_file);
+    if(number_of_faces != output_paths.size() || (sample_width != 1 && sample_width != 2 && sample_width != 4)) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" holds "} + std::to_string(number_of_faces) + std::string{" faces, "} +
+                           std::to_string(output_paths.size()) + std::string{" output paths were given"});
+    }
+
+    pipeline->Set_Data_Type_Size(sample_width);
+    const uint32_t sample_mask = Get_Seam_Sample_Mask(sample_width);
+    std::vector<char> encoded_vec;
+    faces_vec.assign(number_of_faces, Face{});
+    for(uint64_t face_index = 0; face_index < number_of_faces; face_index++) {
+        Face& face = faces_vec[face_index];
+        face.rows = Read_Value<uint64_t>(input_file);
+        for(SeamEdge& seam : face.edges_arr) {
+            seam.source_face = Read_Value<uint8_t>(input_file);
+            seam.source_edge = Read_Value<uint8_t>(input_file);
+            seam.reversed = Read_Value<uint8_t>(input_file);
+            seam.exact = Read_Value<uint8_t>(input_file);
+            if(seam.source_face != SEAM_NO_SOURCE && (seam.source_face >= face_index || seam.source_edge >= SEAM_EDGES_PER_FACE ||
+               face.rows != samples_per_row || faces_vec[seam.source_face].rows != samples_per_row)) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" has a corrupt seam table"});
+            }
+        }
+        face.sample_vec.assign(face.rows * samples_per_row, 0);
+        encoded_vec.resize(Read_Value<uint32_t>(input_file));
+        input_file.read(encoded_vec.data(), encoded_vec.size());
+
+        uint64_t first_row = 0;
+        uint64_t last_row = 0;
+        uint64_t first_column = 0;
+        uint64_t last_column = 0;
+        Get_Interior(face, first_row, last_row, first_column, last_column);
+
+        this->Compute_Time_Decoded([&](){
+            band_vec.clear();
+            if(!encoded_vec.empty()) {
+                pipeline->Set_Samples_Per_Row(samples_per_row);
+                pipeline->Set_Encoded_Data_Vec(encoded_vec);
+                pipeline->Decode_Row();
+                band_vec = pipeline->Get_Decoded_Data_Vec();
+            }
+            uint64_t offset = 0;
+            for(uint8_t edge = 0; edge < SEAM_EDGES_PER_FACE; edge++) {
+                const SeamEdge& seam = face.edges_arr[edge];
+                if(seam.source_face == SEAM_NO_SOURCE) {
+                    continue;
+                }
+                uint64_t first_index = 0;
+                uint64_t last_index = 0;
+                Get_Edge_Range(face, edge, first_index, last_index);
+                for(uint64_t i = first_index; i < last_index; i++) {
+                    const uint32_t prediction = Get_Edge_Sample(faces_vec[seam.source_face], seam.source_edge, seam.reversed ? samples_per_row - 1 - i : i);
+                    uint32_t value = 0;
+                    if(!seam.exact) {
+                        if(offset + sample_width > band_vec.size()) {
+                            ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" has too few seam residuals"});
+                        }
+                        std::memcpy(&value, &band_vec[offset], sample_width);
+                        offset += sample_width;
+                    }
+                    Get_Edge_Sample(face, edge, i) = (prediction + (((value >> 1) ^ (0u - (value & 1))) & sample_mask)) & sample_mask;
+                }
+            }
+        });
+
+        pipeline->Set_Samples_Per_Row(last_column - first_column);
+        for(uint64_t band_row = first_row; band_row < last_row; band_row += rows_per_band) {
+            encoded_vec.resize(Read_Value<uint32_t>(input_file));
+            input_file.read(encoded_vec.data(), encoded_vec.size());
+            if(!input_file) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated"});
+            }
+            this->Compute_Time_Decoded([&](){
+                pipeline->Set_Encoded_Data_Vec(encoded_vec);
+                pipeline->Decode_Row();
+                const std::vector<char>& decoded_vec = pipeline->Get_Decoded_Data_Vec();
+                const uint64_t band_rows = std::min(band_row + rows_per_band, last_row) - band_row;
+                if(decoded_vec.size() != band_rows * (last_column - first_column) * sample_width) {
+                    ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" has a band of the wrong size"});
+                }
+                uint64_t offset = 0;
+                for(uint64_t row = band_row; row < band_row + band_rows; row++) {
+                    for(uint64_t column = first_column; column < last_column; column++) {
+                        std::memcpy(&face.sample_vec[row * samples_per_row + column], &decoded_vec[offset], sample_width);
+                        offset += sample_width;
+                    }
+                }
+            });
+        }
+
+        std::ofstream output_file(output_paths[face_index], std::ios::binary | std::ios::trunc);
+        band_vec.resize(face.sample_vec.size() * sample_width);
+        for(uint64_t i = 0; i < face.sample_vec.size(); i++) {
+            std::memcpy(&band_vec[i * sample_width], &face.sample_vec[i], sample_width);
+        }
+        output_file.write(band_vec.data(), band_vec.size());
+        if(!output_file) {
+            ERROR_MSG_AND_EXIT(std::string{"Error: Unable to write "} + output_paths[face_index].string());
+        }
+    }
+}
+
+//getters
+const char* SeamCodec::Get_Compression_Type() const {return compression_type.c_str();}
+const int SeamCodec::Get_Number_Of_Seams() const {return number_of_seams;}
+const int SeamCodec::Get_Number_Of_Exact_Seams() const {return number_of_exact_seams;}
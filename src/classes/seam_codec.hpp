@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include "codec_pipeline.hpp"
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define DEFAULT_SEAM_ROWS_PER_BAND 16
+#define SEAM_EDGES_PER_FACE 4
+#define SEAM_NO_SOURCE 0xFF
+
+// which earlier face's edge a face edge is predicted from. edges are 0 top row, 1 bottom row, 2 left column,
+// 3 right column, reversed runs the source edge backwards, exact edges are copied and not coded at all
+struct SeamEdge {
+    uint8_t source_face = SEAM_NO_SOURCE;
+    uint8_t source_edge = 0;
+    uint8_t reversed = 0;
+    uint8_t exact = 0;
+};
+
+// codes the cube faces of a layer (the tiles of every side with the same c and lod) together. neighbouring faces
+// repeat, or nearly repeat, each other's border samples. the seams are found from the data, any edge of an earlier
+// face in either direction can serve, so no particular cube layout is assumed. an edge that repeats an earlier face
+// is coded once, on the earlier face. an edge that is close to one goes in a residual stream against it, and
+// everything else keeps the usual pipeline.
+// file layout: "GBSM" | version u8 | data type size u8 | number of faces u8 | samples per row u64 |
+//              then per face: rows u64 | 4 x (source face u8 | source edge u8 | reversed u8 | exact u8) |
+//              seam residuals size u32 | seam residuals | per band of the interior: encoded band size u32 | encoded band
+class SeamCodec : public CommonStats {
+    public:
+        // Constructors
+        SeamCodec(const std::string& spec, const uint64_t& rows_per_band = DEFAULT_SEAM_ROWS_PER_BAND);
+
+        // face_paths in side order, seams are only looked for between square faces of the same shape
+        void Encode_Faces(const std::vector<std::filesystem::path>& face_paths, const std::filesystem::path& output_path, const uint64_t& samples_per_row);
+        // output_paths must hold as many paths as faces were encoded
+        void Decode_Faces(const std::filesystem::path& input_path, const std::vector<std::filesystem::path>& output_paths);
+
+        //getters
+        const char* Get_Compression_Type() const;
+        // seams found by the last Encode_Faces, and how many of them were exact
+        const int Get_Number_Of_Seams() const;
+        const int Get_Number_Of_Exact_Seams() const;
+
+    private:
+        struct Face {
+            uint64_t rows = 0;
+            std::vector<uint32_t> sample_vec;
+            std::array<SeamEdge, SEAM_EDGES_PER_FACE> edges_arr{};
+        };
+
+        const uint32_t Get_Edge_Sample(const Face& face, const uint8_t& edge, const uint64_t& index) const;
+        uint32_t& Get_Edge_Sample(Face& face, const uint8_t& edge, const uint64_t& index);
+        // the part of an edge a face codes from its seam. top and bottom take the corners, left and right what is left
+        void Get_Edge_Range(const Face& face, const uint8_t& edge, uint64_t& first_index, uint64_t& last_index) const;
+        void Find_Seams(const uint64_t& face_index);
+        // the interior: every row and column not taken by a seam
+        void Get_Interior(const Face& face, uint64_t& first_row, uint64_t& last_row, uint64_t& first_column, uint64_t& last_column) const;
+
+        std::unique_ptr<CodecPipeline> pipeline;
+        std::string compression_type;
+        uint64_t rows_per_band = DEFAULT_SEAM_ROWS_PER_BAND;
+        int sample_width = 1;
+        uint64_t samples_per_row = 0;
+        int number_of_seams = 0;
+        int number_of_exact_seams = 0;
+        std::vector<Face> faces_vec;
+        std::vector<char> band_vec;
+};
@@ -2,15 +2,16 @@
 
 
 #include "common_stats.hpp"
+#include "frequency_analyzer.hpp"
 #include <vector>
 
 class ShannonFano : public CommonStats {
     public:
         ShannonFano();
         void Write_Geobin_Data_As_Header_To_File(const std::filesystem::path& binary_path, const std::filesystem::path& header_path, const int& row_number, const int& number_of_bytes_to_read) const;
-        void Write_Binary_Frequencies_Per_Row_To_Json_File(const std::filesystem::path& binary_path, const std::filesystem::path& json_path,  const int& row_length, const uint64_t file_size) const;
-        void Write_Binary_Frequencies_Per_File_To_Json_File(const std::filesystem::path& binary_path, const std::filesystem::path& json_path, const int& number_of_bytes_to_read) const;
-
+        // per-row, per-block and per-file tables from one pass over the file
+        void Write_Binary_Frequencies_To_Table_File(const std::filesystem::path& binary_path, FrequencyTableWriter& table_writer, const uint64_t& row_length,
+                                                    const uint64_t& rows_per_block = DEFAULT_FREQUENCY_ROWS_PER_BLOCK) const;
 
     private:
         const char* compression_type = "ShannonFano";
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+// bounded lock-free single producer / single consumer ring
+// exactly one thread may call Push/Try_Push and exactly one (other) thread Pop/Try_Pop
+template <typename T>
+class SpscQueue {
+    public:
+        // capacity is rounded up to a power of two so the index wrap is a mask
+        explicit SpscQueue(const size_t& minimum_capacity) {
+            size_t capacity = 2;
+            while(capacity < minimum_capacity) {
+                capacity <<= 1;
+            }
+            slots_vec.resize(capacity);
+            index_mask = capacity - 1;
+        }
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        bool Try_Push(const T& value) {
+            const size_t tail = tail_index.load(std::memory_order_relaxed);
+            if(tail - cached_head_index == slots_vec.size()) {
+                cached_head_index = head_index.load(std::memory_order_acquire);
+                if(tail - cached_head_index == slots_vec.size()) {
+                    return false;
+                }
+            }
+            slots_vec[tail & index_mask] = value;
+            tail_index.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool Try_Pop(T& value) {
+            const size_t head = head_index.load(std::memory_order_relaxed);
+            if(head == cached_tail_index) {
+                cached_tail_index = tail_index.load(std::memory_order_acquire);
+                if(head == cached_tail_index) {
+                    return false;
+                }
+            }
+            value = slots_vec[head & index_mask];
+            head_index.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // spin, then yield, a full or empty queue means the other side is the bottleneck
+        void Push(const T& value) {
+            for(int spin = 0; !Try_Push(value); spin++) {
+                if(spin > 64) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        T Pop() {
+            T value;
+            for(int spin = 0; !Try_Pop(value); spin++) {
+                if(spin > 64) {
+                    std::this_thread::yield();
+                }
+            }
+            return value;
+        }
+
+        const size_t Get_Capacity() const {return slots_vec.size();}
+
+    private:
+        std::vector<T> slots_vec;
+        size_t index_mask = 0;
+
+        // producer and consumer indices live on separate cache lines, each side caches the other's index
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_index{0};
+        size_t cached_tail_index = 0;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_index{0};
+        size_t cached_head_index = 0;
+};
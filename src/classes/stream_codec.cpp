@@ -0,0 +1,228 @@
+#include "stream_codec.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+
+#define ERROR_MSG(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << '\n'; \
+
+#define ERROR_MSG_AND_EXIT(msg) \
+    std::cerr << msg << " OCCURED IN: " << '\n'; \
+    std::cerr << "      File: " << __FILE__ << '\n'; \
+    std::cerr << "      Function: " << __PRETTY_FUNCTION__ << '\n'; \
+    std::cerr << "      Line: " << __LINE__ << std::endl; \
+    std::exit(EXIT_FAILURE);
+
+#define PRINT_DEBUG(msg) \
+    std::cerr << msg << '\n'; \
+
+#define STREAM_FILE_MAGIC "GBSC"
+#define STREAM_FILE_VERSION 1
+#define CHUNK_FRAME_HEADER_BYTES (sizeof(uint32_t) + sizeof(uint64_t))
+
+
+template <typename T>
+static void Write_Value(std::ostream& output_stream, const T& value) {
+    output_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T Read_Value(std::istream& input_stream) {
+    T value{};
+    input_stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return value;
+}
+
+template <typename T>
+static void Append_Value(std::vector<char>& buffer_vec, const T& value) {
+    const size_t write_index = buffer_vec.size();
+    buffer_vec.resize(write_index + sizeof(T));
+    std::memcpy(&buffer_vec[write_index], &value, sizeof(T));
+}
+
+void For_Each_File_Chunk(const std::filesystem::path& file_path, const uint64_t& chunk_bytes, const uint64_t& alignment_bytes,
+                         const std::function<void(const std::vector<char>&)>& chunk_function) {
+    std::ifstream input_file(file_path, std::ios::binary);
+    if(!input_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + file_path.string());
+    }
+
+    const uint64_t alignment = std::max<uint64_t>(alignment_bytes, 1);
+    const uint64_t aligned_chunk_bytes = std::max(alignment, chunk_bytes - (chunk_bytes % alignment));
+    std::vector<char> chunk_vec;
+    while(true) {
+        chunk_vec.resize(aligned_chunk_bytes);
+        input_file.read(chunk_vec.data(), aligned_chunk_bytes);
+        chunk_vec.resize(input_file.gcount());
+        if(chunk_vec.empty()) {
+            break;
+        }
+        chunk_function(chunk_vec);
+    }
+}
+
+
+//Constructors
+StreamCodec::StreamCodec(const std::string& spec, const uint64_t& memory_budget_bytes) : pipeline(std::make_unique<CodecPipeline>(spec)), memory_budget_bytes(memory_budget_bytes) {}
+
+// two read buffers, the write buffer and slack for pipelines that expand a chunk share the budget
+const uint64_t StreamCodec::Get_Chunk_Bytes(const uint64_t& bytes_per_row) const {
+    if(bytes_per_row == 0) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: unable to stream rows of 0 bytes, samples per row and data type size must both be set"});
+    }
+    const uint64_t chunk_bytes = memory_budget_bytes / 4;
+    return std::max(bytes_per_row, chunk_bytes - (chunk_bytes % bytes_per_row));
+}
+
+void StreamCodec::Encode_Stream(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row) {
+    const int data_type_size = std::max(1, this->Get_Data_Type_Size());
+    const uint64_t bytes_per_row = samples_per_row * data_type_size;
+    const uint64_t chunk_bytes = Get_Chunk_Bytes(bytes_per_row);
+
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    const std::string& spec = pipeline->Get_Spec();
+    output_file.write(STREAM_FILE_MAGIC, 4);
+    Write_Value<uint8_t>(output_file, STREAM_FILE_VERSION);
+    Write_Value<uint8_t>(output_file, static_cast<uint8_t>(data_type_size));
+    Write_Value<uint64_t>(output_file, samples_per_row);
+    Write_Value<uint64_t>(output_file, chunk_bytes);
+    Write_Value<uint16_t>(output_file, static_cast<uint16_t>(spec.size()));
+    output_file.write(spec.data(), spec.size());
+
+    pipeline->Set_Data_Type_Size(data_type_size);
+    pipeline->Set_Samples_Per_Row(samples_per_row);
+
+    auto read_chunk = [&input_file, chunk_bytes](std::vector<char>& buffer_vec) {
+        buffer_vec.resize(chunk_bytes);
+        input_file.read(buffer_vec.data(), chunk_bytes);
+        buffer_vec.resize(input_file.gcount());
+    };
+
+    int current_buffer = 0;
+    read_chunk(read_buffer_vecs[current_buffer]);
+    while(!read_buffer_vecs[current_buffer].empty()) {
+        // start filling the other half of the window while this chunk is encoded
+        std::future<void> next_chunk = std::async(std::launch::async, read_chunk, std::ref(read_buffer_vecs[1 - current_buffer]));
+
+        const std::vector<char>& chunk_vec = read_buffer_vecs[current_buffer];
+        write_buffer_vec.clear();
+        uint32_t rows_in_chunk = 0;
+        for(uint64_t offset = 0; offset < chunk_vec.size(); offset += bytes_per_row) {
+            pipeline->Set_Binary_Data(&chunk_vec[offset], std::min<uint64_t>(bytes_per_row, chunk_vec.size() - offset));
+            this->Compute_Time_Encoded([this](){
+                pipeline->Encode_Row();
+            });
+
+            const std::vector<char>& encoded_vec = pipeline->Get_Encoded_Data_Vec();
+            Append_Value<uint32_t>(write_buffer_vec, static_cast<uint32_t>(encoded_vec.size()));
+            write_buffer_vec.insert(write_buffer_vec.end(), encoded_vec.begin(), encoded_vec.end());
+            rows_in_chunk++;
+        }
+
+        Write_Value<uint32_t>(output_file, rows_in_chunk);
+        Write_Value<uint64_t>(output_file, static_cast<uint64_t>(write_buffer_vec.size()));
+        output_file.write(write_buffer_vec.data(), write_buffer_vec.size());
+
+        next_chunk.get();
+        current_buffer = 1 - current_buffer;
+    }
+}
+
+void StreamCodec::Decode_Stream(const std::filesystem::path& input_path, const std::filesystem::path& output_path) {
+    std::ifstream input_file(input_path, std::ios::binary);
+    std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+    if(!input_file || !output_file) {
+        ERROR_MSG_AND_EXIT(std::string{"Error: Unable to open "} + input_path.string() + std::string{" or "} + output_path.string());
+    }
+
+    char magic[4] = {0};
+    input_file.read(magic, 4);
+    if(std::memcmp(magic, STREAM_FILE_MAGIC, 4) != 0 || Read_Value<uint8_t>(input_file) != STREAM_FILE_VERSION) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: Not a stream encoded geobin file: "} + input_path.string());
+    }
+    const uint8_t data_type_size = Read_Value<uint8_t>(input_file);
+    const uint64_t samples_per_row = Read_Value<uint64_t>(input_file);
+    Read_Value<uint64_t>(input_file);
+    std::string spec(Read_Value<uint16_t>(input_file), '\0');
+    input_file.read(spec.data(), spec.size());
+
+    if(spec != pipeline->Get_Spec()) {
+        pipeline = std::make_unique<CodecPipeline>(spec);
+    }
+    this->Set_Data_Type_Size(data_type_size);
+    pipeline->Set_Data_Type_Size(data_type_size);
+    pipeline->Set_Samples_Per_Row(samples_per_row);
+
+    // a frame is [rows u32][payload bytes u64][payload], an empty buffer marks the end of the file
+    auto read_frame = [&input_file](std::vector<char>& buffer_vec) {
+        buffer_vec.resize(CHUNK_FRAME_HEADER_BYTES);
+        input_file.read(buffer_vec.data(), CHUNK_FRAME_HEADER_BYTES);
+        if(input_file.gcount() != static_cast<std::streamsize>(CHUNK_FRAME_HEADER_BYTES)) {
+            buffer_vec.clear();
+            return;
+        }
+        uint64_t payload_bytes = 0;
+        std::memcpy(&payload_bytes, &buffer_vec[sizeof(uint32_t)], sizeof(uint64_t));
+        buffer_vec.resize(CHUNK_FRAME_HEADER_BYTES + payload_bytes);
+        input_file.read(&buffer_vec[CHUNK_FRAME_HEADER_BYTES], payload_bytes);
+        // a truncated payload keeps only what was read, the row sizes are checked against it
+        buffer_vec.resize(CHUNK_FRAME_HEADER_BYTES + input_file.gcount());
+    };
+
+    int current_buffer = 0;
+    read_frame(read_buffer_vecs[current_buffer]);
+    while(!read_buffer_vecs[current_buffer].empty()) {
+        std::future<void> next_frame = std::async(std::launch::async, read_frame, std::ref(read_buffer_vecs[1 - current_buffer]));
+
+        const std::vector<char>& frame_vec = read_buffer_vecs[current_buffer];
+        uint32_t rows_in_chunk = 0;
+        std::memcpy(&rows_in_chunk, frame_vec.data(), sizeof(uint32_t));
+
+        size_t read_index = CHUNK_FRAME_HEADER_BYTES;
+        for(uint32_t row = 0; row < rows_in_chunk; row++) {
+            if(read_index + sizeof(uint32_t) > frame_vec.size()) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated or corrupt, row "} + std::to_string(row) + std::string{" of a chunk is missing"});
+            }
+            uint32_t encoded_size = 0;
+            std::memcpy(&encoded_size, &frame_vec[read_index], sizeof(uint32_t));
+            read_index += sizeof(uint32_t);
+            if(read_index + encoded_size > frame_vec.size()) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + input_path.string() + std::string{" is truncated or corrupt, row "} + std::to_string(row) + std::string{" runs past the end of its chunk"});
+            }
+
+            pipeline->Set_Encoded_Data(frame_vec.data() + read_index, encoded_size);
+            read_index += encoded_size;
+            this->Compute_Time_Decoded([this](){
+                pipeline->Decode_Row();
+            });
+
+            const std::vector<char>& decoded_vec = pipeline->Get_Decoded_Data_Vec();
+            output_file.write(decoded_vec.data(), decoded_vec.size());
+        }
+
+        next_frame.get();
+        current_buffer = 1 - current_buffer;
+    }
+}
+
+//getters
+const char* StreamCodec::Get_Compression_Type() const {return pipeline->Get_Compression_Type();}
+
+const uint64_t StreamCodec::Get_Buffer_Bytes() const {
+    return read_buffer_vecs[0].capacity() + read_buffer_vecs[1].capacity() + write_buffer_vec.capacity();
+}
+
+//setters
+void StreamCodec::Set_Memory_Budget_Bytes(const uint64_t& memory_budget_bytes) {
+    this->memory_budget_bytes = memory_budget_bytes;
+}
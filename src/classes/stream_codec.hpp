@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common_stats.hpp"
+#include "codec_pipeline.hpp"
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <filesystem>
+
+#define DEFAULT_STREAM_MEMORY_BUDGET_BYTES (256ull << 20)
+
+// reads a file in chunks of at most chunk_bytes (rounded down to alignment_bytes) and hands each one to chunk_function
+// only one chunk is ever resident, so callers can walk files of any size
+void For_Each_File_Chunk(const std::filesystem::path& file_path, const uint64_t& chunk_bytes, const uint64_t& alignment_bytes,
+                         const std::function<void(const std::vector<char>&)>& chunk_function);
+
+// chunked encoder/decoder that keeps a fixed memory footprint no matter how large the file is
+// file layout: "GBSC" | version u8 | data type size u8 | samples per row u64 | chunk bytes u64 | spec length u16 | spec |
+//              then per chunk: rows in chunk u32 | chunk payload bytes u64 | (encoded row size u32, encoded row)...
+class StreamCodec : public CommonStats {
+    public:
+        // Constructors
+        StreamCodec(const std::string& spec, const uint64_t& memory_budget_bytes);
+
+        void Encode_Stream(const std::filesystem::path& input_path, const std::filesystem::path& output_path, const uint64_t& samples_per_row);
+        void Decode_Stream(const std::filesystem::path& input_path, const std::filesystem::path& output_path);
+
+        //getters
+        const char* Get_Compression_Type() const;
+        const uint64_t Get_Chunk_Bytes(const uint64_t& bytes_per_row) const;
+        const uint64_t Get_Buffer_Bytes() const;
+
+        //setters
+        void Set_Memory_Budget_Bytes(const uint64_t& memory_budget_bytes);
+
+    private:
+        std::unique_ptr<CodecPipeline> pipeline;
+        uint64_t memory_budget_bytes = DEFAULT_STREAM_MEMORY_BUDGET_BYTES;
+        // double buffered window, one chunk is being read while the other is being coded
+        std::array<std::vector<char>, 2> read_buffer_vecs;
+        std::vector<char> write_buffer_vec;
+};
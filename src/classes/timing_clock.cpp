@@ -0,0 +1,63 @@
+#include "timing_clock.hpp"
+#include <algorithm>
+#include <limits>
+
+#define TIMER_CALIBRATION_NANOSECONDS 20000000ull
+#define TIMER_OVERHEAD_SAMPLES 10000
+
+
+static uint64_t Read_Monotonic_Raw_Nanoseconds() {
+    timespec time_spec;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &time_spec);
+    return static_cast<uint64_t>(time_spec.tv_sec) * 1000000000ull + static_cast<uint64_t>(time_spec.tv_nsec);
+}
+
+static double Calibrate_Nanoseconds_Per_Tick() {
+#ifdef GEOBIN_TIMER_RDTSCP
+    // spin against the raw monotonic clock long enough that the clock_gettime cost is noise
+    const uint64_t start_nanoseconds = Read_Monotonic_Raw_Nanoseconds();
+    const uint64_t start_ticks = Read_Timer_Ticks();
+    uint64_t end_nanoseconds = start_nanoseconds;
+    while(end_nanoseconds - start_nanoseconds < TIMER_CALIBRATION_NANOSECONDS) {
+        end_nanoseconds = Read_Monotonic_Raw_Nanoseconds();
+    }
+    const uint64_t end_ticks = Read_Timer_Ticks();
+    return static_cast<double>(end_nanoseconds - start_nanoseconds) / static_cast<double>(std::max<uint64_t>(1, end_ticks - start_ticks));
+#else
+    return 1.0;
+#endif
+}
+
+static uint64_t Calibrate_Overhead_Ticks() {
+    uint64_t overhead_ticks = std::numeric_limits<uint64_t>::max();
+    for(int sample = 0; sample < TIMER_OVERHEAD_SAMPLES; sample++) {
+        const uint64_t start_ticks = Read_Timer_Ticks();
+        const uint64_t end_ticks = Read_Timer_Ticks();
+        overhead_ticks = std::min(overhead_ticks, end_ticks - start_ticks);
+    }
+    return overhead_ticks;
+}
+
+const double Get_Timer_Nanoseconds_Per_Tick() {
+    static const double nanoseconds_per_tick = Calibrate_Nanoseconds_Per_Tick();
+    return nanoseconds_per_tick;
+}
+
+const uint64_t Get_Timer_Overhead_Ticks() {
+    static const uint64_t overhead_ticks = Calibrate_Overhead_Ticks();
+    return overhead_ticks;
+}
+
+const uint64_t Timer_Ticks_To_Nanoseconds(const uint64_t& elapsed_ticks) {
+    const uint64_t overhead_ticks = Get_Timer_Overhead_Ticks();
+    const uint64_t ticks = (elapsed_ticks > overhead_ticks) ? elapsed_ticks - overhead_ticks : 0;
+    return static_cast<uint64_t>(static_cast<double>(ticks) * Get_Timer_Nanoseconds_Per_Tick() + 0.5);
+}
+
+const char* Get_Timer_Name() {
+#ifdef GEOBIN_TIMER_RDTSCP
+    return "rdtscp";
+#else
+    return "clock_monotonic_raw";
+#endif
+}
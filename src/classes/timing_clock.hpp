@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+// rdtscp on x86-64 (assumes an invariant TSC, true for anything recent), CLOCK_MONOTONIC_RAW everywhere else
+// build with -DGEOBIN_TIMER_CLOCK_GETTIME to force the portable clock
+#if defined(__x86_64__) && !defined(GEOBIN_TIMER_CLOCK_GETTIME)
+#include <x86intrin.h>
+#define GEOBIN_TIMER_RDTSCP
+#endif
+
+// raw timestamp, TSC cycles or nanoseconds depending on the backend
+inline uint64_t Read_Timer_Ticks() {
+#ifdef GEOBIN_TIMER_RDTSCP
+    unsigned int processor_id = 0;
+    // rdtscp waits for earlier instructions, the fence keeps later ones from starting before the read
+    const uint64_t ticks = __rdtscp(&processor_id);
+    _mm_lfence();
+    return ticks;
+#else
+    timespec time_spec;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &time_spec);
+    return static_cast<uint64_t>(time_spec.tv_sec) * 1000000000ull + static_cast<uint64_t>(time_spec.tv_nsec);
+#endif
+}
+
+// both are measured once, on first use
+const double Get_Timer_Nanoseconds_Per_Tick();
+// cheapest back to back pair of reads, subtracted from every sample
+const uint64_t Get_Timer_Overhead_Ticks();
+
+// removes the read overhead and converts to nanoseconds, never below 0
+const uint64_t Timer_Ticks_To_Nanoseconds(const uint64_t& elapsed_ticks);
+const char* Get_Timer_Name();
@@ -2,6 +2,18 @@
 #include "../classes/rlr_class.hpp"
 #include "../classes/common_stats.hpp"
 #include "../classes/shannon_fano.hpp"
+#include "../classes/codec_pipeline.hpp"
+#include "../classes/codec_selector.hpp"
+#include "../classes/stream_codec.hpp"
+#include "../classes/async_pipeline.hpp"
+#include "../classes/context_model_codec.hpp"
+#include "../classes/pyramid_codec.hpp"
+#include "../classes/progressive_codec.hpp"
+#include "../classes/seam_codec.hpp"
+#include "../classes/corpus_generator.hpp"
+#include "../classes/repetition_harness.hpp"
+#include "../classes/geobin_catalog.hpp"
+#include "../classes/directory_walker.hpp"
 #include <nlohmann/json.hpp>
 #include <filesystem>
 #include <fstream>
@@ -29,34 +41,25 @@
 
 using json = nlohmann::json;
 
+// fixed seed, so the same arguments always give the same file
 void Generate_Random_Binary_File(const char* filename, long long fileSize, double zeroProbability) {
-    // std::ofstream outFile(filename, std::ios::binary);
-    // if (!outFile) {
-    //     std::cout << "Error: Unable to open the file for writing." << '\n';
-    //     return;
-    // }
-
-    // // Determine the number of zero bytes to write
-    // long long zeroBytes = static_cast<long long>(zeroProbability * fileSize);
-
-    // for (long long i = 0; i < zeroBytes; ++i) {
-    //     char byte = 0;  // Write zero bytes
-    //     outFile.write(reinterpret_cast<const char*>(&byte), sizeof(char));
-    // }
-
-    // // Determine the number of non-zero bytes to write
-    // long long nonZeroBytes = fileSize - zeroBytes;
-
-    // std::default_random_engine generator;
-    // std::bernoulli_distribution distribution(0.5); // 50% probability for non-zero bits
-
-    // for (long long i = 0; i < nonZeroBytes; ++i) {
-    //     bool bit = distribution(generator);
-    //     char byte = static_cast<char>(bit);
-    //     outFile.write(reinterpret_cast<const char*>(&byte), sizeof(char));
-    // }
+    std::ofstream outFile(filename, std::ios::binary);
+    if (!outFile) {
+        ERROR_MSG_AND_EXIT(std::string{"ERROR: Unable to open the file for writing: "} + std::string{filename});
+    }
 
-    // outFile.close();
+    uint64_t random_state = DEFAULT_CORPUS_SEED;
+    std::vector<char> chunk_vec(MAX_CHUNK_SIZE);
+    for(long long written = 0; written < fileSize; written += MAX_CHUNK_SIZE) {
+        const size_t chunk_size = static_cast<size_t>(std::min<long long>(MAX_CHUNK_SIZE, fileSize - written));
+        for(size_t i = 0; i < chunk_size; i++) {
+            const uint64_t random_value = Next_Corpus_Random(random_state);
+            // top 53 bits decide zero or not, the low byte is the value (0 is mapped to 1 so zeros stay at zeroProbability)
+            const bool zero_byte = static_cast<double>(random_value >> 11) * 0x1.0p-53 < zeroProbability;
+            chunk_vec[i] = zero_byte ? 0 : static_cast<char>(std::max<uint64_t>(random_value & 0xff, 1));
+        }
+        outFile.write(chunk_vec.data(), chunk_size);
+    }
 }
 
 
@@ -70,6 +73,27 @@ const uint64_t Get_File_Size_Bytes(const std::filesystem::path& file_path)
 
 }
 
+// compares two files chunk by chunk so neither has to fit in memory
+const bool Are_Files_Equal(const std::filesystem::path& first_path, const std::filesystem::path& second_path) {
+    if(Get_File_Size_Bytes(first_path) != Get_File_Size_Bytes(second_path)) {
+        return false;
+    }
+
+    std::ifstream first_file(first_path, std::ios::binary);
+    std::ifstream second_file(second_path, std::ios::binary);
+    std::vector<char> first_chunk_vec(MAX_CHUNK_SIZE);
+    std::vector<char> second_chunk_vec(MAX_CHUNK_SIZE);
+    while(first_file && second_file) {
+        first_file.read(first_chunk_vec.data(), MAX_CHUNK_SIZE);
+        second_file.read(second_chunk_vec.data(), MAX_CHUNK_SIZE);
+        if(first_file.gcount() != second_file.gcount() ||
+           !std::equal(first_chunk_vec.begin(), first_chunk_vec.begin() + first_file.gcount(), second_chunk_vec.begin())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Function to return the number of Geobin files in a directory
 const int Get_Number_Of_Geobin_Files_In_Directory(const std::filesystem::path& dir_path) {
     try {
@@ -106,17 +130,19 @@ const int Get_Number_Of_Geometa_Files(const std::filesystem::path& dir_path){
 }
 
 const std::filesystem::path  Get_Geometa_File_Path(const std::filesystem::path& dir_path) {
-
-    try{
-        for(const auto& entry : std::filesystem::recursive_directory_iterator(dir_path)) {
-            if(std::filesystem::is_regular_file(entry.status()) && (entry.path().extension() == std::filesystem::path{".geometa"})) {
-                return entry.path();
-            }
+    if(const GeobinCatalog* catalog = Get_Active_Geobin_Catalog()) {
+        if(const CatalogDirectory* directory = catalog->Find_Directory(dir_path)) {
+            return directory->geometa_path;
         }
-    } catch(const std::exception& e) {
-        ERROR_MSG_AND_EXIT(std::string{"Error accessing geometa file for " + dir_path.string() + ": " + std::string{e.what()}});
     }
 
+    // dir_path itself comes first in the sorted walk, then its subdirectories
+    for(const auto& walked_directory : DirectoryWalker().Walk(dir_path)) {
+        if(!walked_directory.geometa_name_vec.empty()) {
+            return walked_directory.directory_path / walked_directory.geometa_name_vec.front();
+        }
+    }
+    ERROR_MSG_AND_EXIT(std::string{"Error accessing geometa file for " + dir_path.string() + ": no geometa file found"});
 }
 
 void Delete_Files_In_Directory(const std::filesystem::path& dir_path) {
@@ -132,40 +158,40 @@ void Delete_Files_In_Directory(const std::filesystem::path& dir_path) {
 }
 
 const std::vector<std::filesystem::path> Get_Geobin_File_Vec(const std::filesystem::path& dir_path) {
-    try {
-        std::vector<std::filesystem::path> geobin_files_vec;
-
-        for(const auto& entry : std::filesystem::recursive_directory_iterator(dir_path)) {
-            if(std::filesystem::is_regular_file(entry.status()) && (entry.path().extension() == std::filesystem::path{".geobin"})) {
-                geobin_files_vec.push_back(entry.path());
-            }
+    if(const GeobinCatalog* catalog = Get_Active_Geobin_Catalog()) {
+        if(const CatalogDirectory* directory = catalog->Find_Directory(dir_path)) {
+            return catalog->Get_Geobin_File_Vec(*directory);
         }
+    }
 
-        return geobin_files_vec;
-    } catch(const std::exception& e) {
-        ERROR_MSG_AND_EXIT(std::string{"Error accessing geobin files in directory " + dir_path.string() + ": " + std::string{e.what()}});
+    std::vector<std::filesystem::path> geobin_files_vec;
+    for(const auto& walked_directory : DirectoryWalker().Walk(dir_path)) {
+        for(const auto& geobin_name : walked_directory.geobin_name_vec) {
+            geobin_files_vec.push_back(walked_directory.directory_path / geobin_name);
+        }
     }
+    return geobin_files_vec;
 }
 
 const std::vector<std::filesystem::path> Get_Geobin_And_Geometa_Directory_Path_Vec(const std::filesystem::path& dir_path) {
-    try {
-        std::vector<std::filesystem::path> geobin_and_geometa_directory_path_vec;
+    // the catalog already knows which directories hold both, as long as dir_path is inside its tree
+    if(const GeobinCatalog* catalog = Get_Active_Geobin_Catalog()) {
+        if(Is_Path_Under(dir_path, catalog->Get_Root_Path())) {
+            return catalog->Get_Directory_Path_Vec(dir_path);
+        }
+    }
 
-        for(const auto& entry : std::filesystem::recursive_directory_iterator(dir_path)) {
-            if(std::filesystem::is_directory(entry.status())) {
-                if(Get_Number_Of_Geobin_Files_In_Directory(entry.path()) > 0 && Get_Number_Of_Geometa_Files(entry.path()) > 0) {
-                    geobin_and_geometa_directory_path_vec.push_back(entry.path());
+    // one parallel walk finds the pairs, no per-directory recount
+    std::vector<std::filesystem::path> geobin_and_geometa_directory_path_vec;
+    for(const auto& walked_directory : DirectoryWalker().Walk(dir_path)) {
+        if(walked_directory.Has_Geobin_And_Geometa()) {
+            geobin_and_geometa_directory_path_vec.push_back(walked_directory.directory_path);
 #ifdef DEBUG_MODE
-                    PRINT_DEBUG(std::string{"Directory with geobin and geometa files: " + entry.path().string()});
+            PRINT_DEBUG(std::string{"Directory with geobin and geometa files: " + walked_directory.directory_path.string()});
 #endif
-                }
-            }
         }
-
-        return geobin_and_geometa_directory_path_vec;
-    } catch(const std::exception& e) {
-        ERROR_MSG_AND_EXIT(std::string{"Error accessing geobin files in directory " + dir_path.string() + ": " + std::string{e.what()}});
     }
+    return geobin_and_geometa_directory_path_vec;
 }
 
 std::filesystem::path Remove_all_Seperators_From_Path(const std::filesystem::path& path) {
@@ -176,33 +202,14 @@ std::filesystem::path Remove_all_Seperators_From_Path(const std::filesystem::pat
 }
 
 const uint64_t Get_Side_Resolution(const std::filesystem::path& stem_path, CommonStats& stats_obj) {
-    auto extract_character_after = [](const std::filesystem::path& path, const std::string& delimiter) -> const std::string {
-    const std::string filename = path.filename().string();
-    size_t pos = filename.rfind(delimiter);
-    if (pos != std::string::npos) {
-        size_t start = pos + delimiter.length();
-        while ((start < filename.length()) && !std::isdigit(filename[start])) {
-            start++;
-        }
-        size_t end = start;
-        while ((end < filename.length()) && std::isdigit(filename[end])) {
-            end++;
-        }
-
-        if (start < end) {
-            return filename.substr(start, end - start);
-        }
+    // the stem alone fixes the lod, callers only hand over the stem so there is no directory to look the entry up in
+    uint8_t side = 0;
+    uint8_t c_number = 0;
+    uint8_t lod_number = 0;
+    if(!Parse_Geobin_File_Name(stem_path.filename().string(), side, c_number, lod_number)) {
+        lod_number = static_cast<uint8_t>(Get_Lod_Number(stem_path));
     }
 #ifdef DEBUG_MODE
-    ERROR_MSG_AND_EXIT(std::string{"ERROR: Unable to extract number after delimiter: " + delimiter});
-#endif
-};
-
-
-    const uint8_t lod_number = static_cast<uint8_t>(std::stoi(extract_character_after(stem_path, std::string{"_lod"})));
-#ifdef DEBUG_MODE
-    const uint8_t side = static_cast<uint8_t>(std::stoi(extract_character_after(stem_path, std::string{"_s"})));
-    const uint8_t c_number = static_cast<uint8_t>(std::stoi(extract_character_after(stem_path, std::string{"_c"})));
     PRINT_DEBUG(std::string{"Side: "} + std::to_string(side));
     PRINT_DEBUG(std::string{"C Number: "} + std::to_string(c_number));
     PRINT_DEBUG(std::string{"LOD Number: "} + std::to_string(lod_number));
@@ -220,6 +227,13 @@ const uint64_t Get_Side_Resolution(const std::filesystem::path& stem_path, Commo
 }
 
 const int Get_Lod_Number(const std::filesystem::path& stem_path) {
+    uint8_t side = 0;
+    uint8_t c_number = 0;
+    uint8_t parsed_lod_number = 0;
+    if(Parse_Geobin_File_Name(stem_path.filename().string(), side, c_number, parsed_lod_number)) {
+        return parsed_lod_number;
+    }
+
     auto extract_character_after = [](const std::filesystem::path& path, const std::string& delimiter) -> const std::string {
     const std::string filename = path.filename().string();
     size_t pos = filename.rfind(delimiter);
@@ -245,6 +259,7 @@ const int Get_Lod_Number(const std::filesystem::path& stem_path) {
     return std::stoi(extract_character_after(stem_path, std::string{"_lod"}));
 }
 
+// legacy driver, not wired to a command, it runs neither warm-up nor from memory
 void Run_RLR_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, RLR& rlr_obj) {
 #ifdef DEBUG_MODE
     assert(std::filesystem::equivalent(files_vec[0].parent_path(), files_vec.at(0).parent_path()));
@@ -432,24 +447,482 @@ void Run_RLR_Compression_Decompression_On_Files(const std::vector<std::filesyste
     }
 }
 
+// the file is read once and every iteration codes it from memory, nothing is written back.
+// warm-up iterations run the same rows untimed, measured iterations are timed and kept as separate samples
+void Run_Pipeline_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, CodecPipeline& pipeline) {
+    pipeline.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    std::vector<char> file_vec;
+    for(const auto& file : files_vec) {
+        const uint64_t file_size = Get_File_Size_Bytes(file);
+
+#ifdef DEBUG_MODE
+        PRINT_DEBUG(std::string{"File to be compressed: " + file.string()});
+#endif
+        const std::filesystem::path stem_path = file.stem();
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, pipeline);
+        const uint64_t bytes_per_row = side_resolution * pipeline.Get_Data_Type_Size();
+        const uint64_t num_rows = file_size / bytes_per_row;
+        pipeline.Set_Samples_Per_Row(side_resolution);
+
+#ifdef DEBUG_MODE
+        PRINT_DEBUG(std::string{"Number of rows: " + std::to_string(num_rows)});
+        PRINT_DEBUG(std::string{"Bytes per row: " + std::to_string(bytes_per_row)});
+        if(file_size % bytes_per_row != 0) {
+            PRINT_DEBUG(std::string{"ERROR: File size is not a multiple of the number of bytes per row."});
+            PRINT_DEBUG(std::string{"ERROR: You are trying to compress " + file.string()});
+            ERROR_MSG_AND_EXIT(std::string{"ERROR:"});
+        }
+#endif
+        file_vec.resize(num_rows * bytes_per_row);
+        std::ifstream input_file(file, std::ios::binary);
+        if(!input_file.read(file_vec.data(), file_vec.size())) {
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: Unable to read " + file.string()});
+        }
+
+        for(int iteration = 0; iteration < pipeline.Get_Warmup_Iterations() + pipeline.Get_Number_Of_Iterations(); iteration++){
+            const bool measured = (iteration >= pipeline.Get_Warmup_Iterations());
+            if(measured && pipeline.Get_Flush_Caches_Between_Iterations()) {
+                Flush_Data_Caches();
+            }
+
+            uint64_t compressed_bytes = 0;
+            for(uint64_t row = 0; row<num_rows; row++){
+                pipeline.Set_Binary_Data(&file_vec[row * bytes_per_row], bytes_per_row);
+
+                if(measured) {
+                    pipeline.Compute_Time_Encoded([&pipeline](){
+                        pipeline.Encode_Row();
+                    });
+                    pipeline.Compute_Time_Decoded([&pipeline](){
+                        pipeline.Decode_Row();
+                    });
+                } else {
+                    pipeline.Encode_Row();
+                    pipeline.Decode_Row();
+                }
+                compressed_bytes += pipeline.Get_Encoded_Data_Vec().size();
+
+                if(!pipeline.Is_Decoded_Data_Equal_To_Original_Data(pipeline.Get_Decoded_Data_Vec(), pipeline.Get_Binary_Data_Vec())){
+                    ERROR_MSG_AND_EXIT(std::string{"ERROR: Decoded data is not equal to original data for pipeline " + pipeline.Get_Spec()});
+                }
+            }
+            if(measured) {
+                pipeline.Compute_Compression_Ratio(file_vec.size(), compressed_bytes);
+                pipeline.Compute_Compressed_File_Size(compressed_bytes);
+                pipeline.End_Measured_Iteration(iteration - pipeline.Get_Warmup_Iterations(), file_vec.size(), compressed_bytes);
+            }
+        }
+    }
+}
+
+// the file level drivers from here on time only the coding inside their codecs and read and write real files between
+// the timers, so unlike the pipeline driver they do not code from memory. their warm-up goes through Run_Warmup_Iterations
+void Run_Auto_Pipeline_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, CodecSelector& selector) {
+    selector.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    for(const auto& file : files_vec) {
+        const uint64_t file_size = Get_File_Size_Bytes(file);
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_auto_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".auto_encoded"})};
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, selector);
+        const uint64_t bytes_per_row = side_resolution * selector.Get_Data_Type_Size();
+        const uint64_t num_rows = file_size / bytes_per_row;
+        const uint64_t rows_per_block = (selector.Get_Rows_Per_Block() == 0) ? num_rows : selector.Get_Rows_Per_Block();
+
+        // pick a pipeline per block from a sample of its rows, the choices go into the header
+        AutoFileHeader header;
+        header.data_type_size = static_cast<uint8_t>(selector.Get_Data_Type_Size());
+        header.samples_per_row = side_resolution;
+        header.number_of_rows = num_rows;
+        header.rows_per_block = rows_per_block;
+        for(uint64_t first_row = 0; first_row < num_rows; first_row += rows_per_block) {
+            const uint64_t rows_in_block = std::min(rows_per_block, num_rows - first_row);
+            const std::string spec = selector.Select_Pipeline(selector.Read_Sample_Rows(file, bytes_per_row, first_row, rows_in_block), side_resolution).spec;
+
+            const auto spec_it = std::find(header.spec_vec.begin(), header.spec_vec.end(), spec);
+            if(spec_it == header.spec_vec.end()) {
+                header.spec_vec.push_back(spec);
+            }
+            header.block_spec_index_vec.push_back(static_cast<uint16_t>(std::find(header.spec_vec.begin(), header.spec_vec.end(), spec) - header.spec_vec.begin()));
+#ifdef DEBUG_MODE
+            PRINT_DEBUG(file.string() + std::string{" rows "} + std::to_string(first_row) + std::string{"+: "} + spec);
+#endif
+        }
+
+        std::vector<char> row_vec(bytes_per_row);
+        auto code_file = [&]() {
+            {
+                std::ifstream input_file(file, std::ios::binary);
+                std::ofstream encoded_file(encoded_file_path, std::ios::binary | std::ios::trunc);
+                Write_Auto_File_Header(encoded_file, header);
+
+                for(uint64_t row = 0; row < num_rows; row++){
+                    CodecPipeline& pipeline = selector.Get_Pipeline(header.spec_vec[header.block_spec_index_vec[row / rows_per_block]]);
+                    pipeline.Set_Data_Type_Size(selector.Get_Data_Type_Size());
+                    pipeline.Set_Samples_Per_Row(side_resolution);
+
+                    input_file.read(row_vec.data(), bytes_per_row);
+                    pipeline.Set_Binary_Data_Vec(row_vec);
+                    selector.Compute_Time_Encoded([&pipeline](){
+                        pipeline.Encode_Row();
+                    });
+
+                    const uint32_t encoded_size = static_cast<uint32_t>(pipeline.Get_Encoded_Data_Vec().size());
+                    encoded_file.write(reinterpret_cast<const char*>(&encoded_size), sizeof(encoded_size));
+                    encoded_file.write(pipeline.Get_Encoded_Data_Vec().data(), encoded_size);
+                }
+            }
+
+            // decode purely from what the header says and check against the original rows
+            {
+                std::ifstream input_file(file, std::ios::binary);
+                std::ifstream encoded_file(encoded_file_path, std::ios::binary);
+                const AutoFileHeader read_header = Read_Auto_File_Header(encoded_file);
+                std::vector<char> encoded_row_vec;
+
+                for(uint64_t row = 0; row < read_header.number_of_rows; row++){
+                    CodecPipeline& pipeline = selector.Get_Pipeline(read_header.spec_vec[read_header.block_spec_index_vec[row / read_header.rows_per_block]]);
+                    pipeline.Set_Data_Type_Size(read_header.data_type_size);
+                    pipeline.Set_Samples_Per_Row(read_header.samples_per_row);
+
+                    uint32_t encoded_size = 0;
+                    encoded_file.read(reinterpret_cast<char*>(&encoded_size), sizeof(encoded_size));
+                    encoded_row_vec.resize(encoded_size);
+                    encoded_file.read(encoded_row_vec.data(), encoded_size);
+                    pipeline.Set_Encoded_Data_Vec(encoded_row_vec);
+
+                    selector.Compute_Time_Decoded([&pipeline](){
+                        pipeline.Decode_Row();
+                    });
+
+                    input_file.read(row_vec.data(), bytes_per_row);
+                    if(!selector.Is_Decoded_Data_Equal_To_Original_Data(pipeline.Get_Decoded_Data_Vec(), row_vec)){
+                        ERROR_MSG_AND_EXIT(std::string{"ERROR: Decoded data is not equal to original data for "} + file.string());
+                    }
+                }
+            }
+        };
+        selector.Run_Warmup_Iterations(code_file);
+        for(int iteration = 0; iteration < selector.Get_Number_Of_Iterations(); iteration++){
+            code_file();
+            selector.Compute_Compression_Ratio(file, encoded_file_path);
+            selector.Compute_Compressed_File_Size(encoded_file_path);
+        }
+        std::filesystem::remove_all(encoded_file_path.parent_path().parent_path());
+    }
+}
+
+void Run_Stream_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, StreamCodec& stream_codec) {
+    const std::filesystem::path geometa_path = Get_Geometa_File_Path(files_vec.at(0).parent_path());
+
+    for(const auto& file : files_vec) {
+        // decoding takes the data type size from the stream header, so restore it from the geometa for every file
+        stream_codec.Set_Data_Type_Size_And_Side_Resolutions(geometa_path);
+
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_stream_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".stream_encoded"})};
+        const std::filesystem::path decoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_stream_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".stream_decoded"})};
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, stream_codec);
+        stream_codec.Run_Warmup_Iterations([&](){
+            stream_codec.Encode_Stream(file, encoded_file_path, side_resolution);
+            stream_codec.Decode_Stream(encoded_file_path, decoded_file_path);
+        });
+        for(int iteration = 0; iteration < stream_codec.Get_Number_Of_Iterations(); iteration++){
+            stream_codec.Encode_Stream(file, encoded_file_path, side_resolution);
+            stream_codec.Decode_Stream(encoded_file_path, decoded_file_path);
+
+            if(!Are_Files_Equal(file, decoded_file_path)) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: Stream decoded file is not equal to original file "} + file.string());
+            }
+#ifdef DEBUG_MODE
+            PRINT_DEBUG(std::string{"Stream buffers held: " + std::to_string(stream_codec.Get_Buffer_Bytes()) + " bytes"});
+#endif
+            stream_codec.Compute_Compression_Ratio(file, encoded_file_path);
+            stream_codec.Compute_Compressed_File_Size(encoded_file_path);
+        }
+        std::filesystem::remove_all(encoded_file_path.parent_path().parent_path());
+    }
+}
+
+void Run_Async_Pipeline_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, AsyncPipelineCodec& async_codec) {
+    async_codec.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    for(const auto& file : files_vec) {
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_async_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".async_encoded"})};
+        const std::filesystem::path decoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_async_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".async_decoded"})};
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, async_codec);
+        async_codec.Run_Warmup_Iterations([&](){
+            async_codec.Encode_File(file, encoded_file_path, side_resolution);
+            async_codec.Decode_File(encoded_file_path, decoded_file_path);
+        });
+        for(int iteration = 0; iteration < async_codec.Get_Number_Of_Iterations(); iteration++){
+            async_codec.Encode_File(file, encoded_file_path, side_resolution);
+            async_codec.Decode_File(encoded_file_path, decoded_file_path);
+
+            if(!Are_Files_Equal(file, decoded_file_path)) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: Async decoded file is not equal to original file "} + file.string());
+            }
+            async_codec.Compute_Compression_Ratio(file, encoded_file_path);
+            async_codec.Compute_Compressed_File_Size(encoded_file_path);
+        }
+        std::filesystem::remove_all(encoded_file_path.parent_path().parent_path());
+    }
+}
+
+void Run_Context_Model_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, ContextModelCodec& context_model_codec) {
+    context_model_codec.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    for(const auto& file : files_vec) {
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_cm_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".cm_encoded"})};
+        const std::filesystem::path decoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_cm_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".cm_decoded"})};
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, context_model_codec);
+        context_model_codec.Run_Warmup_Iterations([&](){
+            context_model_codec.Encode_File(file, encoded_file_path, side_resolution);
+            context_model_codec.Decode_File(encoded_file_path, decoded_file_path);
+        });
+        for(int iteration = 0; iteration < context_model_codec.Get_Number_Of_Iterations(); iteration++){
+            context_model_codec.Encode_File(file, encoded_file_path, side_resolution);
+            context_model_codec.Decode_File(encoded_file_path, decoded_file_path);
+
+            if(!Are_Files_Equal(file, decoded_file_path)) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: Context model decoded file is not equal to original file "} + file.string());
+            }
+            context_model_codec.Compute_Compression_Ratio(file, encoded_file_path);
+            context_model_codec.Compute_Compressed_File_Size(encoded_file_path);
+        }
+        std::filesystem::remove_all(encoded_file_path.parent_path().parent_path());
+    }
+}
+
+void Run_Pyramid_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, PyramidCodec& pyramid_codec) {
+    pyramid_codec.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    std::vector<std::filesystem::path> ordered_files_vec = files_vec;
+    std::stable_sort(ordered_files_vec.begin(), ordered_files_vec.end(), [](const std::filesystem::path& a, const std::filesystem::path& b) {
+        return Get_Lod_Number(a.stem()) < Get_Lod_Number(b.stem());
+    });
+
+    const std::filesystem::path work_directory_path = files_vec.at(0).parent_path() / std::filesystem::path{"compressed_decompressed_pyramid_files"};
+    // geobin path -> its decoded copy, the parent every finer lod is decoded against
+    std::unordered_map<std::string, std::filesystem::path> decoded_file_path_map;
+    for(const auto& file : ordered_files_vec) {
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = work_directory_path / stem_path / std::filesystem::path{(stem_path.string() + std::string{".pyramid_encoded"})};
+        const std::filesystem::path decoded_file_path = work_directory_path / stem_path / std::filesystem::path{(stem_path.string() + std::string{".pyramid_decoded"})};
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        const std::filesystem::path parent_path = PyramidCodec::Find_Parent_Geobin_Path(file);
+        std::filesystem::path decoded_parent_path = parent_path;
+        if(!parent_path.empty() && decoded_file_path_map.count(parent_path.string()) != 0) {
+            decoded_parent_path = decoded_file_path_map[parent_path.string()];
+        }
+
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, pyramid_codec);
+        pyramid_codec.Run_Warmup_Iterations([&](){
+            pyramid_codec.Encode_File(file, encoded_file_path, side_resolution, parent_path);
+            pyramid_codec.Decode_File(encoded_file_path, decoded_file_path, decoded_parent_path);
+        });
+        for(int iteration = 0; iteration < pyramid_codec.Get_Number_Of_Iterations(); iteration++){
+            pyramid_codec.Encode_File(file, encoded_file_path, side_resolution, parent_path);
+            pyramid_codec.Decode_File(encoded_file_path, decoded_file_path, decoded_parent_path);
+
+            if(!Are_Files_Equal(file, decoded_file_path)) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: Pyramid decoded file is not equal to original file "} + file.string());
+            }
+            pyramid_codec.Compute_Compression_Ratio(file, encoded_file_path);
+            pyramid_codec.Compute_Compressed_File_Size(encoded_file_path);
+        }
+        decoded_file_path_map[file.string()] = decoded_file_path;
+    }
+    std::filesystem::remove_all(work_directory_path);
+}
+
+void Run_Progressive_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, ProgressiveCodec& progressive_codec) {
+    progressive_codec.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    const int data_type_size = progressive_codec.Get_Data_Type_Size();
+    for(const auto& file : files_vec) {
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_progressive_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".progressive_encoded"})};
+        const std::filesystem::path decoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_progressive_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".progressive_decoded"})};
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, progressive_codec);
+        progressive_codec.Run_Warmup_Iterations([&](){
+            progressive_codec.Encode_File(file, encoded_file_path, side_resolution);
+            progressive_codec.Decode_File(encoded_file_path, decoded_file_path);
+        });
+        for(int iteration = 0; iteration < progressive_codec.Get_Number_Of_Iterations(); iteration++){
+            progressive_codec.Encode_File(file, encoded_file_path, side_resolution);
+            progressive_codec.Decode_File(encoded_file_path, decoded_file_path);
+
+            if(!Are_Files_Equal(file, decoded_file_path)) {
+                ERROR_MSG_AND_EXIT(std::string{"ERROR: Progressive decoded file is not equal to original file "} + file.string());
+            }
+            progressive_codec.Compute_Compression_Ratio(file, encoded_file_path);
+            progressive_codec.Compute_Compressed_File_Size(encoded_file_path);
+        }
+
+        // the coarsest level alone must come back as the decimated original. Decode_Prefix is untimed,
+        // so this check (unlike Decode_File) stays out of the stats
+        std::ifstream original_file(file, std::ios::binary);
+        std::ifstream encoded_file(encoded_file_path, std::ios::binary);
+        const std::vector<char> original_vec((std::istreambuf_iterator<char>(original_file)), std::istreambuf_iterator<char>());
+        const std::vector<char> encoded_vec((std::istreambuf_iterator<char>(encoded_file)), std::istreambuf_iterator<char>());
+        std::vector<char> coarse_vec;
+        uint64_t coarse_samples_per_row = 0;
+        const uint64_t prefix_bytes = ProgressiveCodec::Get_Prefix_Bytes(encoded_vec.data(), encoded_vec.size(), 1);
+        if(progressive_codec.Decode_Prefix(encoded_vec.data(), std::min<uint64_t>(prefix_bytes, encoded_vec.size()), coarse_vec, coarse_samples_per_row) != 1) {
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: Progressive coarsest level does not decode on its own "} + file.string());
+        }
+        const uint64_t stride = progressive_codec.Get_Grid_Stride();
+        const uint64_t rows = original_vec.size() / (side_resolution * data_type_size);
+        uint64_t offset = 0;
+        for(uint64_t row = 0; row < rows; row += stride) {
+            for(uint64_t column = 0; column < side_resolution; column += stride) {
+                if(offset + data_type_size > coarse_vec.size() ||
+                   std::memcmp(&coarse_vec[offset], &original_vec[(row * side_resolution + column) * data_type_size], data_type_size) != 0) {
+                    ERROR_MSG_AND_EXIT(std::string{"ERROR: Progressive coarse grid does not match the original "} + file.string());
+                }
+                offset += data_type_size;
+            }
+        }
+        std::filesystem::remove_all(encoded_file_path.parent_path().parent_path());
+    }
+}
+
+void Run_Seam_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files_vec, SeamCodec& seam_codec) {
+    seam_codec.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files_vec.at(0).parent_path()));
+
+    std::unordered_map<std::string, std::filesystem::path> file_path_map;
+    for(const auto& file : files_vec) {
+        file_path_map[file.filename().string()] = file;
+    }
+    const GeobinCatalog* catalog = Get_Active_Geobin_Catalog();
+    for(const auto& file : files_vec) {
+        if(file_path_map.count(file.filename().string()) == 0) {
+            continue;
+        }
+        // the files of this c and lod, one per side, each file is only coded with the first group it shows up in
+        std::vector<std::filesystem::path> face_paths_vec;
+        const CatalogEntry* entry = (catalog != nullptr) ? catalog->Find_Entry(file) : nullptr;
+        if(entry != nullptr) {
+            for(const CatalogEntry* side_entry : catalog->Find_Side_Entries(*entry)) {
+                if(file_path_map.count(side_entry->file_name) != 0) {
+                    face_paths_vec.push_back(file_path_map[side_entry->file_name]);
+                }
+            }
+        }
+        if(face_paths_vec.empty()) {
+            face_paths_vec.push_back(file);
+        }
+        for(const auto& face_path : face_paths_vec) {
+            file_path_map.erase(face_path.filename().string());
+        }
+
+        const std::filesystem::path stem_path = file.stem();
+        const std::filesystem::path encoded_file_path = file.parent_path() / std::filesystem::path{"compressed_decompressed_seam_files"} /
+                                                        stem_path / std::filesystem::path{(stem_path.string() + std::string{".seam_encoded"})};
+        std::vector<std::filesystem::path> decoded_paths_vec;
+        for(const auto& face_path : face_paths_vec) {
+            decoded_paths_vec.push_back(encoded_file_path.parent_path() / std::filesystem::path{(face_path.stem().string() + std::string{".seam_decoded"})});
+        }
+
+        if(!std::filesystem::exists(encoded_file_path.parent_path())) {
+            std::filesystem::create_directories(encoded_file_path.parent_path());
+        }
+
+        uint64_t original_bytes = 0;
+        for(const auto& face_path : face_paths_vec) {
+            original_bytes += Get_File_Size_Bytes(face_path);
+        }
+        const uint64_t side_resolution = Get_Side_Resolution(stem_path, seam_codec);
+        seam_codec.Run_Warmup_Iterations([&](){
+            seam_codec.Encode_Faces(face_paths_vec, encoded_file_path, side_resolution);
+            seam_codec.Decode_Faces(encoded_file_path, decoded_paths_vec);
+        });
+        for(int iteration = 0; iteration < seam_codec.Get_Number_Of_Iterations(); iteration++){
+            seam_codec.Encode_Faces(face_paths_vec, encoded_file_path, side_resolution);
+            seam_codec.Decode_Faces(encoded_file_path, decoded_paths_vec);
+
+            for(size_t i = 0; i < face_paths_vec.size(); i++) {
+                if(!Are_Files_Equal(face_paths_vec[i], decoded_paths_vec[i])) {
+                    ERROR_MSG_AND_EXIT(std::string{"ERROR: Seam decoded file is not equal to original file "} + face_paths_vec[i].string());
+                }
+            }
+            // every face is credited the ratio of its group and its own share of the group's bytes, so the sizes
+            // add up to the group once, like the time spent on it
+            const uint64_t compressed_bytes = Get_File_Size_Bytes(encoded_file_path);
+            for(size_t i = 0; i < face_paths_vec.size(); i++) {
+                const uint64_t face_bytes = Get_File_Size_Bytes(face_paths_vec[i]);
+                seam_codec.Compute_Compression_Ratio(face_bytes, static_cast<uint64_t>(static_cast<double>(compressed_bytes) * face_bytes / original_bytes + 0.5));
+            }
+            seam_codec.Compute_Compressed_File_Size(compressed_bytes);
+        }
+
+#ifdef DEBUG_MODE
+        PRINT_DEBUG(stem_path.string() + std::string{": "} + std::to_string(face_paths_vec.size()) + std::string{" faces, "} +
+                    std::to_string(seam_codec.Get_Number_Of_Seams()) + std::string{" seams, "} + std::to_string(seam_codec.Get_Number_Of_Exact_Seams()) + std::string{" exact"});
+#endif
+        std::filesystem::remove_all(encoded_file_path.parent_path().parent_path());
+    }
+}
+
 void Write_Shannon_Fano_Frequencies_To_Files(const std::vector<std::filesystem::path>& files, ShannonFano& shannon_fano) {
     shannon_fano.Set_Data_Type_Size_And_Side_Resolutions(Get_Geometa_File_Path(files.at(0).parent_path()));
 
     for(const auto& file : files) {
         const std::filesystem::path stem_path = file.stem();
-        const std::filesystem::path json_path = std::filesystem::path{"shannon_fano_frequency_files"} /
-                                                        file.parent_path() / std::filesystem::path{stem_path.string() + std::string{".json"}};
+        const std::filesystem::path table_path = std::filesystem::path{"shannon_fano_frequency_files"} /
+                                                        file.parent_path() / std::filesystem::path{stem_path.string() + std::string{".geofreq"}};
 
-        if(!std::filesystem::exists(json_path.parent_path())) {
-            std::filesystem::create_directories(json_path.parent_path());
+        if(!std::filesystem::exists(table_path.parent_path())) {
+            std::filesystem::create_directories(table_path.parent_path());
         }
         // const int lod_number = Get_Lod_Number(stem_path);
         const uint64_t side_resolution = Get_Side_Resolution(stem_path, shannon_fano);
         uint64_t bytes_per_row = side_resolution * shannon_fano.Get_Data_Type_Size();
-        uint64_t num_rows = Get_File_Size_Bytes(file) / bytes_per_row;
-
 
 #ifdef DEBUG_MODE
+        uint64_t num_rows = Get_File_Size_Bytes(file) / bytes_per_row;
         PRINT_DEBUG(std::string{"Number of rows: " + std::to_string(num_rows)});
         PRINT_DEBUG(std::string{"Bytes per row: " + std::to_string(bytes_per_row)});
         if(Get_File_Size_Bytes(file) % bytes_per_row != 0) {
@@ -467,15 +940,9 @@ void Write_Shannon_Fano_Frequencies_To_Files(const std::vector<std::filesystem::
         }
 #endif
 
-        if(shannon_fano.Get_Data_Type_Size() == 4) {
-            shannon_fano.Write_Binary_Frequencies_Per_File_To_Json_File(file, json_path,  Get_File_Size_Bytes(file));
-        } else {
-            for(uint64_t row = 0; row<num_rows; row++){
-                shannon_fano.Write_Binary_Frequencies_Per_Row_To_Json_File(file, json_path, row, bytes_per_row);
-            }
-        }
-
-        // shannon_fano.Write_Binary_Frequencies_Per_File_To_Json_File(file, json_path,  Get_File_Size_Bytes(file));
+        // the writer owns the whole file and writes it once when it goes out of scope
+        FrequencyTableWriter table_writer(table_path);
+        shannon_fano.Write_Binary_Frequencies_To_Table_File(file, table_writer, bytes_per_row);
 
         // shannon_fano.Write_Frequencies_To_JSON_File(file, json_path);
     }
@@ -7,6 +7,14 @@
 
 
 class RLR;
+class CodecPipeline;
+class CodecSelector;
+class StreamCodec;
+class AsyncPipelineCodec;
+class ContextModelCodec;
+class PyramidCodec;
+class ProgressiveCodec;
+class SeamCodec;
 // class LZW_Stats;
 // class LZP_Stats;
 // class Huffman_Stats;
@@ -18,6 +26,8 @@ void Generate_Random_Binary_File(const char* filename, long long fileSize, doubl
 
 const uint64_t Get_File_Size_Bytes(const std::filesystem::path& file_path);
 
+const bool Are_Files_Equal(const std::filesystem::path& first_path, const std::filesystem::path& second_path);
+
 const int Get_Number_Of_Geobin_Files_In_Directory(const std::filesystem::path& dir_path);
 
 const int Get_Number_Of_Geometa_Files(const std::filesystem::path& dir_path);
@@ -38,4 +48,22 @@ const int Get_Lod_Number(const std::filesystem::path& stem_path);
 
 void Run_RLR_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, RLR& rlr_obj);
 
+void Run_Pipeline_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, CodecPipeline& pipeline);
+
+void Run_Auto_Pipeline_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, CodecSelector& selector);
+
+void Run_Stream_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, StreamCodec& stream_codec);
+
+void Run_Async_Pipeline_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, AsyncPipelineCodec& async_codec);
+
+void Run_Context_Model_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, ContextModelCodec& context_model_codec);
+
+// files are coded coarsest lod first, so every tile is decoded against its parent's decoded output
+void Run_Pyramid_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, PyramidCodec& pyramid_codec);
+
+void Run_Progressive_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, ProgressiveCodec& progressive_codec);
+
+// the sides of every c and lod are coded together, the catalog says which files those are
+void Run_Seam_Compression_Decompression_On_Files(const std::vector<std::filesystem::path>& files, SeamCodec& seam_codec);
+
 void Write_Shannon_Fano_Frequencies_To_Files(const std::vector<std::filesystem::path>& files, ShannonFano& shannon_fano);
\ No newline at end of file
@@ -13,6 +13,20 @@
 #include "classes/common_stats.hpp"
 #include "classes/rlr_class.hpp"
 #include "classes/shannon_fano.hpp"
+#include "classes/codec_pipeline.hpp"
+#include "classes/codec_selector.hpp"
+#include "classes/stream_codec.hpp"
+#include "classes/async_pipeline.hpp"
+#include "classes/context_model_codec.hpp"
+#include "classes/pyramid_codec.hpp"
+#include "classes/progressive_codec.hpp"
+#include "classes/seam_codec.hpp"
+#include "classes/corpus_generator.hpp"
+#include "classes/results_database.hpp"
+#include "classes/repetition_harness.hpp"
+#include "classes/pareto_report.hpp"
+#include "classes/geobin_catalog.hpp"
+#include "classes/frequency_table.hpp"
 // #include "classes/lz4_class.hpp"
 // #include "classes/lzw_class.h"
 // #include "classes/lzp_class.h"
@@ -42,8 +56,252 @@
 // pass the encoded and decoded data to the computeFileStats function
 // compute the stats and store them in the common stats class
 
+#define DEFAULT_MEASURED_ITERATIONS 5
+#define DEFAULT_WARMUP_ITERATIONS 1
+
+// loads the tree's catalog, then for every directory holding geobins and a geometa runs run_on_files(files, codec) and
+// writes the directory's averages to <stats_directory>/<directory>_stats.json. the codec is reset between directories
+template <typename Codec, typename RunOnFiles>
+static void Run_On_Directory_Tree(Codec& codec, const std::filesystem::path& root_path, const std::string& stats_directory, RunOnFiles run_on_files) {
+    Load_And_Activate_Geobin_Catalog(root_path);
+    const std::vector<std::filesystem::path> geometa_and_geobin_dir_path_vec = Get_Geobin_And_Geometa_Directory_Path_Vec(root_path);
+    for(size_t i = 0; i < geometa_and_geobin_dir_path_vec.size(); i++){
+        std::vector<std::filesystem::path> geobin_files_vec = Get_Geobin_File_Vec(geometa_and_geobin_dir_path_vec[i]);
+        run_on_files(geobin_files_vec, codec);
+
+        codec.Calculate_Cumulative_Average_Stats_For_Directory(geobin_files_vec.size());
+        codec.Compute_Encoded_Throughput();
+        codec.Compute_Decoded_Throughput();
+        codec.Write_Stats_To_File(std::filesystem::path{stats_directory} /
+                                  std::filesystem::path{Remove_all_Seperators_From_Path(geometa_and_geobin_dir_path_vec[i]).string() +
+                                  std::string{"_stats.json"}}, codec.Get_Compression_Type(), geometa_and_geobin_dir_path_vec[i].string());
+        codec.Reset_Stats();
+    }
+}
+
+// geobin_compression pipeline "<spec>" [planet data dir] [rows per timing sample] [measured iterations] [warm-up iterations]
+static void Run_Pipeline_On_Directory_Tree(const std::string& spec, const std::filesystem::path& root_path, const uint32_t& rows_per_timing_sample,
+                                           const int& measured_iterations, const int& warmup_iterations) {
+    CodecPipeline pipeline(spec);
+    pipeline.Set_Number_Of_Iterations(measured_iterations);
+    pipeline.Set_Warmup_Iterations(warmup_iterations);
+    pipeline.Set_Rows_Per_Timing_Sample(rows_per_timing_sample);
+
+    Run_On_Directory_Tree(pipeline, root_path, std::string{"pipeline_stats"}, Run_Pipeline_Compression_Decompression_On_Files);
+}
+
+// geobin_compression auto [min decode MB/s] [planet data dir] [rows per block]
+static void Run_Auto_Pipeline_On_Directory_Tree(const SelectionObjective& objective, const std::filesystem::path& root_path, const uint64_t& rows_per_block) {
+    CodecSelector selector(CodecSelector::Get_Default_Candidate_Specs(), objective);
+    selector.Set_Number_Of_Iterations(1);
+    selector.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+    selector.Set_Rows_Per_Block(rows_per_block);
+
+    Run_On_Directory_Tree(selector, root_path, std::string{selector.Get_Compression_Type()} + std::string{"_stats"}, Run_Auto_Pipeline_Compression_Decompression_On_Files);
+}
+
+// geobin_compression stream "<spec>" [planet data dir] [memory budget MB]
+static void Run_Stream_On_Directory_Tree(const std::string& spec, const std::filesystem::path& root_path, const uint64_t& memory_budget_bytes) {
+    StreamCodec stream_codec(spec, memory_budget_bytes);
+    stream_codec.Set_Number_Of_Iterations(1);
+    stream_codec.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+
+    Run_On_Directory_Tree(stream_codec, root_path, std::string{"stream_stats"}, Run_Stream_Compression_Decompression_On_Files);
+}
+
+// geobin_compression async "<spec>" [planet data dir] [worker threads]
+static void Run_Async_Pipeline_On_Directory_Tree(const std::string& spec, const std::filesystem::path& root_path, const int& number_of_workers) {
+    AsyncPipelineCodec async_codec(spec, number_of_workers);
+    async_codec.Set_Number_Of_Iterations(1);
+    async_codec.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+
+    Run_On_Directory_Tree(async_codec, root_path, std::string{"async_stats"}, Run_Async_Pipeline_Compression_Decompression_On_Files);
+}
+
+// geobin_compression archive [planet data dir] [mixing 0|1] [threads] [tile rows]
+static void Run_Context_Model_On_Directory_Tree(const std::filesystem::path& root_path, const bool& mixing, const int& number_of_threads, const uint64_t& tile_rows) {
+    ContextModelCodec context_model_codec(mixing, number_of_threads, tile_rows);
+    context_model_codec.Set_Number_Of_Iterations(1);
+    context_model_codec.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+
+    Run_On_Directory_Tree(context_model_codec, root_path, std::string{"archive_stats"}, Run_Context_Model_Compression_Decompression_On_Files);
+}
+
+// geobin_compression pyramid "<residual spec>" [planet data dir]
+static void Run_Pyramid_On_Directory_Tree(const std::string& spec, const std::filesystem::path& root_path) {
+    PyramidCodec pyramid_codec(spec);
+    pyramid_codec.Set_Number_Of_Iterations(1);
+    pyramid_codec.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+
+    // the parent lod of every tile is found through the catalog
+    Run_On_Directory_Tree(pyramid_codec, root_path, std::string{"pyramid_stats"}, Run_Pyramid_Compression_Decompression_On_Files);
+}
+
+// geobin_compression progressive "<residual spec>" [planet data dir] [levels]
+static void Run_Progressive_On_Directory_Tree(const std::string& spec, const std::filesystem::path& root_path, const int& levels) {
+    ProgressiveCodec progressive_codec(spec, levels);
+    progressive_codec.Set_Number_Of_Iterations(1);
+    progressive_codec.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+
+    Run_On_Directory_Tree(progressive_codec, root_path, std::string{"progressive_stats"}, Run_Progressive_Compression_Decompression_On_Files);
+}
+
+// geobin_compression seam "<interior spec>" [planet data dir]
+static void Run_Seam_On_Directory_Tree(const std::string& spec, const std::filesystem::path& root_path) {
+    SeamCodec seam_codec(spec);
+    seam_codec.Set_Number_Of_Iterations(1);
+    seam_codec.Set_Warmup_Iterations(DEFAULT_WARMUP_ITERATIONS);
+
+    // the sides that belong together are found through the catalog
+    Run_On_Directory_Tree(seam_codec, root_path, std::string{"seam_stats"}, Run_Seam_Compression_Decompression_On_Files);
+}
+
+// geobin_compression list-codecs
+static void Print_Registered_Codec_Stages() {
+    const CodecRegistry& registry = CodecRegistry::Get_Instance();
+    std::cout << "transforms:";
+    for(const auto& name : registry.Get_Stage_Names(Stage_Kind::transform)) {
+        std::cout << ' ' << name;
+    }
+    std::cout << "\nbackends:";
+    for(const auto& name : registry.Get_Stage_Names(Stage_Kind::backend)) {
+        std::cout << ' ' << name;
+    }
+    std::cout << '\n';
+}
+
 //create a common stats class that has all the stats and then pass it to the processFiles function
-int main() {
+int main(int argc, char** argv) {
+    const std::string command = (argc >= 2) ? std::string{argv[1]} : std::string{};
+    if(const char* pin_cpu = std::getenv("GEOBIN_PIN_CPU")) {
+        if(!Pin_Current_Thread_To_Cpu(std::stoi(pin_cpu))) {
+            ERROR_MSG(std::string{"WARNING: unable to pin to cpu "} + std::string{pin_cpu} + std::string{", running unpinned"});
+        }
+    }
+    if(command == "list-codecs") {
+        Print_Registered_Codec_Stages();
+        return 0;
+    }
+    if(command == "auto") {
+        SelectionObjective objective;
+        objective.minimum_decode_megabytes_per_second = (argc >= 3) ? std::stod(argv[2]) : 0.0;
+        Run_Auto_Pipeline_On_Directory_Tree(objective, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"},
+                                            (argc >= 5) ? std::stoull(argv[4]) : 0);
+        return 0;
+    }
+    if(command == "stream") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression stream \"delta|rlr1\" [planet data dir] [memory budget MB]"});
+        }
+        Run_Stream_On_Directory_Tree(std::string{argv[2]}, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"},
+                                     (argc >= 5) ? (std::stoull(argv[4]) << 20) : DEFAULT_STREAM_MEMORY_BUDGET_BYTES);
+        return 0;
+    }
+    if(command == "async") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression async \"delta|rlr1\" [planet data dir] [worker threads]"});
+        }
+        const int number_of_workers = (argc >= 5) ? std::stoi(argv[4]) : static_cast<int>(std::max(2u, std::thread::hardware_concurrency()) - 1);
+        Run_Async_Pipeline_On_Directory_Tree(std::string{argv[2]}, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"}, number_of_workers);
+        return 0;
+    }
+    if(command == "pyramid") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression pyramid \"shuffle|rans\" [planet data dir]"});
+        }
+        Run_Pyramid_On_Directory_Tree(std::string{argv[2]}, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"});
+        return 0;
+    }
+    if(command == "progressive") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression progressive \"huffman\" [planet data dir] [levels]"});
+        }
+        Run_Progressive_On_Directory_Tree(std::string{argv[2]}, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"},
+                                          (argc >= 5) ? std::stoi(argv[4]) : DEFAULT_PROGRESSIVE_LEVELS);
+        return 0;
+    }
+    if(command == "seam") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression seam \"delta|shuffle|rans\" [planet data dir]"});
+        }
+        Run_Seam_On_Directory_Tree(std::string{argv[2]}, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"});
+        return 0;
+    }
+    if(command == "archive") {
+        Run_Context_Model_On_Directory_Tree(std::filesystem::path{(argc >= 3) ? argv[2] : "PlanetData"}, (argc >= 4) ? (std::stoi(argv[3]) != 0) : true,
+                                            (argc >= 5) ? std::stoi(argv[4]) : 0, (argc >= 6) ? std::stoull(argv[5]) : DEFAULT_CONTEXT_MODEL_TILE_ROWS);
+        return 0;
+    }
+    // geobin_compression pareto [planet data dir] [output prefix] [measured iterations] [warm-up iterations]
+    if(command == "pareto") {
+        Load_And_Activate_Geobin_Catalog(std::filesystem::path{(argc >= 3) ? argv[2] : "PlanetData"});
+        ParetoReport pareto_report(ParetoReport::Get_Registered_Candidate_Specs(), (argc >= 5) ? std::stoi(argv[4]) : DEFAULT_PARETO_MEASURED_ITERATIONS,
+                                   (argc >= 6) ? std::stoi(argv[5]) : DEFAULT_PARETO_WARMUP_ITERATIONS);
+        pareto_report.Run_On_Directory_Tree(std::filesystem::path{(argc >= 3) ? argv[2] : "PlanetData"});
+        const std::string output_prefix = (argc >= 4) ? std::string{argv[3]} : std::string{"pareto_report"};
+        pareto_report.Write_Csv(std::filesystem::path{output_prefix + ".csv"});
+        pareto_report.Write_Html(std::filesystem::path{output_prefix + ".html"});
+        std::cout << output_prefix << ".csv\n" << output_prefix << ".html\n";
+        return 0;
+    }
+    // geobin_compression compare <baseline run> <candidate run> [results db] [threshold percent], exits 1 on a regression
+    if(command == "compare") {
+        if(argc < 4) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression compare <baseline run|label|revision|previous> <candidate run|label|revision|latest> [results db] [threshold percent]"});
+        }
+        const ResultsDatabase results_database((argc >= 5) ? std::filesystem::path{argv[4]} : ResultsDatabase::Get_Default_Database_Path());
+        const std::vector<MetricComparison> comparison_vec = results_database.Compare_Runs(std::string{argv[2]}, std::string{argv[3]},
+                                                                                           (argc >= 6) ? std::stod(argv[5]) : DEFAULT_REGRESSION_THRESHOLD_PERCENT);
+        return (Print_Metric_Comparisons(comparison_vec) > 0) ? 1 : 0;
+    }
+    // geobin_compression catalog [planet data dir], rebuilds the saved catalog after files were added or removed
+    if(command == "catalog") {
+        const std::filesystem::path root_path{(argc >= 3) ? argv[2] : "PlanetData"};
+        const GeobinCatalog& catalog = Load_And_Activate_Geobin_Catalog(root_path, true);
+        uint64_t total_bytes = 0;
+        for(const auto& entry : catalog.Get_Entries()) {
+            total_bytes += entry.file_size;
+        }
+        std::cout << GeobinCatalog::Get_Default_Catalog_Path(root_path).string() << ": " << catalog.Get_Directories().size() << " directories, "
+                  << catalog.Get_Entries().size() << " geobin files, " << total_bytes << " bytes\n";
+        return 0;
+    }
+    // geobin_compression frequencies-to-json <table file> [json file]
+    if(command == "frequencies-to-json") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression frequencies-to-json <table file> [json file]"});
+        }
+        const std::filesystem::path table_path{argv[2]};
+        const std::filesystem::path json_path = (argc >= 4) ? std::filesystem::path{argv[3]} : std::filesystem::path{table_path}.replace_extension(".json");
+        if(!Export_Frequency_Tables_To_Json(table_path, json_path)) {
+            ERROR_MSG_AND_EXIT(std::string{"ERROR: "} + table_path.string() + std::string{" is not a readable frequency table file"});
+        }
+        std::cout << json_path.string() << '\n';
+        return 0;
+    }
+    // geobin_compression generate-corpus [output dir] [number of lods] [subsets per side] [seed]
+    if(command == "generate-corpus") {
+        CorpusSpec corpus_spec;
+        corpus_spec.number_of_lods = (argc >= 4) ? std::stoi(argv[3]) : DEFAULT_CORPUS_NUMBER_OF_LODS;
+        corpus_spec.subsets_per_side = (argc >= 5) ? std::stoi(argv[4]) : DEFAULT_CORPUS_SUBSETS_PER_SIDE;
+        corpus_spec.seed = (argc >= 6) ? std::stoull(argv[5], nullptr, 0) : DEFAULT_CORPUS_SEED;
+        const CorpusGenerator corpus_generator(corpus_spec);
+        for(const auto& layer_path : corpus_generator.Generate_Corpus(std::filesystem::path{(argc >= 3) ? argv[2] : "SyntheticPlanetData"})) {
+            std::cout << layer_path.string() << '\n';
+        }
+        return 0;
+    }
+    if(command == "pipeline") {
+        if(argc < 3) {
+            ERROR_MSG_AND_EXIT(std::string{"usage: geobin_compression pipeline \"delta|shuffle|rlr1|rans\" [planet data dir] [rows per timing sample] [measured iterations] [warm-up iterations]"});
+        }
+        Run_Pipeline_On_Directory_Tree(std::string{argv[2]}, std::filesystem::path{(argc >= 4) ? argv[3] : "PlanetData"},
+                                       (argc >= 5) ? static_cast<uint32_t>(std::stoul(argv[4])) : 1,
+                                       (argc >= 6) ? std::stoi(argv[5]) : DEFAULT_MEASURED_ITERATIONS,
+                                       (argc >= 7) ? std::stoi(argv[6]) : DEFAULT_WARMUP_ITERATIONS);
+        return 0;
+    }
+
     // RLR rlr;
     // rlr.Set_Number_Of_Iterations(1);
 
@@ -63,6 +321,7 @@ int main() {
 
     ShannonFano shannon_fano;
     shannon_fano.Set_Number_Of_Iterations(1);
+    Load_And_Activate_Geobin_Catalog(std::filesystem::path("PlanetData"));
     const std::vector<std::filesystem::path> geometa_and_geobin_dir_path_vec = Get_Geobin_And_Geometa_Directory_Path_Vec(std::filesystem::path("PlanetData"));
     for(int i = 0; i < geometa_and_geobin_dir_path_vec.size(); i++){
         std::vector<std::filesystem::path> geobin_files_vec = Get_Geobin_File_Vec(geometa_and_geobin_dir_path_vec[i]);